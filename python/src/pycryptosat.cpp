@@ -409,6 +409,182 @@ static PyObject* add_xor_clause(Solver *self, PyObject *args, PyObject *kwds)
     return Py_None;
 }
 
+template <typename T>
+static int _add_xor_clauses_from_array(Solver *self, const size_t array_length, const T *array)
+{
+    if (array_length == 0) {
+        return 1;
+    }
+    if (array[array_length - 1] != 0) {
+        PyErr_SetString(PyExc_ValueError, "last XOR clause not terminated by zero");
+        return 0;
+    }
+    std::vector<uint32_t> vars;
+    size_t k = 0;
+    while (k < array_length) {
+        vars.clear();
+        bool rhs = true;
+        long max_var = -1;
+        for (; array[k] != 0; k++) {
+            const long val = (long) array[k];
+            if (val > std::numeric_limits<int>::max()/2
+                || val < std::numeric_limits<int>::min()/2
+            ) {
+                PyErr_Format(PyExc_ValueError, "integer %ld is too small or too large", val);
+                return 0;
+            }
+            const long var = std::abs(val) - 1;
+            max_var = std::max(var, max_var);
+            rhs ^= (val < 0);
+            vars.push_back(var);
+        }
+        k++;
+        if (max_var >= (long)self->cmsat->nVars()) {
+            self->cmsat->new_vars(max_var-(long)self->cmsat->nVars()+1);
+        }
+        self->cmsat->add_xor_clause(vars, rhs);
+    }
+    return 1;
+}
+
+PyDoc_STRVAR(add_xor_clauses_doc,
+"add_xor_clauses(xor_clauses)\n\
+Add many XOR clauses to the solver at once.\n\
+\n\
+:param xor_clauses: Flat array.array, NumPy array or other contiguous\n\
+    buffer (format 'i', 'l', or 'q') of zero separated and terminated XOR\n\
+    clauses. Each XOR of its literals must be true, a negated literal flips\n\
+    the right hand side, as in 'x' lines of DIMACS.\n\
+:return: None\n\
+:rtype: <None>"
+);
+
+static PyObject* add_xor_clauses(Solver *self, PyObject *args, PyObject *kwds)
+{
+    static char const* kwlist[] = {"xor_clauses", NULL};
+    PyObject *clauses;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O", const_cast<char**>(kwlist), &clauses)) {
+        return NULL;
+    }
+    if (!PyObject_CheckBuffer(clauses)) {
+        PyErr_SetString(PyExc_TypeError, "buffer of integers expected");
+        return NULL;
+    }
+
+    Py_buffer view;
+    memset(&view, 0, sizeof(view));
+    if (PyObject_GetBuffer(clauses, &view, PyBUF_CONTIG_RO | PyBUF_FORMAT) != 0) {
+        return NULL;
+    }
+    int ret = 0;
+    if (view.ndim != 1) {
+        PyErr_Format(PyExc_ValueError, "invalid XOR clause array: expected 1-D array, got %d-D", view.ndim);
+    } else if (view.itemsize == sizeof(int) && strchr("i", view.format[0])) {
+        ret = _add_xor_clauses_from_array(self, view.len/view.itemsize, (const int*)view.buf);
+    } else if (view.itemsize == sizeof(long) && strchr("l", view.format[0])) {
+        ret = _add_xor_clauses_from_array(self, view.len/view.itemsize, (const long*)view.buf);
+    } else if (view.itemsize == sizeof(long long) && strchr("q", view.format[0])) {
+        ret = _add_xor_clauses_from_array(self, view.len/view.itemsize, (const long long*)view.buf);
+    } else {
+        PyErr_Format(PyExc_ValueError, "invalid XOR clause array: invalid format '%s'", view.format);
+    }
+    PyBuffer_Release(&view);
+
+    if (ret == 0 || PyErr_Occurred()) {
+        return NULL;
+    }
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+// New 1-D memoryview of n items of the given struct format, over a bytearray.
+// `data` points to its storage to be filled. Supports the buffer protocol,
+// so numpy.asarray() of it does not copy
+static PyObject* new_array(const char* format, const size_t itemsize, const size_t n, char** data)
+{
+    PyObject* bytes = PyByteArray_FromStringAndSize(NULL, (Py_ssize_t)(n*itemsize));
+    if (bytes == NULL) {
+        return NULL;
+    }
+    *data = PyByteArray_AS_STRING(bytes);
+    PyObject* view = PyMemoryView_FromObject(bytes);
+    Py_DECREF(bytes);
+    if (view == NULL) {
+        return NULL;
+    }
+    PyObject* typed = PyObject_CallMethod(view, "cast", "s", format);
+    Py_DECREF(view);
+    return typed;
+}
+
+static PyObject* lits_to_array(const std::vector<Lit>& lits)
+{
+    char* data;
+    PyObject* arr = new_array("i", sizeof(int32_t), lits.size(), &data);
+    if (arr == NULL) {
+        return NULL;
+    }
+    int32_t* out = (int32_t*)data;
+    for (size_t i = 0; i < lits.size(); i++) {
+        const int32_t v = lits[i].var() + 1;
+        out[i] = lits[i].sign() ? -v : v;
+    }
+    return arr;
+}
+
+PyDoc_STRVAR(get_model_array_doc,
+"get_model_array()\n\
+Return the model of the last satisfiable solve(...) as an array of int8\n\
+(a memoryview, usable with numpy.asarray() without copying). Element i is\n\
+the value of variable i+1: 1 for True, 0 for False, -1 if unassigned.\n\
+\n\
+:return: The model\n\
+:rtype: <memoryview>"
+);
+
+static PyObject* get_model_array(Solver *self)
+{
+    const std::vector<lbool>& model = self->cmsat->get_model();
+    char* data;
+    PyObject* arr = new_array("b", 1, model.size(), &data);
+    if (arr == NULL) {
+        return NULL;
+    }
+    int8_t* out = (int8_t*)data;
+    for (size_t i = 0; i < model.size(); i++) {
+        out[i] = model[i] == l_True ? 1 : (model[i] == l_False ? 0 : -1);
+    }
+    return arr;
+}
+
+PyDoc_STRVAR(get_conflict_array_doc,
+"get_conflict_array()\n\
+Same as get_conflict(), but as an array of int32 (a memoryview, usable with\n\
+numpy.asarray() without copying).\n\
+\n\
+:return: Which assumptions (as passed to solve(...)) are incorrect\n\
+:rtype: <memoryview>"
+);
+
+static PyObject* get_conflict_array(Solver *self)
+{
+    return lits_to_array(self->cmsat->get_conflict());
+}
+
+PyDoc_STRVAR(get_zero_assigned_lits_doc,
+"get_zero_assigned_lits()\n\
+Return the literals that are fixed in every model, as an array of int32 (a\n\
+memoryview, usable with numpy.asarray() without copying).\n\
+\n\
+:return: The fixed literals\n\
+:rtype: <memoryview>"
+);
+
+static PyObject* get_zero_assigned_lits(Solver *self)
+{
+    return lits_to_array(self->cmsat->get_zero_assigned_lits());
+}
+
 static PyObject* get_solution(SATSolver *cmsat)
 {
     // Create tuple with the size of number of variables in model
@@ -423,9 +599,10 @@ static PyObject* get_solution(SATSolver *cmsat)
     PyTuple_SET_ITEM(tuple, (Py_ssize_t)0, Py_None);
 
     PyObject *py_value = NULL;
+    const std::vector<lbool>& model = cmsat->get_model();
     lbool v;
     for (unsigned i = 0; i < max_idx; i++) {
-        v = cmsat->get_model()[i];
+        v = model[i];
 
         if (v == l_True) {
             py_value = Py_True;
@@ -710,6 +887,133 @@ static PyObject* get_conflict(Solver *self)
     return result;
 }
 
+PyDoc_STRVAR(start_getting_constraints_doc,
+"start_getting_constraints(red=False, simplified=False)\n\
+Start exporting the constraints of the solver with get_next_constraints().\n\
+\n\
+:param red: Export the redundant (learnt) clauses instead of the irredundant ones\n\
+:param simplified: Export the simplified formula, in its own numbering\n\
+:return: None\n\
+:rtype: <None>"
+);
+
+static PyObject* start_getting_constraints(Solver *self, PyObject *args, PyObject *kwds)
+{
+    static char const* kwlist[] = {"red", "simplified", NULL};
+    int red = 0;
+    int simplified = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|pp", const_cast<char**>(kwlist), &red, &simplified)) {
+        return NULL;
+    }
+    self->cmsat->start_getting_constraints(red, simplified);
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static int get_writable_buffer(PyObject* obj, Py_buffer* view, const char* name, const char* formats, size_t itemsize)
+{
+    if (PyObject_GetBuffer(obj, view, PyBUF_CONTIG | PyBUF_FORMAT) != 0) {
+        return 0;
+    }
+    const char* format = view->format[0] == '=' || view->format[0] == '@' ? view->format+1 : view->format;
+    if (view->ndim != 1 || strlen(format) != 1 || strchr(formats, format[0]) == NULL
+        || (size_t)view->itemsize != itemsize
+    ) {
+        PyErr_Format(PyExc_ValueError,
+            "invalid %s buffer: expected 1-D buffer of %zu-byte items (format '%s'), got format '%s'",
+            name, itemsize, formats, view->format);
+        PyBuffer_Release(view);
+        return 0;
+    }
+    return 1;
+}
+
+PyDoc_STRVAR(get_next_constraints_doc,
+"get_next_constraints(lits, offsets, flags=None)\n\
+Copy the next constraints into caller-provided buffers, without allocating\n\
+per constraint. Constraint i is lits[offsets[i]:offsets[i+1]].\n\
+\n\
+:param lits: Writable buffer of int32 (format 'i') for the literals\n\
+:param offsets: Writable buffer of 64-bit ints (format 'q' or 'Q'). At most\n\
+    len(offsets)-1 constraints are copied\n\
+:param flags: Writable buffer of bytes (format 'B'). flags[i] is 0 for a clause,\n\
+    for an XOR bit 0 is set and bit 1 is the RHS. Needed only if there are XORs\n\
+:return: Number of constraints copied, 0 if there are no more\n\
+:rtype: <int>"
+);
+
+static PyObject* get_next_constraints(Solver *self, PyObject *args, PyObject *kwds)
+{
+    static char const* kwlist[] = {"lits", "offsets", "flags", NULL};
+    PyObject *lits_obj;
+    PyObject *offsets_obj;
+    PyObject *flags_obj = Py_None;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO|O", const_cast<char**>(kwlist),
+        &lits_obj, &offsets_obj, &flags_obj)) {
+        return NULL;
+    }
+    static_assert(sizeof(Lit) == sizeof(int32_t), "literals are converted in place");
+
+    Py_buffer lits_view, offsets_view, flags_view;
+    if (!get_writable_buffer(lits_obj, &lits_view, "lits", "il", sizeof(int32_t))) {
+        return NULL;
+    }
+    if (!get_writable_buffer(offsets_obj, &offsets_view, "offsets", "qlQLn", sizeof(size_t))) {
+        PyBuffer_Release(&lits_view);
+        return NULL;
+    }
+    const bool has_flags = flags_obj != Py_None;
+    if (has_flags && !get_writable_buffer(flags_obj, &flags_view, "flags", "Bb", 1)) {
+        PyBuffer_Release(&lits_view);
+        PyBuffer_Release(&offsets_view);
+        return NULL;
+    }
+
+    const size_t lits_cap = lits_view.len / sizeof(int32_t);
+    const size_t offsets_len = offsets_view.len / sizeof(size_t);
+    size_t max_constraints = offsets_len == 0 ? 0 : offsets_len-1;
+    if (has_flags) max_constraints = std::min<size_t>(max_constraints, flags_view.len);
+
+    size_t num = 0;
+    bool ok = true;
+    if (max_constraints > 0) {
+        Lit* lits = (Lit*)lits_view.buf;
+        size_t* offsets = (size_t*)offsets_view.buf;
+        try {
+            num = self->cmsat->get_next_constraints(lits, lits_cap, offsets, max_constraints,
+                has_flags ? (uint8_t*)flags_view.buf : nullptr);
+        } catch (std::exception& e) {
+            PyErr_SetString(PyExc_ValueError, e.what());
+            ok = false;
+        }
+
+        //To DIMACS, in place
+        int32_t* out = (int32_t*)lits_view.buf;
+        for (size_t i = 0; ok && i < offsets[num]; i++) {
+            const Lit l = lits[i];
+            out[i] = l.sign() ? -(int32_t)(l.var()+1) : (int32_t)(l.var()+1);
+        }
+    } else {
+        PyErr_SetString(PyExc_ValueError, "offsets buffer must have room for at least 2 entries");
+        ok = false;
+    }
+
+    PyBuffer_Release(&lits_view);
+    PyBuffer_Release(&offsets_view);
+    if (has_flags) PyBuffer_Release(&flags_view);
+    if (!ok) return NULL;
+    return PyLong_FromSize_t(num);
+}
+
+static PyObject* end_getting_constraints(Solver *self)
+{
+    self->cmsat->end_getting_constraints();
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
 /*************************** Method definitions *************************/
 
 static PyMethodDef Solver_methods[] = {
@@ -717,10 +1021,17 @@ static PyMethodDef Solver_methods[] = {
     {"add_clause",(PyCFunction) add_clause,  METH_VARARGS | METH_KEYWORDS, add_clause_doc},
     {"add_clauses", (PyCFunction) add_clauses,  METH_VARARGS | METH_KEYWORDS, add_clauses_doc},
     {"add_xor_clause",(PyCFunction) add_xor_clause,  METH_VARARGS | METH_KEYWORDS, "adds an XOR clause to the system"},
+    {"add_xor_clauses", (PyCFunction) add_xor_clauses,  METH_VARARGS | METH_KEYWORDS, add_xor_clauses_doc},
     {"nb_vars", (PyCFunction) nb_vars, METH_VARARGS | METH_KEYWORDS, nb_vars_doc},
     //{"nb_clauses", (PyCFunction) nb_clauses, METH_VARARGS | METH_KEYWORDS, "returns number of clauses"},
     {"is_satisfiable", (PyCFunction) is_satisfiable, METH_VARARGS | METH_KEYWORDS, is_satisfiable_doc},
     {"get_conflict", (PyCFunction) get_conflict, METH_VARARGS | METH_KEYWORDS, get_conflict_doc},
+    {"get_conflict_array", (PyCFunction) get_conflict_array, METH_NOARGS, get_conflict_array_doc},
+    {"get_model_array", (PyCFunction) get_model_array, METH_NOARGS, get_model_array_doc},
+    {"get_zero_assigned_lits", (PyCFunction) get_zero_assigned_lits, METH_NOARGS, get_zero_assigned_lits_doc},
+    {"start_getting_constraints", (PyCFunction) start_getting_constraints, METH_VARARGS | METH_KEYWORDS, start_getting_constraints_doc},
+    {"get_next_constraints", (PyCFunction) get_next_constraints, METH_VARARGS | METH_KEYWORDS, get_next_constraints_doc},
+    {"end_getting_constraints", (PyCFunction) end_getting_constraints, METH_NOARGS, "finish exporting the constraints"},
     {NULL,        NULL}  /* sentinel - marks the end of this structure */
 };
 
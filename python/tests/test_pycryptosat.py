@@ -137,6 +137,19 @@ class TestXor(unittest.TestCase):
             self.assertEqual(res, True)
             self.assertEqual(solution, tuple(solution_expected))
 
+    def test_add_xor_clauses_array(self):
+        # 1^2 = True, 2^3 = False (negated literal flips the RHS)
+        self.solver.add_xor_clauses(_array('i', [1, 2, 0, -2, 3, 0]))
+        res, solution = self.solver.solve([1])
+        self.assertEqual(res, True)
+        self.assertEqual(solution, (None, True, False, False))
+
+    def test_add_xor_clauses_unterminated(self):
+        self.assertRaises(ValueError, self.solver.add_xor_clauses,
+                          _array('i', [1, 2]))
+        self.assertRaises(ValueError, self.solver.add_xor_clauses,
+                          _array('d', [1, 2, 0]))
+
 
 class InitTester(unittest.TestCase):
 
@@ -180,6 +193,39 @@ class TestDump(unittest.TestCase):
         self.solver.end_getting_small_clauses()
 
 
+class TestExport(unittest.TestCase):
+
+    def setUp(self):
+        self.solver = Solver()
+
+    def test_export_chunks(self):
+        self.solver.add_clauses([[1, 2, 3], [-1, -4], [2, -3, 4]])
+        lits = _array('i', [0]*8)
+        offsets = _array('q', [0]*3)
+        flags = _array('B', [0]*2)
+        got = []
+        self.solver.start_getting_constraints()
+        while True:
+            n = self.solver.get_next_constraints(lits, offsets, flags)
+            if n == 0:
+                break
+            self.assertTrue(n <= 2)
+            for i in range(n):
+                self.assertEqual(flags[i], 0)
+                got.append(sorted(lits[offsets[i]:offsets[i+1]]))
+        self.solver.end_getting_constraints()
+        self.assertEqual(sorted(got), [[-4, -1], [-3, 2, 4], [1, 2, 3]])
+
+    def test_export_bad_buffer(self):
+        self.solver.add_clause([1, 2])
+        self.solver.start_getting_constraints()
+        self.assertRaises(ValueError, self.solver.get_next_constraints,
+                          _array('d', [0]*4), _array('q', [0]*2))
+        self.assertRaises(ValueError, self.solver.get_next_constraints,
+                          _array('i', [0]), _array('q', [0]*2))
+        self.solver.end_getting_constraints()
+
+
 class TestSolve(unittest.TestCase):
 
     def setUp(self):
@@ -264,6 +310,24 @@ class TestSolve(unittest.TestCase):
         self.assertNotIn(2, confl)
         self.assertIn(-4, confl)
 
+    def test_get_model_array(self):
+        self.solver.add_clauses([[1], [-2], [2, 3]])
+        res, solution = self.solver.solve()
+        self.assertEqual(res, True)
+        model = self.solver.get_model_array()
+        self.assertEqual(model.format, 'b')
+        self.assertEqual(list(model), [1, 0, 1])
+        self.assertEqual(sorted(self.solver.get_zero_assigned_lits()),
+                         [-2, 1, 3])
+
+    def test_get_conflict_array(self):
+        self.solver.add_clauses([[-1], [2], [3], [-4]])
+        res, _ = self.solver.solve(assumptions=[2, 4])
+        self.assertEqual(res, False)
+        confl = self.solver.get_conflict_array()
+        self.assertEqual(confl.format, 'i')
+        self.assertEqual(list(confl), self.solver.get_conflict())
+
     def test_cnf2(self):
         for cl in clauses2:
             self.solver.add_clause(cl)
@@ -0,0 +1,443 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+# Copyright (c) 2024, Mate Soos
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+
+"""End-to-end performance regression check.
+
+Generates a fixed corpus (random k-SAT, LPN XOR systems, factoring and a
+bounded model checking unrolling), runs the solver over it with fixed seeds
+and --maxconfl budgets, and records conflicts/s, propagations/s, wall time,
+peak RSS and the time of every inprocessing pass. The results are compared
+to a stored baseline; the exit code is 1 if anything got worse by more than
+the tolerance, if a SAT/UNSAT answer changed, or if the solver failed.
+
+Typical use, from the build directory:
+
+  # on the old build
+  ../scripts/speed-check/perf_regress.py --solver ./cryptominisat5 \\
+      --save-baseline perf_baseline.json
+  # on the new build
+  ../scripts/speed-check/perf_regress.py --solver ./cryptominisat5 \\
+      --baseline perf_baseline.json
+
+Timings depend on the machine, so baselines are only comparable when taken
+on the same one. "make perf_check" does the second step, and the first one
+too when the baseline file does not exist yet.
+"""
+
+import argparse
+import json
+import os
+import random
+import re
+import subprocess
+import sys
+import time
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+
+
+##################
+# Corpus generators. All of them are deterministic given their arguments.
+##################
+
+class CNF:
+    def __init__(self):
+        self.nvars = 0
+        self.cls = []
+        self.xors = []
+
+    def new_var(self):
+        self.nvars += 1
+        return self.nvars
+
+    def add(self, cl):
+        self.cls.append(cl)
+
+    def AND(self, a, b):
+        out = self.new_var()
+        self.add([-out, a])
+        self.add([-out, b])
+        self.add([out, -a, -b])
+        return out
+
+    def XOR(self, a, b):
+        out = self.new_var()
+        self.add([-out, a, b])
+        self.add([-out, -a, -b])
+        self.add([out, -a, b])
+        self.add([out, a, -b])
+        return out
+
+    def full_adder(self, a, b, c):
+        s = self.XOR(self.XOR(a, b), c)
+        carry = self.new_var()
+        self.add([-carry, a, b])
+        self.add([-carry, a, c])
+        self.add([-carry, b, c])
+        self.add([carry, -a, -b])
+        self.add([carry, -a, -c])
+        self.add([carry, -b, -c])
+        return s, carry
+
+    def at_most(self, lits, k):
+        """Sequential counter encoding of sum(lits) <= k"""
+        if k >= len(lits):
+            return
+        if k == 0:
+            for l in lits:
+                self.add([-l])
+            return
+        # s[j] is true if at least j+1 of the lits so far are true
+        s = [self.new_var() for _ in range(k)]
+        self.add([-lits[0], s[0]])
+        for j in range(1, k):
+            self.add([-s[j]])
+        for i in range(1, len(lits)):
+            ns = [self.new_var() for _ in range(k)]
+            self.add([-lits[i], ns[0]])
+            self.add([-s[0], ns[0]])
+            for j in range(1, k):
+                self.add([-lits[i], -s[j-1], ns[j]])
+                self.add([-s[j], ns[j]])
+            self.add([-lits[i], -s[k-1]])
+            s = ns
+
+    def false_var(self):
+        f = self.new_var()
+        self.add([-f])
+        return f
+
+    def write(self, fname):
+        with open(fname, "w") as f:
+            f.write("p cnf %d %d\n" % (self.nvars, len(self.cls) + len(self.xors)))
+            for cl in self.cls:
+                f.write(" ".join(str(l) for l in cl) + " 0\n")
+            for x in self.xors:
+                f.write("x " + " ".join(str(l) for l in x) + " 0\n")
+
+
+def gen_random_ksat(fname, n, k, ratio, seed):
+    rnd = random.Random(seed)
+    cnf = CNF()
+    cnf.nvars = n
+    for _ in range(int(n*ratio)):
+        vs = rnd.sample(range(1, n+1), k)
+        cnf.add([v if rnd.random() < 0.5 else -v for v in vs])
+    cnf.write(fname)
+
+
+def gen_lpn(fname, n, samples, noise, seed):
+    """XORs from lpn-gen.py. Its noise bound is a BNN, which needs a
+    BNN-enabled build, so it is turned into a cardinality constraint"""
+    out = subprocess.check_output(
+        [sys.executable, os.path.join(SCRIPT_DIR, "..", "lpn-gen.py"),
+         "-s", str(seed), "-n", str(n), "-m", str(samples),
+         "--noise", str(noise)], universal_newlines=True)
+    cnf = CNF()
+    for line in out.splitlines():
+        if line.startswith("x "):
+            x = [int(l) for l in line[2:].split()[:-1]]
+            cnf.xors.append(x)
+            cnf.nvars = max(cnf.nvars, max(abs(l) for l in x))
+        elif line.startswith("b "):
+            # "b -l1 ... -lm 0 cutoff": at least cutoff of the -li are true
+            parts = line[2:].split()
+            lits = [-int(l) for l in parts[:-2]]
+            cnf.at_most(lits, len(lits) - int(parts[-1]))
+    cnf.write(fname)
+
+
+def is_prime(x):
+    if x < 2:
+        return False
+    i = 2
+    while i*i <= x:
+        if x % i == 0:
+            return False
+        i += 1
+    return True
+
+
+def gen_factoring(fname, bits, seed):
+    """a*b == p*q for two random 'bits'-bit primes, with a, b > 1"""
+    rnd = random.Random(seed)
+    primes = []
+    while len(primes) < 2:
+        x = rnd.randrange(1 << (bits-1), 1 << bits)
+        if is_prime(x):
+            primes.append(x)
+    N = primes[0]*primes[1]
+
+    cnf = CNF()
+    a = [cnf.new_var() for _ in range(bits)]
+    b = [cnf.new_var() for _ in range(bits)]
+    f = cnf.false_var()
+    acc = [f]*(2*bits)
+    for j in range(bits):
+        row = [f]*j + [cnf.AND(a[i], b[j]) for i in range(bits)]
+        row += [f]*(2*bits - len(row))
+        carry = f
+        for i in range(j, 2*bits):
+            acc[i], carry = cnf.full_adder(acc[i], row[i], carry)
+        cnf.add([-carry])
+    for i in range(2*bits):
+        cnf.add([acc[i] if (N >> i) & 1 else -acc[i]])
+    cnf.add(a[1:])
+    cnf.add(b[1:])
+    cnf.write(fname)
+
+
+def gen_bmc_counter(fname, bits, steps):
+    """Counter from 0 that may or may not increment at every step. Can it
+    reach all-ones within 'steps' steps? UNSAT if steps < 2^bits-1"""
+    cnf = CNF()
+    state = [cnf.false_var()]*bits
+    for _ in range(steps):
+        carry = cnf.new_var()  # input: increment or not
+        nxt = []
+        for i in range(bits):
+            nxt.append(cnf.XOR(state[i], carry))
+            carry = cnf.AND(state[i], carry)
+        state = nxt
+    for v in state:
+        cnf.add([v])
+    cnf.write(fname)
+
+
+# name -> (generator, arguments, maxconfl)
+CORPUS = [
+    ("rnd3-400", gen_random_ksat, dict(n=400, k=3, ratio=4.26, seed=1), 30000),
+    ("rnd3-5000", gen_random_ksat, dict(n=5000, k=3, ratio=4.20, seed=2), 30000),
+    ("rnd5-150", gen_random_ksat, dict(n=150, k=5, ratio=21.1, seed=3), 30000),
+    ("lpn-50", gen_lpn, dict(n=50, samples=250, noise=0.1, seed=4), 30000),
+    ("lpn-80", gen_lpn, dict(n=80, samples=300, noise=0.05, seed=5), 30000),
+    ("factor-22", gen_factoring, dict(bits=22, seed=6), 30000),
+    ("bmc-counter-6", gen_bmc_counter, dict(bits=6, steps=62), 30000),
+]
+
+
+def generate_corpus(corpus_dir, only):
+    if not os.path.isdir(corpus_dir):
+        os.makedirs(corpus_dir)
+    files = []
+    for name, gen, args, maxconfl in CORPUS:
+        if only and not re.search(only, name):
+            continue
+        fname = os.path.join(corpus_dir, name + ".cnf")
+        if not os.path.exists(fname):
+            gen(fname, **args)
+        files.append((name, fname, maxconfl))
+    return files
+
+
+##################
+# Running and parsing
+##################
+
+def parse_num(s):
+    mult = {"K": 1e3, "M": 1e6, "G": 1e9}
+    if s[-1] in mult:
+        return float(s[:-1])*mult[s[-1]]
+    return float(s)
+
+
+pass_re = re.compile(r"^c (.+?) time\s*:\s*([0-9.]+)\s+\(\s*[0-9.]+\s+% time\)")
+props_re = re.compile(r"^c propagations\s*:\s*\S+\s+\(([0-9.]+[KMG]?)\s+props/s\)")
+confl_re = re.compile(r"^c Conflicts in UIP\s*:\s*(\d+)\s+\(([0-9.]+)\s+confl/time_this_thread\)")
+time_re = re.compile(r"^c Total time \(this thread\)\s*:\s*([0-9.]+)")
+# VmHWM of the solver process, or getrusage() where /proc is missing
+rss_re = re.compile(r"^c (?:Max Memory \(rss\) used|Mem used)\s*:\s*([0-9.]+)\s*(kB|MB)")
+
+
+def run_one(solver, fname, maxconfl, seed, extra):
+    cmd = [solver, "--verb", "1", "--random", str(seed),
+           "--maxconfl", str(maxconfl)] + extra + [fname]
+    start = time.time()
+    p = subprocess.run(cmd, stdout=subprocess.PIPE, universal_newlines=True)
+    wall = time.time() - start
+
+    res = {"result": "INDETERMINATE", "wall_time": wall, "passes": {}}
+    for line in p.stdout.splitlines():
+        if line.startswith("s "):
+            res["result"] = line[2:].strip()
+        m = pass_re.match(line)
+        if m and m.group(1) != "UIP search":
+            res["passes"][m.group(1)] = float(m.group(2))
+        m = props_re.match(line)
+        if m:
+            res["props_per_sec"] = parse_num(m.group(1))
+        m = confl_re.match(line)
+        if m:
+            res["conflicts"] = int(m.group(1))
+            res["confl_per_sec"] = float(m.group(2))
+        m = time_re.match(line)
+        if m:
+            res["cpu_time"] = float(m.group(1))
+        m = rss_re.match(line)
+        if m:
+            res["peak_rss_mb"] = float(m.group(1))/(1024.0 if m.group(2) == "kB" else 1.0)
+    if p.returncode not in (0, 10, 15, 20):
+        print("ERROR: solver exited with status %d on %s" % (p.returncode, fname))
+        res["result"] = "ERROR"
+    return res
+
+
+# metric -> True if higher is better
+METRICS = {
+    "confl_per_sec": True,
+    "props_per_sec": True,
+    "cpu_time": False,
+    "wall_time": False,
+    "peak_rss_mb": False,
+}
+
+
+def best_of(runs):
+    """Best value of every metric over the repeats, to filter out noise"""
+    best = dict(runs[0])
+    for r in runs[1:]:
+        for m, higher in METRICS.items():
+            if m in r and m in best:
+                best[m] = max(best[m], r[m]) if higher else min(best[m], r[m])
+        for p, t in r["passes"].items():
+            best["passes"][p] = min(best["passes"].get(p, t), t)
+    return best
+
+
+def compare(base, new, tolerance, min_pass_time):
+    """Returns a list of (instance, what, old, new) that got worse"""
+    bad = []
+    for name, n in sorted(new.items()):
+        b = base.get(name)
+        if b is None:
+            continue
+        if b["result"] != n["result"] and "INDETERMINATE" not in (b["result"], n["result"]):
+            bad.append((name, "result", b["result"], n["result"]))
+        for m, higher in METRICS.items():
+            if m not in b or m not in n or b[m] == 0:
+                continue
+            change = n[m]/b[m] - 1.0
+            if (higher and change < -tolerance) or (not higher and change > tolerance):
+                bad.append((name, m, b[m], n[m]))
+        for p, t in n["passes"].items():
+            old = b["passes"].get(p)
+            if old is None or max(old, t) < min_pass_time:
+                continue
+            if t > old*(1.0+tolerance):
+                bad.append((name, p + " time", old, t))
+    return bad
+
+
+def print_table(results, base):
+    print("%-16s %-14s %12s %12s %9s %9s" % (
+        "instance", "result", "confl/s", "props/s", "cpu s", "RSS MB"))
+    for name, r in sorted(results.items()):
+        def fmt(m, f):
+            s = f % r.get(m, 0)
+            if base and name in base and m in base[name] and base[name][m]:
+                s += " (%+.0f%%)" % (100.0*(r.get(m, 0)/base[name][m] - 1.0))
+            return s
+        print("%-16s %-14s %12s %12s %9s %9s" % (
+            name, r["result"][:14], fmt("confl_per_sec", "%.0f"),
+            fmt("props_per_sec", "%.0f"), fmt("cpu_time", "%.2f"),
+            fmt("peak_rss_mb", "%.0f")))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--solver", default="./cryptominisat5")
+    parser.add_argument("--corpus", default="perf_corpus",
+                        help="Directory for the generated instances")
+    parser.add_argument("--only", default=None,
+                        help="Regexp, only run the matching instances")
+    parser.add_argument("--cnf", action="append", default=[],
+                        help="Run on this CNF instead of the corpus, can be repeated")
+    parser.add_argument("--maxconfl", type=int, default=30000,
+                        help="Conflict limit for the --cnf instances")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--repeat", type=int, default=3,
+                        help="Runs per instance, the best values are kept")
+    parser.add_argument("--baseline", default=None,
+                        help="Compare to this baseline. It is created if it does not exist")
+    parser.add_argument("--save-baseline", default=None,
+                        help="Save the results as a baseline to this file")
+    parser.add_argument("--tolerance", type=float, default=0.10,
+                        help="Relative slowdown allowed before failing, default 0.10")
+    parser.add_argument("--min-pass-time", type=float, default=0.2,
+                        help="Ignore passes that took less than this many seconds")
+    parser.add_argument("--json-out", default=None,
+                        help="Write the results of this run here")
+    parser.add_argument("extra", nargs="*",
+                        help="Extra arguments to the solver, after '--'")
+    args = parser.parse_args()
+
+    if args.cnf:
+        instances = [(os.path.basename(f), f, args.maxconfl) for f in args.cnf]
+    else:
+        instances = generate_corpus(args.corpus, args.only)
+
+    results = {}
+    for name, fname, maxconfl in instances:
+        runs = [run_one(args.solver, fname, maxconfl, args.seed, args.extra)
+                for _ in range(args.repeat)]
+        results[name] = best_of(runs)
+        results[name]["maxconfl"] = maxconfl
+        print("c done %s" % name)
+        sys.stdout.flush()
+
+    base = None
+    if args.baseline and os.path.exists(args.baseline):
+        with open(args.baseline) as f:
+            base = json.load(f)["instances"]
+
+    print_table(results, base)
+    data = {"solver": os.path.abspath(args.solver), "seed": args.seed,
+            "instances": results}
+    if args.json_out:
+        with open(args.json_out, "w") as f:
+            json.dump(data, f, indent=2, sort_keys=True)
+    to_save = args.save_baseline
+    if args.baseline and base is None:
+        print("No baseline at %s, saving this run as the baseline" % args.baseline)
+        to_save = args.baseline
+    if to_save:
+        with open(to_save, "w") as f:
+            json.dump(data, f, indent=2, sort_keys=True)
+
+    failed = [name for name, r in sorted(results.items()) if r["result"] == "ERROR"]
+    if failed:
+        print("ERROR: the solver failed on: %s" % " ".join(failed))
+        sys.exit(1)
+
+    if base is None:
+        sys.exit(0)
+
+    bad = compare(base, results, args.tolerance, args.min_pass_time)
+    if not bad:
+        print("OK, no regression above %.0f%%" % (100.0*args.tolerance))
+        sys.exit(0)
+    print("REGRESSIONS:")
+    for name, what, old, new in bad:
+        print("  %-16s %-28s %s -> %s" % (name, what, old, new))
+    sys.exit(1)
@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+# Copyright (c) 2024, Mate Soos
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+
+# Compares per-thread conflicts/sec with and without thread pinning.
+# Best run on a multi-node box with one thread per core, e.g.:
+#
+#   ./pinning.py --threads 32 --maxconfl 200000 instance1.cnf instance2.cnf
+
+import argparse
+import re
+import subprocess
+import sys
+
+confl_re = re.compile(r"^c thread (\d+) confl/s\s*:\s*([0-9.eE+-]+)")
+
+
+def run(args, fname, pin):
+    cmd = [args.solver, "--threads", str(args.threads), "--pin", pin,
+           "--maxconfl", str(args.maxconfl), "--verb", "1", fname]
+    out = subprocess.run(cmd, stdout=subprocess.PIPE,
+                         universal_newlines=True).stdout
+    speeds = {}
+    for line in out.splitlines():
+        m = confl_re.match(line)
+        if m:
+            speeds[int(m.group(1))] = float(m.group(2))
+    return [speeds[t] for t in sorted(speeds)]
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--solver", default="./cryptominisat5")
+    parser.add_argument("--threads", type=int, default=4)
+    parser.add_argument("--maxconfl", type=int, default=100000)
+    parser.add_argument("--modes", default="none,node,core",
+                        help="Comma-separated pinning modes to compare")
+    parser.add_argument("files", nargs="+")
+    args = parser.parse_args()
+
+    modes = args.modes.split(",")
+    totals = {mode: 0.0 for mode in modes}
+    for fname in args.files:
+        print("%s" % fname)
+        for mode in modes:
+            speeds = run(args, fname, mode)
+            if not speeds:
+                print("  %-5s no per-thread stats found" % mode)
+                continue
+            avg = sum(speeds)/len(speeds)
+            totals[mode] += avg
+            print("  %-5s avg %10.1f  min %10.1f  max %10.1f confl/s per thread"
+                  % (mode, avg, min(speeds), max(speeds)))
+
+    if len(args.files) > 1:
+        print("Sum of per-file averages:")
+        for mode in modes:
+            print("  %-5s %10.1f" % (mode, totals[mode]))
+    base = totals.get("none", 0.0)
+    if base > 0:
+        for mode in modes:
+            if mode != "none":
+                print("%s vs none: %+.1f%%" % (mode, 100.0*(totals[mode]/base-1.0)))
+    sys.exit(0)
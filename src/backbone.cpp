@@ -31,6 +31,7 @@ using namespace CMSat;
 
 bool Solver::backbone_simpl(int64_t orig_max_confl, bool& finished)
 {
+    drop_kept_assumps();
     vector<int> cnf;
     /* for(uint32_t i = 0; i < nVars(); i++) picosat_inc_max_var(picosat); */
 
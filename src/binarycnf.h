@@ -0,0 +1,439 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <stdexcept>
+#include <gmpxx.h>
+#include "solvertypesmini.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace CMSat {
+
+// Binary CNF container, an alternative to DIMACS for very large instances.
+//
+// A 16-byte header (magic "CMSBCNF1", version, number of variables) is
+// followed by sections, each a 16-byte {tag, 0, payload bytes} header and a
+// payload padded to 8 bytes. Literals are stored as Lit::toInt() in 32 bits,
+// counts and clause offsets in 64 bits, so a mapped file is read in place.
+// Clause-like sections hold the number of clauses, a clause-offset index of
+// num+1 entries into the literal array, then the literal array itself.
+// Unknown sections are skipped.
+enum class BinCnfSection : uint32_t {
+    clauses = 1 // num, offsets[num+1], lits
+    , red = 2 // same as clauses
+    , xors = 3 // same as clauses, rhs folded into the sign of the first literal
+    , bnns = 4 // num, offsets[num+1], cutoffs[num], outs[num], lits
+    , weights = 5 // num, weights[num] as double, lits[num]
+    , sampl_vars = 6 // num, vars[num]
+    , opt_sampl_vars = 7 // num, vars[num]
+    , multiplier = 8 // num, decimal digits
+};
+
+static const uint32_t bincnf_magic[2] = {0x42534d43U, 0x31464e43U}; //"CMSBCNF1"
+static const uint32_t bincnf_version = 1;
+
+//Collects constraints, added with the same calls as to SATSolver, then writes
+//them with write()
+class BinaryCnfWriter
+{
+public:
+    uint32_t nVars() const { return num_vars; }
+    void new_var() { num_vars++; }
+    void new_vars(const size_t n) { num_vars += n; }
+
+    bool add_clause(const std::vector<Lit>& lits) { return add(cls, lits); }
+    bool add_red_clause(const std::vector<Lit>& lits) { return add(red_cls, lits); }
+    bool add_xor_clause(const std::vector<Lit>& lits, const bool rhs = true) {
+        if (lits.empty() && !rhs) return true;
+        add(xor_cls, lits);
+        if (!rhs) xor_cls.lits[xor_cls.offsets[xor_cls.offsets.size()-2]] ^= true;
+        return true;
+    }
+    bool add_bnn_clause(const std::vector<Lit>& lits, const signed cutoff, const Lit out = lit_Undef) {
+        add(bnns, lits);
+        bnn_cutoffs.push_back(cutoff);
+        bnn_outs.push_back(out.toInt());
+        return true;
+    }
+    void set_weighted(const bool) {}
+    void set_lit_weight(const Lit lit, const double weight) {
+        weight_lits.push_back(lit.toInt());
+        weights.push_back(weight);
+    }
+    void set_sampl_vars(const std::vector<uint32_t>& vars) { sampl_vars = vars; }
+    void set_opt_sampl_vars(const std::vector<uint32_t>& vars) { opt_sampl_vars = vars; }
+    void set_multiplier_weight(const mpz_class& mult) { multiplier = mult.get_str(); }
+
+    //Throws std::runtime_error if the file cannot be written
+    void write(const std::string& fname) const
+    {
+        std::ofstream f(fname, std::ios::binary | std::ios::trunc);
+        if (f) {
+            const uint32_t header[4] = {bincnf_magic[0], bincnf_magic[1], bincnf_version, num_vars};
+            f.write((const char*)header, sizeof(header));
+            write_cls(f, BinCnfSection::clauses, cls);
+            write_cls(f, BinCnfSection::red, red_cls);
+            write_cls(f, BinCnfSection::xors, xor_cls);
+            if (!bnns.empty()) {
+                const uint64_t num = bnns.offsets.size()-1;
+                section(f, BinCnfSection::bnns, 8*(1+num+1) + 4*(2*num + bnns.lits.size()));
+                raw(f, &num, 1);
+                raw(f, bnns.offsets.data(), bnns.offsets.size());
+                raw(f, bnn_cutoffs.data(), num);
+                raw(f, bnn_outs.data(), num);
+                raw(f, bnns.lits.data(), bnns.lits.size());
+                pad(f, 4*bnns.lits.size());
+            }
+            if (!weights.empty()) {
+                const uint64_t num = weights.size();
+                section(f, BinCnfSection::weights, 8 + 12*num);
+                raw(f, &num, 1);
+                raw(f, weights.data(), num);
+                raw(f, weight_lits.data(), num);
+                pad(f, 4*num);
+            }
+            write_vars(f, BinCnfSection::sampl_vars, sampl_vars);
+            write_vars(f, BinCnfSection::opt_sampl_vars, opt_sampl_vars);
+            if (!multiplier.empty()) {
+                const uint64_t num = multiplier.size();
+                section(f, BinCnfSection::multiplier, 8 + num);
+                raw(f, &num, 1);
+                raw(f, multiplier.data(), num);
+                pad(f, num);
+            }
+        }
+        if (!f) {
+            const std::string err = "ERROR: cannot write binary CNF to file '" + fname + "'";
+            std::cerr << err << std::endl;
+            throw std::runtime_error(err);
+        }
+    }
+
+private:
+    struct Cls {
+        bool empty() const { return offsets.size() == 1; }
+        std::vector<uint64_t> offsets = std::vector<uint64_t>(1, 0);
+        std::vector<uint32_t> lits;
+    };
+
+    static bool add(Cls& c, const std::vector<Lit>& lits) {
+        for(const Lit l: lits) c.lits.push_back(l.toInt());
+        c.offsets.push_back(c.lits.size());
+        return true;
+    }
+
+    template<class T>
+    static void raw(std::ofstream& f, const T* data, const uint64_t num) {
+        f.write((const char*)data, num*sizeof(T));
+    }
+    static void pad(std::ofstream& f, const uint64_t bytes) {
+        const uint64_t zero = 0;
+        if (bytes % 8) f.write((const char*)&zero, 8 - bytes % 8);
+    }
+    static void section(std::ofstream& f, const BinCnfSection tag, const uint64_t bytes) {
+        const uint32_t head[2] = {(uint32_t)tag, 0};
+        const uint64_t padded = (bytes + 7) / 8 * 8;
+        raw(f, head, 2);
+        raw(f, &padded, 1);
+    }
+    static void write_cls(std::ofstream& f, const BinCnfSection tag, const Cls& c) {
+        if (c.empty()) return;
+        const uint64_t num = c.offsets.size()-1;
+        section(f, tag, 8*(1+num+1) + 4*c.lits.size());
+        raw(f, &num, 1);
+        raw(f, c.offsets.data(), c.offsets.size());
+        raw(f, c.lits.data(), c.lits.size());
+        pad(f, 4*c.lits.size());
+    }
+    static void write_vars(std::ofstream& f, const BinCnfSection tag, const std::vector<uint32_t>& vars) {
+        if (vars.empty()) return;
+        const uint64_t num = vars.size();
+        section(f, tag, 8 + 4*num);
+        raw(f, &num, 1);
+        raw(f, vars.data(), num);
+        pad(f, 4*num);
+    }
+
+    uint32_t num_vars = 0;
+    Cls cls;
+    Cls red_cls;
+    Cls xor_cls;
+    Cls bnns;
+    std::vector<int32_t> bnn_cutoffs;
+    std::vector<uint32_t> bnn_outs;
+    std::vector<double> weights;
+    std::vector<uint32_t> weight_lits;
+    std::vector<uint32_t> sampl_vars;
+    std::vector<uint32_t> opt_sampl_vars;
+    std::string multiplier;
+};
+
+//Maps (or, without mmap, reads) a binary CNF file and adds its contents to
+//the solver. Irredundant clauses go in one SATSolver::add_clauses() call
+//straight from the mapped memory.
+template <class S>
+class BinaryCnfParser
+{
+public:
+    BinaryCnfParser(S* _solver, const unsigned _verbosity) :
+        solver(_solver), verbosity(_verbosity) {}
+    ~BinaryCnfParser() { unmap(); }
+
+    static bool is_binary_cnf(const std::string& fname)
+    {
+        std::ifstream f(fname, std::ios::binary);
+        uint32_t magic[2] = {0, 0};
+        f.read((char*)magic, sizeof(magic));
+        return f && magic[0] == bincnf_magic[0] && magic[1] == bincnf_magic[1];
+    }
+
+    bool parse(const std::string& _fname)
+    {
+        static_assert(sizeof(Lit) == sizeof(uint32_t), "Lit must be a bare 32-bit word");
+        fname = _fname;
+        if (!map()) return false;
+        if (bytes < 16 || bytes % 8 != 0) return error("file size is not a multiple of 8 bytes");
+        const uint32_t* header = (const uint32_t*)data;
+        if (header[0] != bincnf_magic[0] || header[1] != bincnf_magic[1]) {
+            return error("not a binary CNF file");
+        }
+        if (header[2] != bincnf_version) return error("unsupported version");
+        num_vars = header[3];
+        if (num_vars >= (1ULL<<28)) return error("too many variables");
+        if (solver->nVars() < num_vars) solver->new_vars(num_vars - solver->nVars());
+
+        uint64_t at = 16;
+        while(at < bytes) {
+            if (bytes - at < 16) return error("truncated section header");
+            const uint32_t tag = *(const uint32_t*)(data + at);
+            const uint64_t len = *(const uint64_t*)(data + at + 8);
+            at += 16;
+            if (len % 8 != 0 || len > bytes - at) return error("bad section length");
+            if (!parse_section((BinCnfSection)tag, data + at, len)) return false;
+            at += len;
+        }
+
+        if (verbosity) {
+            std::cout
+            << "c -- clauses added: " << norm_clauses_added << std::endl
+            << "c -- xor clauses added: " << xor_clauses_added << std::endl
+            << "c -- vars added " << num_vars << std::endl;
+        }
+        return true;
+    }
+
+private:
+    bool error(const std::string& what) const
+    {
+        std::cerr << "ERROR! Binary CNF file '" << fname << "': " << what << std::endl;
+        return false;
+    }
+
+    //Reads the clause-offset index and literals of a clause-like section and
+    //checks them, so the solver never sees an out-of-range literal
+    bool clause_arrays(const char* p, const uint64_t len, const uint64_t extra_words,
+        uint64_t& num, const uint64_t*& offsets, const Lit*& lits)
+    {
+        if (len < 16) return error("section is too short");
+        num = *(const uint64_t*)p;
+        if (num > len/8 - 2) return error("section is too short");
+        offsets = (const uint64_t*)(p + 8);
+        const uint64_t lits_at = 8*(1+num+1) + 4*extra_words*num;
+        if (lits_at > len || offsets[0] != 0 || offsets[num] > (len - lits_at)/4) {
+            return error("bad clause index");
+        }
+        for(uint64_t i = 0; i < num; i++) {
+            if (offsets[i] > offsets[i+1]) return error("bad clause index");
+        }
+        lits = (const Lit*)(p + lits_at);
+        for(uint64_t i = 0; i < offsets[num]; i++) {
+            if (lits[i].var() >= num_vars) return error("literal out of range");
+        }
+        return true;
+    }
+
+    bool parse_section(const BinCnfSection tag, const char* p, const uint64_t len)
+    {
+        uint64_t num;
+        const uint64_t* offsets;
+        const Lit* lits;
+        switch(tag) {
+            case BinCnfSection::weights:
+            case BinCnfSection::sampl_vars:
+            case BinCnfSection::opt_sampl_vars:
+            case BinCnfSection::multiplier:
+                if (len < 8) return error("section is too short");
+                break;
+            default:
+                break;
+        }
+        switch(tag) {
+            case BinCnfSection::clauses:
+                if (!clause_arrays(p, len, 0, num, offsets, lits)) return false;
+                solver->add_clauses(lits, offsets, num);
+                norm_clauses_added += num;
+                break;
+            case BinCnfSection::red:
+                if (!clause_arrays(p, len, 0, num, offsets, lits)) return false;
+                for(uint64_t i = 0; i < num; i++) {
+                    tmp.assign(lits + offsets[i], lits + offsets[i+1]);
+                    solver->add_red_clause(tmp);
+                }
+                break;
+            case BinCnfSection::xors:
+                if (!clause_arrays(p, len, 0, num, offsets, lits)) return false;
+                for(uint64_t i = 0; i < num; i++) {
+                    tmp.assign(lits + offsets[i], lits + offsets[i+1]);
+                    solver->add_xor_clause(tmp, true);
+                }
+                xor_clauses_added += num;
+                break;
+            case BinCnfSection::bnns: {
+                #ifdef ENABLE_BNN
+                if (!clause_arrays(p, len, 2, num, offsets, lits)) return false;
+                const int32_t* cutoffs = (const int32_t*)(p + 8*(1+num+1));
+                const Lit* outs = (const Lit*)(cutoffs + num);
+                for(uint64_t i = 0; i < num; i++) {
+                    if (outs[i] != lit_Undef && outs[i].var() >= num_vars) {
+                        return error("literal out of range");
+                    }
+                    tmp.assign(lits + offsets[i], lits + offsets[i+1]);
+                    solver->add_bnn_clause(tmp, cutoffs[i], outs[i]);
+                }
+                #else
+                return error("BNN encountered but not enabled in parsing");
+                #endif
+                break;
+            }
+            case BinCnfSection::weights: {
+                num = *(const uint64_t*)p;
+                if (num > (len - 8)/12) return error("section is too short");
+                const double* weights = (const double*)(p + 8);
+                lits = (const Lit*)(weights + num);
+                solver->set_weighted(true);
+                for(uint64_t i = 0; i < num; i++) {
+                    if (lits[i].var() >= num_vars) return error("literal out of range");
+                    solver->set_lit_weight(lits[i], weights[i]);
+                }
+                break;
+            }
+            case BinCnfSection::sampl_vars:
+            case BinCnfSection::opt_sampl_vars: {
+                num = *(const uint64_t*)p;
+                if (num > (len - 8)/4) return error("section is too short");
+                const uint32_t* vars = (const uint32_t*)(p + 8);
+                for(uint64_t i = 0; i < num; i++) {
+                    if (vars[i] >= num_vars) return error("variable out of range");
+                }
+                std::vector<uint32_t> vs(vars, vars + num);
+                if (tag == BinCnfSection::sampl_vars) solver->set_sampl_vars(vs);
+                else solver->set_opt_sampl_vars(vs);
+                break;
+            }
+            case BinCnfSection::multiplier:
+                num = *(const uint64_t*)p;
+                if (num > len - 8) return error("section is too short");
+                solver->set_multiplier_weight(mpz_class(std::string(p + 8, num), 10));
+                break;
+            default:
+                if (verbosity >= 2) {
+                    std::cout << "c Skipping unknown binary CNF section " << (uint32_t)tag << std::endl;
+                }
+        }
+        return true;
+    }
+
+    bool map()
+    {
+        #ifndef _WIN32
+        const int fd = open(fname.c_str(), O_RDONLY);
+        if (fd == -1) return error(std::string("could not open: ") + strerror(errno));
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            return error(std::string("could not stat: ") + strerror(errno));
+        }
+        bytes = st.st_size;
+        if (bytes > 0) {
+            void* m = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (m != MAP_FAILED) {
+                madvise(m, bytes, MADV_SEQUENTIAL);
+                data = (const char*)m;
+                mapped = true;
+            }
+        }
+        close(fd);
+        if (mapped || bytes == 0) return true;
+        #endif
+
+        //Fall back to reading the file into (8-byte aligned) memory
+        std::ifstream f(fname, std::ios::binary | std::ios::ate);
+        if (!f) return error("could not open");
+        bytes = f.tellg();
+        buf.resize((bytes+7)/8);
+        f.seekg(0);
+        f.read((char*)buf.data(), bytes);
+        if (!f) return error("could not read");
+        data = (const char*)buf.data();
+        return true;
+    }
+
+    void unmap()
+    {
+        #ifndef _WIN32
+        if (mapped) munmap((void*)data, bytes);
+        #endif
+        mapped = false;
+    }
+
+    S* solver;
+    unsigned verbosity;
+    std::string fname;
+    const char* data = nullptr;
+    uint64_t bytes = 0;
+    bool mapped = false;
+    std::vector<uint64_t> buf;
+    uint32_t num_vars = 0;
+    std::vector<Lit> tmp;
+
+    size_t norm_clauses_added = 0;
+    size_t xor_clauses_added = 0;
+};
+
+}
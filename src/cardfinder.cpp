@@ -414,3 +414,96 @@ void CardFinder::find_cards()
         << endl;
     }
 }
+
+//Is every pair of the card's literals forbidden by an irredundant binary?
+//Redundant ones may come from e.g. BVA or symmetry breaking, so they
+//are not enough to make the group an irredundant constraint.
+bool CardFinder::all_pairs_irred(const vector<Lit>& card)
+{
+    for(const Lit l: card) seen[(~l).toInt()] = 1;
+    bool ok = true;
+    for(const Lit l: card) {
+        uint32_t found = 0;
+        for(const Watched& w: solver->watches[~l]) {
+            if (!w.isBin() || w.red() || seen[w.lit2().toInt()] != 1) continue;
+            if (w.lit2() == ~l) continue;
+            seen[w.lit2().toInt()] = 2;
+            found++;
+        }
+        for(const Lit l2: card) seen[(~l2).toInt()] = 1;
+        if (found != card.size()-1) {
+            ok = false;
+            break;
+        }
+    }
+    for(const Lit l: card) seen[(~l).toInt()] = 0;
+    return ok;
+}
+
+//Removes all binaries, redundant or not, between the card's literals
+uint64_t CardFinder::remove_pair_bins(const vector<Lit>& card)
+{
+    uint64_t removed = 0;
+    for(const Lit l: card) seen[(~l).toInt()] = 1;
+    for(const Lit l: card) {
+        watch_subarray ws = solver->watches[~l];
+        Watched* i = ws.begin();
+        Watched* j = i;
+        for(Watched* end = ws.end(); i != end; i++) {
+            if (!i->isBin() || !seen[i->lit2().toInt()]) {
+                *j++ = *i;
+                continue;
+            }
+            removeWBin(solver->watches, i->lit2(), ~l, i->red(), i->get_ID());
+            if (i->red()) solver->binTri.redBins--;
+            else solver->binTri.irredBins--;
+            removed++;
+        }
+        ws.shrink(i-j);
+    }
+    for(const Lit l: card) seen[(~l).toInt()] = 0;
+    return removed;
+}
+
+//Replaces at-most-one groups that are pairwise encoded, i.e. with
+//n(n-1) binary watches, with a BNN "at least n-1 of the negations",
+//which needs 2n watches and propagates as soon as one of them is set.
+//BNNs turn off occurrence-based simplification, so this is opt-in.
+bool CardFinder::atmost1_to_bnns()
+{
+    assert(solver->okay());
+    assert(solver->decisionLevel() == 0);
+    if (solver->frat->enabled()) return solver->okay();
+
+    double my_time = cpuTime();
+    uint64_t replaced = 0;
+    uint64_t bins_removed = 0;
+    vector<Lit> lits;
+    for(const auto& card: cards) {
+        if (card.size() < solver->conf.card_native_min_size) continue;
+
+        bool usable = true;
+        for(const Lit l: card) {
+            if (solver->value(l) != l_Undef
+                || solver->varData[l.var()].removed != Removed::none)
+            {
+                usable = false;
+                break;
+            }
+        }
+        if (!usable || !all_pairs_irred(card)) continue;
+
+        bins_removed += remove_pair_bins(card);
+        lits.clear();
+        for(const Lit l: card) lits.push_back(~l);
+        solver->add_bnn_clause_inter(lits, lits.size()-1, lit_Undef);
+        replaced++;
+        if (!solver->okay()) break;
+    }
+
+    verb_print(1, "[cardfind] replaced " << replaced << " at-most-one groups with BNNs,"
+        << " removed bins: " << bins_removed
+        << solver->conf.print_times(cpuTime()-my_time));
+
+    return solver->okay();
+}
@@ -47,6 +47,7 @@ class CardFinder
 public:
     CardFinder(Solver* solver);
     void find_cards();
+    bool atmost1_to_bnns();
     const vector<vector<Lit>>& get_cards() const;
 
 private:
@@ -58,6 +59,8 @@ private:
     void print_cards(const vector<vector<Lit>>& card_constraints) const;
     void find_two_product_atmost1();
     void clean_empty_cards();
+    bool all_pairs_irred(const vector<Lit>& card);
+    uint64_t remove_pair_bins(const vector<Lit>& card);
 
     //from solver
     Solver* solver;
@@ -119,6 +119,12 @@ bool ls_solver::local_search(
             if (_mems > _mems_limit) {
                 return result;
             }
+            if ((_step & 0xfff) == 0xfff
+                && _interrupt
+                && _interrupt->load(std::memory_order_relaxed)
+            ) {
+                return result;
+            }
 
 
             if ((int)_unsat_clauses.size() < _best_found_cost) {
@@ -536,3 +542,8 @@ void ls_solver::set_verbosity(uint32_t verb)
 {
     _verbosity = verb;
 }
+
+void ls_solver::set_interrupt(const std::atomic<bool>* interrupt)
+{
+    _interrupt = interrupt;
+}
@@ -24,6 +24,7 @@ THE SOFTWARE.
 #define CCNR_H
 
 #include <cstdint>
+#include <atomic>
 #include <string>
 #include <vector>
 #include "ccnr_mersenne.h"
@@ -102,6 +103,7 @@ class ls_solver
         return _best_found_cost;
     }
     void set_verbosity(uint32_t verb);
+    void set_interrupt(const std::atomic<bool>* interrupt);
 
     //formula
     vector<variable> _vars;
@@ -129,6 +131,7 @@ class ls_solver
     private:
     int _best_found_cost;
     long long _mems = 0;
+    const std::atomic<bool>* _interrupt = nullptr;
     long long _step;
     long long _max_steps;
     int _max_tries;
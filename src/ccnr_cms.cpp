@@ -41,6 +41,7 @@ CMS_ccnr::CMS_ccnr(Solver* _solver) :
 {
     ls_s = new CCNR::ls_solver(solver->conf.sls_ccnr_asipire);
     ls_s->set_verbosity(solver->conf.verbosity);
+    ls_s->set_interrupt(solver->get_must_interrupt_inter_asap_ptr());
 }
 
 CMS_ccnr::~CMS_ccnr()
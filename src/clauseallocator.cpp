@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include "time_mem.h"
 #include "sqlstats.h"
 #include "gaussian.h"
+#include "trace.h"
 
 #ifdef USE_VALGRIND
 #include "valgrind/valgrind.h"
@@ -149,6 +150,28 @@ void* ClauseAllocator::allocEnough(
     return pointer;
 }
 
+/**
+@brief Grows the stack in one go so that the given clauses fit
+
+Only a hint, used before adding many clauses at once: it avoids repeated
+reallocation (and copying) of the stack while they are being added.
+*/
+void ClauseAllocator::reserve(const uint64_t num_cls, const uint64_t num_lits)
+{
+    const uint64_t neededbytes = num_cls*sizeof(Clause) + num_lits*sizeof(Lit);
+    const uint64_t needed = neededbytes/sizeof(BASE_DATA_TYPE) + num_cls;
+    if (size + needed <= capacity) return;
+
+    const uint64_t newcapacity = std::min<uint64_t>(size + needed, MAXSIZE);
+    BASE_DATA_TYPE* new_dataStart = (BASE_DATA_TYPE*)realloc(
+        dataStart
+        , newcapacity*sizeof(BASE_DATA_TYPE)
+    );
+    if (new_dataStart == nullptr) return;
+    dataStart = new_dataStart;
+    capacity = newcapacity;
+}
+
 /**
 @brief Given the pointer of the clause it finds a 32-bit offset for it
 
@@ -265,6 +288,7 @@ void ClauseAllocator::consolidate(
         }
         return;
     }
+    TRACE_SCOPE("consolidate");
     const double my_time = cpuTime();
     new_sz_while_moving = 0;
 
@@ -286,22 +310,22 @@ void ClauseAllocator::consolidate(
 
     //Fix up propBy
     for (size_t i = 0; i < solver->nVars(); i++) {
-        VarData& vdata = solver->varData[i];
-        if (vdata.reason.isClause()) {
-            if (vdata.removed == Removed::none
-                && solver->decisionLevel() >= vdata.level
-                && vdata.level != 0
+        PropBy& reason = solver->varReason[i];
+        if (reason.isClause()) {
+            if (solver->varData[i].removed == Removed::none
+                && solver->decisionLevel() >= solver->varLevel[i]
+                && solver->varLevel[i] != 0
                 && solver->value(i) != l_Undef
             ) {
-                Clause* old = ptr(vdata.reason.get_offset());
+                Clause* old = ptr(reason.get_offset());
                 assert(!old->freed());
                 ClOffset new_offset = (*old)[0].toInt();
                 #ifdef LARGE_OFFSETS
                 new_offset += ((uint64_t)(*old)[1].toInt())<<32;
                 #endif
-                vdata.reason = PropBy(new_offset);
+                reason = PropBy(new_offset);
             } else {
-                vdata.reason = PropBy();
+                reason = PropBy();
             }
         }
     }
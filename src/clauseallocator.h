@@ -78,6 +78,7 @@ class ClauseAllocator {
 
         void clauseFree(Clause* c);
         void clauseFree(ClOffset offset);
+        void reserve(const uint64_t num_cls, const uint64_t num_lits);
 
         void consolidate(
             Solver* solver
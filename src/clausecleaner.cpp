@@ -142,7 +142,7 @@ bool ClauseCleaner::clean_bnn(BNN& bnn, uint32_t bnn_idx) {
     for(; i < bnn.size(); i++) {
         Lit l = bnn[i];
         if (solver->value(l) == l_Undef) {
-            bnn[j++] = bnn[i];
+            bnn.move_lit(j++, i);
             continue;
         }
         removeWBNN(solver->watches, l, bnn_idx);
@@ -151,7 +151,7 @@ bool ClauseCleaner::clean_bnn(BNN& bnn, uint32_t bnn_idx) {
         if (solver->value(l) == l_False) {
             //nothing
         } else if (solver->value(l) == l_True) {
-            bnn.cutoff--;
+            bnn.cutoff -= bnn.weight(i);
         }
     }
     bnn.resize(j);
@@ -160,10 +160,17 @@ bool ClauseCleaner::clean_bnn(BNN& bnn, uint32_t bnn_idx) {
         removeWBNN(solver->watches, bnn.out, bnn_idx);
         removeWBNN(solver->watches, ~bnn.out, bnn_idx);
         if (solver->value(bnn.out) == l_False) {
-            for (auto& l: bnn) {
-                l = ~l;
+            //Flipping the literals flips their pos/neg watches too
+            for (uint32_t k = 0; k < bnn.size(); k++) {
+                const Lit l = bnn[k];
+                const int32_t w = bnn.weight(k);
+                removeWBNN(solver->watches, l, bnn_idx);
+                removeWBNN(solver->watches, ~l, bnn_idx);
+                solver->watches[l].push(Watched(bnn_idx, WatchType::watch_bnn_t, bnn_neg_t, w));
+                solver->watches[~l].push(Watched(bnn_idx, WatchType::watch_bnn_t, bnn_pos_t, w));
+                bnn[k] = ~l;
             }
-            bnn.cutoff = (int32_t)bnn.size()+1-bnn.cutoff;
+            bnn.cutoff = bnn.total_weight()+1-bnn.cutoff;
         }
         bnn.set = true;
         bnn.out = lit_Undef;
@@ -215,7 +222,7 @@ void ClauseCleaner::clean_bnns_inter(vector<BNN*>& bnns)
             bnn->isRemoved = true;
 //             cout << "Removed BNN" << endl;
         }
-        bnn->undefs = bnn->size();
+        bnn->undefs = bnn->total_weight();
         bnn->ts = 0;
     }
 }
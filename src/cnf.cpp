@@ -126,6 +126,8 @@ void CNF::swapVars(const uint32_t which, const int off_by)
 {
     std::swap(assigns[nVars()-off_by-1], assigns[which]);
     std::swap(varData[nVars()-off_by-1], varData[which]);
+    std::swap(varLevel[nVars()-off_by-1], varLevel[which]);
+    std::swap(varReason[nVars()-off_by-1], varReason[which]);
 }
 
 void CNF::enlarge_nonminimial_datastructs(size_t n)
@@ -136,6 +138,8 @@ void CNF::enlarge_nonminimial_datastructs(size_t n)
     for(uint32_t i = 0; i < n; i++) {
         varData.push_back(VarData(varData.size()));
     }
+    varLevel.insert(varLevel.end(), n, numeric_limits<uint32_t>::max());
+    varReason.insert(varReason.end(), n, PropBy());
     depth.insert(depth.end(), n, 0);
 }
 
@@ -240,6 +244,8 @@ void CNF::update_vars(
     , const vector<uint32_t>& inter_to_outer2
 ) {
     updateArray(varData, inter_to_outer);
+    updateArray(varLevel, inter_to_outer);
+    updateArray(varReason, inter_to_outer);
     updateArray(assigns, inter_to_outer);
     updateArray(unit_cl_IDs, inter_to_outer);
     updateArray(unit_cl_XIDs, inter_to_outer);
@@ -801,13 +807,16 @@ bool CNF::check_bnn_sane(BNN& bnn)
 
     int32_t ts = 0;
     int32_t undefs = 0;
-    for(const auto& l: bnn) {
+    int32_t max_undef = 0;
+    for(uint32_t i = 0; i < bnn.size(); i++) {
+        const Lit l = bnn[i];
         if (value(l) == l_True) {
-            ts++;
+            ts += bnn.weight(i);
         }
 
         if (value(l) == l_Undef) {
-            undefs++;
+            undefs += bnn.weight(i);
+            max_undef = std::max(max_undef, bnn.weight(i));
         }
     }
     assert(bnn.ts == ts);
@@ -845,9 +854,10 @@ bool CNF::check_bnn_sane(BNN& bnn)
         return false;
     }
 
-    //it's set and cutoff can ONLY be met by ALL TRUE
+    //it's set and cutoff can ONLY be met by setting the heaviest ones TRUE
+    //(for unweighted, that's ALL of them)
     if (((!bnn.set && value(bnn.out) == l_True) || bnn.set) &&
-        undefs == bnn.cutoff-ts)
+        max_undef > undefs-(bnn.cutoff-ts))
     {
         return false;
     }
@@ -100,6 +100,11 @@ public:
     vec<vec<GaussWatched>> gwatches;
     uint32_t num_sls_called = 0;
     vector<VarData> varData;
+
+    //Kept apart from varData, in dense arrays, as conflict analysis and
+    //minimisation touch nothing else of the variable
+    vector<uint32_t> varLevel; ///<Decision level the var was assigned at
+    vector<PropBy> varReason; ///<Reason it was propagated, PropBy() for decisions/toplevel
     branch branch_strategy = branch::vsids;
     string branch_strategy_str = "VSIDS";
     string branch_strategy_str_short = "vs";
@@ -190,13 +195,14 @@ public:
                "If in UNSAT state, and we have FRAT, we MUST already know the unsat_cl_ID");
         return ok;
     }
-    auto level(Lit l) const { return varData[l.var()].level; }
+    uint32_t level(Lit l) const { return varLevel[l.var()]; }
     lbool value (const uint32_t x) const { return assigns[x]; }
     lbool value (const Lit p) const { return assigns[p.var()] ^ p.sign(); }
     bool must_interrupt_asap() const { return must_interrupt_inter->load(std::memory_order_relaxed); }
     void set_must_interrupt_asap() { must_interrupt_inter->store(true, std::memory_order_relaxed); }
     void unset_must_interrupt_asap() { must_interrupt_inter->store(false, std::memory_order_relaxed); }
     std::atomic<bool>* get_must_interrupt_inter_asap_ptr() { return must_interrupt_inter; }
+    void set_must_interrupt_inter_asap_ptr(std::atomic<bool>* ptr) { must_interrupt_inter = ptr; }
     const vector<BNN*>& get_bnns() const { return bnns; }
 
     bool check_bnn_sane(BNN& bnn);
@@ -459,8 +465,8 @@ inline void CNF::clean_occur_from_idx(const Lit lit)
 inline bool CNF::clause_locked(const Clause& c, const ClOffset offset) const
 {
     return value(c[0]) == l_True
-        && varData[c[0].var()].reason.isClause()
-        && varData[c[0].var()].reason.get_offset() == offset;
+        && varReason[c[0].var()].isClause()
+        && varReason[c[0].var()].get_offset() == offset;
 }
 
 inline void CNF::clear_one_occur_from_removed_clauses(watch_subarray w)
@@ -527,7 +533,7 @@ inline void CNF::check_no_removed_or_freed_cl_in_watch() const
     for(watch_subarray_const ws: watches) {
         for(const Watched& w: ws) {
             assert(!w.isIdx());
-            if (w.isBin()) {
+            if (w.isBin() || w.isBNN()) {
                 continue;
             }
             assert(w.isClause());
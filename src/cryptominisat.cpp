@@ -25,15 +25,24 @@ THE SOFTWARE.
 #include "solver.h"
 #include "frat.h"
 #include "shareddata.h"
+#include "portfolio.h"
+#include "numa.h"
+#include "trace.h"
+#include "binarycnf.h"
+#include "cubefinder.h"
 #include "solvertypesmini.h"
 
 #include <fstream>
+#include <deque>
+#include <algorithm>
 #include <cstdint>
 #include <iomanip>
 #include <limits>
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cassert>
 using std::thread;
 using std::vector;
@@ -69,7 +78,9 @@ namespace CMSat {
             }
 
             delete log; //this will also close the file
+            delete metrics_file;
             delete shared_data;
+            delete numa;
         }
         CMSatPrivateData(const CMSatPrivateData&) = delete;
         CMSatPrivateData& operator=(const CMSatPrivateData&) = delete;
@@ -106,9 +117,75 @@ namespace CMSat {
         uint64_t previous_sum_propagations = 0;
         uint64_t previous_sum_decisions = 0;
         vector<double> cpu_times;
+
+        //Portfolio, and how many calls each thread has won
+        Portfolio portfolio;
+        vector<uint64_t> thread_wins;
+
+        //Wall time from a thread finding the answer until all threads
+        //have stopped
+        double last_answer_to_return = 0;
+        double max_answer_to_return = 0;
+
+        //Thread placement, and conflicts/sec of each thread in the last call
+        ThreadPinning pinning = ThreadPinning::none;
+        NumaTopology* numa = nullptr;
+        vector<double> confl_per_sec;
+
+        //Live metrics, appended as JSON lines to metrics_file if set
+        const double created_at = real_time_sec();
+        std::ofstream* metrics_file = nullptr;
+        double metrics_every = 1.0;
     };
 }
 
+static string metrics_json(const CMSatPrivateData* data)
+{
+    vector<const Metrics*> all;
+    for(const Solver* s: data->solvers) all.push_back(s->metrics);
+    return Metrics::to_json(all, real_time_sec() - data->created_at);
+}
+
+//Appends a metrics line to the metrics file every metrics_every seconds
+//while a solve()/simplify() call runs, and a last one when it finishes
+class MetricsDumper
+{
+public:
+    explicit MetricsDumper(CMSatPrivateData* _data) : data(_data)
+    {
+        if (data->metrics_file) thd = thread([this] { loop(); });
+    }
+    ~MetricsDumper()
+    {
+        if (!data->metrics_file) return;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            done = true;
+        }
+        cv.notify_one();
+        thd.join();
+        *data->metrics_file << metrics_json(data) << endl;
+    }
+    MetricsDumper(const MetricsDumper&) = delete;
+    MetricsDumper& operator=(const MetricsDumper&) = delete;
+
+private:
+    void loop()
+    {
+        const auto every = std::chrono::duration<double>(data->metrics_every);
+        std::unique_lock<std::mutex> lock(mtx);
+        while (!cv.wait_for(lock, every, [this] { return done; })) {
+            *data->metrics_file << metrics_json(data) << endl;
+        }
+    }
+
+    CMSatPrivateData* data;
+    thread thd;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool done = false;
+};
+
 struct DataForThread
 {
     explicit DataForThread(CMSatPrivateData* data, const vector<Lit>* _assumptions = nullptr) :
@@ -120,6 +197,9 @@ struct DataForThread
         , update_mutex(new std::mutex)
         , which_solved(&(data->which_solved))
         , ret(new lbool(l_Undef))
+        , pinning(data->pinning)
+        , numa(data->numa)
+        , confl_per_sec(data->confl_per_sec)
     {
     }
 
@@ -136,6 +216,10 @@ struct DataForThread
     std::mutex* update_mutex;
     int *which_solved;
     lbool* ret;
+    double answer_found_at = -1; //wall time, protected by update_mutex
+    ThreadPinning pinning;
+    const NumaTopology* numa;
+    vector<double>& confl_per_sec;
 };
 
 DLL_PUBLIC SATSolver::SATSolver(
@@ -154,6 +238,8 @@ DLL_PUBLIC SATSolver::SATSolver(
 
     data->solvers.push_back(new Solver((SolverConf*) config, data->must_interrupt));
     data->cpu_times.push_back(0.0);
+    data->thread_wins.push_back(0);
+    data->confl_per_sec.push_back(0.0);
 }
 
 DLL_PUBLIC SATSolver::~SATSolver()
@@ -161,12 +247,8 @@ DLL_PUBLIC SATSolver::~SATSolver()
     delete data;
 }
 
-void update_config(SolverConf& conf, unsigned thread_num)
+static void set_builtin_personality(SolverConf& conf, unsigned thread_num)
 {
-    //Don't accidentally reconfigure everything to a specific value!
-    conf.origSeed += thread_num;
-    conf.thread_num = thread_num;
-
     switch(thread_num % 23) {
         case 0: {
             //default setup
@@ -384,6 +466,21 @@ void update_config(SolverConf& conf, unsigned thread_num)
     }
 }
 
+void update_config(SolverConf& conf, unsigned thread_num, const Portfolio& portfolio)
+{
+    if (portfolio.empty()) {
+        set_builtin_personality(conf, thread_num);
+    } else {
+        const Portfolio::Profile& prof = portfolio.profile_for_thread(thread_num);
+        if (prof.builtin >= 0) set_builtin_personality(conf, prof.builtin);
+        portfolio.apply_overrides(conf, thread_num);
+    }
+
+    //Don't accidentally reconfigure everything to a specific value!
+    conf.origSeed += thread_num;
+    conf.thread_num = thread_num;
+}
+
 DLL_PUBLIC void SATSolver::set_num_threads(unsigned num)
 {
     if (num <= 0) {
@@ -391,6 +488,15 @@ DLL_PUBLIC void SATSolver::set_num_threads(unsigned num)
         std::cerr << err << endl;
         throw std::runtime_error(err);
     }
+
+    //Thread 0 keeps the configuration it was created with, unless there is a
+    //portfolio
+    const SolverConf base_conf = data->solvers[0]->getConf();
+    if (!data->portfolio.empty() && data->solvers.size() == 1) {
+        SolverConf conf = base_conf;
+        update_config(conf, 0, data->portfolio);
+        data->solvers[0]->setConf(conf);
+    }
     if (num == 1) {
         return;
     }
@@ -423,10 +529,12 @@ DLL_PUBLIC void SATSolver::set_num_threads(unsigned num)
 
     data->cls_lits.reserve(CACHE_SIZE);
     for(unsigned i = 1; i < num; i++) {
-        SolverConf conf = data->solvers[0]->getConf();
-        update_config(conf, i);
+        SolverConf conf = base_conf;
+        update_config(conf, i, data->portfolio);
         data->solvers.push_back(new Solver(&conf, data->must_interrupt));
         data->cpu_times.push_back(0.0);
+        data->thread_wins.push_back(0);
+        data->confl_per_sec.push_back(0.0);
     }
 
     //set shared data
@@ -454,6 +562,7 @@ struct OneThreadAddCls
         solver.new_external_vars(data_for_thread.vars_to_add);
 
         vector<Lit> lits;
+        vector<int32_t> weights;
         bool ret = true;
         size_t at = 0;
         const vector<Lit>& orig_lits = (*data_for_thread.lits_to_add);
@@ -470,7 +579,7 @@ struct OneThreadAddCls
                     lits.push_back(orig_lits[at]);
                 }
                 ret = solver.add_clause_outside(lits);
-            } else {
+            } else if (orig_lits[at+1].var() == 0) {
                 lits.clear();
                 at++;
                 bool rhs = orig_lits[at].sign();
@@ -483,6 +592,32 @@ struct OneThreadAddCls
                     lits.push_back(orig_lits[at]);
                 }
                 ret = solver.add_xor_clause_outside(lits, rhs);
+            } else {
+                //BNN, see add_bnn_to_threads() for the layout
+                at++;
+                const bool weighted = orig_lits[at].var() == 2;
+                const bool has_out = orig_lits[at].sign();
+                at++;
+                const int32_t cutoff = orig_lits[at].toInt();
+                at++;
+                Lit out = lit_Undef;
+                if (has_out) out = orig_lits[at++];
+                lits.clear();
+                for(; at < size
+                    && orig_lits[at] != lit_Undef
+                    && orig_lits[at] != lit_Error
+                    ; at++
+                ) {
+                    lits.push_back(orig_lits[at]);
+                }
+                if (weighted) {
+                    const size_t num = lits.size()/2;
+                    weights.clear();
+                    for(size_t i = num; i < lits.size(); i++) weights.push_back(lits[i].toInt());
+                    lits.resize(num);
+                }
+                ret = solver.add_bnn_clause_outside(
+                    lits, cutoff, out, weighted ? &weights : nullptr);
             }
         }
 
@@ -720,6 +855,36 @@ DLL_PUBLIC bool SATSolver::add_clause(const vector< Lit >& lits)
     return ret;
 }
 
+DLL_PUBLIC bool SATSolver::add_clauses(const Lit* lits, const uint64_t* offsets, const size_t num_cls)
+{
+    if (data->log) {
+        for(size_t i = 0; i < num_cls; i++) {
+            for(uint64_t at = offsets[i]; at < offsets[i+1]; at++) (*data->log) << lits[at] << " ";
+            (*data->log) << "0" << endl;
+        }
+    }
+
+    bool ret = true;
+    if (data->solvers.size() > 1) {
+        for(size_t i = 0; i < num_cls; i++) {
+            const uint64_t sz = offsets[i+1] - offsets[i];
+            if (data->cls_lits.size() + sz + 1 > CACHE_SIZE) {
+                ret = actually_add_clauses_to_threads(data);
+            }
+            data->cls_lits.push_back(lit_Undef);
+            data->cls_lits.insert(data->cls_lits.end(), lits + offsets[i], lits + offsets[i+1]);
+        }
+    } else {
+        data->solvers[0]->new_vars(data->vars_to_add);
+        data->vars_to_add = 0;
+
+        ret = data->solvers[0]->add_clauses_outside(lits, offsets, num_cls);
+        data->cls += num_cls;
+    }
+
+    return ret;
+}
+
 void add_xor_clause_to_log(const std::vector<unsigned>& vars, bool rhs, std::ofstream* file)
 {
     if (vars.empty()) {
@@ -781,6 +946,51 @@ DLL_PUBLIC bool SATSolver::add_xor_clause(const std::vector<unsigned>& vars, boo
     return ret;
 }
 
+//Caches a BNN for all threads when multi-threaded. The layout in cls_lits is:
+//lit_Error, Lit(1 or 2 if weighted, has_out), cutoff, [out], lits, [weights]
+//Cutoff and weights are stored raw via Lit::toLit(), they are small enough
+//to never be mistaken for lit_Undef/lit_Error.
+static bool add_bnn_to_threads(
+    CMSatPrivateData* data,
+    const vector<Lit>& lits,
+    int32_t cutoff,
+    const Lit out,
+    const vector<int32_t>* weights)
+{
+    bool ret = true;
+    if (data->solvers.size() > 1) {
+        const size_t sz = 4 + lits.size()*(weights ? 2 : 1);
+        if (data->cls_lits.size() + sz > CACHE_SIZE) {
+            ret = actually_add_clauses_to_threads(data);
+        }
+
+        //Anything at or below 0 is always met, anything above the size never
+        int32_t max_cutoff = lits.size()+1;
+        if (weights) {
+            max_cutoff = 1;
+            for(const int32_t w: *weights) max_cutoff += w;
+        }
+        cutoff = std::max<int32_t>(0, std::min<int32_t>(cutoff, max_cutoff));
+
+        data->cls_lits.push_back(lit_Error);
+        data->cls_lits.push_back(Lit(weights ? 2 : 1, out != lit_Undef));
+        data->cls_lits.push_back(Lit::toLit(cutoff));
+        if (out != lit_Undef) data->cls_lits.push_back(out);
+        for(const Lit l: lits) data->cls_lits.push_back(l);
+        if (weights) {
+            for(const int32_t w: *weights) data->cls_lits.push_back(Lit::toLit(w));
+        }
+    } else {
+        data->solvers[0]->new_vars(data->vars_to_add);
+        data->vars_to_add = 0;
+
+        ret = data->solvers[0]->add_bnn_clause_outside(lits, cutoff, out, weights);
+        data->cls++;
+    }
+
+    return ret;
+}
+
 DLL_PUBLIC bool SATSolver::add_bnn_clause(
     const std::vector<Lit>& lits,
     signed cutoff,
@@ -793,21 +1003,102 @@ DLL_PUBLIC bool SATSolver::add_bnn_clause(
     //lit_Undef is == TRUE, but lit_Error is not accepted
     assert(out != lit_Error);
 
-    bool ret = true;
-    if (data->solvers.size() > 1) {
-        assert(false && "No multithreading for BNN yet");
-    } else {
-        data->solvers[0]->new_vars(data->vars_to_add);
-        data->vars_to_add = 0;
+    return add_bnn_to_threads(data, lits, cutoff, out, nullptr);
+}
 
-        ret = data->solvers[0]->add_bnn_clause_outside(
-            lits,
-            cutoff,
-            out);
-        data->cls++;
+DLL_PUBLIC bool SATSolver::add_pb_clause(
+    const std::vector<Lit>& lits,
+    const std::vector<signed>& weights,
+    signed cutoff,
+    Lit out)
+{
+    if (lits.size() != weights.size()) {
+        const char err[] = "ERROR: add_pb_clause() needs exactly one weight per literal";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
     }
 
-    return ret;
+    //Make all weights positive: w*l == w + (-w)*~l
+    vector<Lit> lits2;
+    vector<int32_t> weights2;
+    int64_t cut = cutoff;
+    int64_t total = 0;
+    bool unit_weights = true;
+    for(size_t i = 0; i < lits.size(); i++) {
+        int64_t w = weights[i];
+        if (w == 0) continue;
+        Lit l = lits[i];
+        if (w < 0) {
+            cut -= w;
+            w = -w;
+            l = ~l;
+        }
+        total += w;
+        if (total >= (1LL << 28)) {
+            const char err[] = "ERROR: the weights in add_pb_clause() must add up to less than 2^28";
+            std::cerr << err << endl;
+            throw std::runtime_error(err);
+        }
+        unit_weights &= (w == 1);
+        lits2.push_back(l);
+        weights2.push_back(w);
+    }
+
+    //Nothing left, it's constant
+    if (lits2.empty() || cut <= 0 || cut > total) {
+        const bool sat = cut <= 0;
+        vector<Lit> cl;
+        if (out != lit_Undef) cl.push_back(sat ? out : ~out);
+        else if (sat) return okay();
+        return add_clause(cl);
+    }
+
+    //Output also among the inputs: split into the two implications
+    //out -> (PB with out=TRUE) and ~out -> ~(PB with out=FALSE)
+    if (out != lit_Undef &&
+        std::any_of(lits2.begin(), lits2.end(), [&](Lit l) {return l.var() == out.var();}))
+    {
+        vector<Lit> rest;
+        vector<signed> rest_w;
+        int64_t k1 = cut;
+        int64_t k0 = cut;
+        int64_t rest_total = 0;
+        for(size_t i = 0; i < lits2.size(); i++) {
+            if (lits2[i] == out) k1 -= weights2[i];
+            else if (lits2[i] == ~out) k0 -= weights2[i];
+            else {
+                rest.push_back(lits2[i]);
+                rest_w.push_back(weights2[i]);
+                rest_total += weights2[i];
+            }
+        }
+        bool ret = true;
+        if (k1 > 0) {
+            vector<Lit> l = rest;
+            vector<signed> w = rest_w;
+            l.push_back(~out);
+            w.push_back(k1);
+            ret &= add_pb_clause(l, w, k1);
+        }
+        k0 = rest_total - k0 + 1;
+        if (k0 > 0) {
+            vector<Lit> l;
+            for(const Lit x: rest) l.push_back(~x);
+            vector<signed> w = rest_w;
+            l.push_back(out);
+            w.push_back(k0);
+            ret &= add_pb_clause(l, w, k0);
+        }
+        return ret;
+    }
+    if (unit_weights) return add_bnn_clause(lits2, cut, out);
+
+    if (data->log) {
+       assert(false && "No logs for BNN yet");
+    }
+    assert(out != lit_Error);
+
+    return add_bnn_to_threads(data, lits2, cut, out, &weights2);
 }
 
 enum class Todo {todo_solve, todo_simplify};
@@ -831,8 +1122,15 @@ struct OneThreadCalc
 
     void operator()()
     {
+        //Pin before adding anything, so the memory of this thread's solver
+        //is first touched, and hence allocated, on the node it runs on
+        if (data_for_thread.pinning != ThreadPinning::none) {
+            data_for_thread.numa->pin_this_thread(data_for_thread.pinning, tid);
+        }
+
+        TRACE_THREAD_NAME("solver " + std::to_string(tid));
+        start_time = cpuTime();
         if (print_thread_start_and_finish) {
-            start_time = cpuTime();
             //data_for_thread.update_mutex->lock();
             //cout << "c Starting thread " << tid << endl;
             //data_for_thread.update_mutex->unlock();
@@ -841,6 +1139,8 @@ struct OneThreadCalc
         //Add clauses and variables
         OneThreadAddCls cls_adder(data_for_thread, tid);
         cls_adder();
+        const uint64_t start_confl = data_for_thread.solvers[tid]->sumConflicts;
+        const double start_search_time = cpuTime();
 
         //Solve or simplify
         lbool ret;
@@ -854,6 +1154,9 @@ struct OneThreadCalc
 
         assert(data_for_thread.cpu_times.size() > tid);
         data_for_thread.cpu_times[tid] = cpuTime();
+        data_for_thread.confl_per_sec[tid] = float_div(
+            data_for_thread.solvers[tid]->sumConflicts - start_confl,
+            data_for_thread.cpu_times[tid] - start_search_time);
         if (print_thread_start_and_finish) {
             data_for_thread.update_mutex->lock();
             std::ios::fmtflags f(cout.flags());
@@ -868,6 +1171,9 @@ struct OneThreadCalc
 
         if (ret != l_Undef) {
             data_for_thread.update_mutex->lock();
+            if (data_for_thread.answer_found_at < 0) {
+                data_for_thread.answer_found_at = real_time_sec();
+            }
             *data_for_thread.which_solved = tid;
             *data_for_thread.ret = ret;
             //will interrupt all of them
@@ -883,6 +1189,330 @@ struct OneThreadCalc
     bool only_sampling_solution;
 };
 
+//Shared state of a cube-and-conquer solve() call. During the call every
+//solver has its own interrupt flag, since a solver sets its flag when its
+//solve() returns, which would otherwise stop all the other cubes too
+struct CubeQueue
+{
+    explicit CubeQueue(size_t num_threads) :
+        interrupt(num_threads)
+    {
+        for(auto& f: interrupt) f.store(false, std::memory_order_relaxed);
+    }
+
+    //Must hold mu
+    void finish()
+    {
+        done = true;
+        for(auto& f: interrupt) f.store(true, std::memory_order_relaxed);
+        cv.notify_all();
+    }
+
+    std::mutex mu;
+    std::condition_variable cv;
+    std::deque<vector<Lit>> todo;
+    vector<std::atomic<bool>> interrupt;
+    bool splitting = true; //thread 0 has not made the cubes yet
+    uint32_t busy = 0; //threads working on a cube
+    uint32_t idle = 0; //threads waiting for a cube
+    bool done = false;
+    bool all_refuted = false;
+    lbool ret = l_Undef;
+    int which_solved = -1;
+
+    //Negated assumptions the conflicts of the refuted cubes used
+    vector<Lit> conflict;
+
+    //stats
+    size_t num_cubes = 0;
+    uint64_t num_lookahead_failed = 0;
+    uint64_t num_splits = 0;
+    uint64_t num_refuted = 0;
+};
+
+struct OneThreadCube
+{
+    OneThreadCube(
+        DataForThread& _data_for_thread,
+        CMSatPrivateData* _data,
+        CubeQueue& _q,
+        size_t _tid,
+        const vector<Lit>& _assumps,
+        bool _only_sampling_solution,
+        uint64_t _max_confl,
+        double _max_time
+    ) :
+        data_for_thread(_data_for_thread)
+        , data(_data)
+        , q(_q)
+        , tid(_tid)
+        , assumps(_assumps)
+        , only_sampling_solution(_only_sampling_solution)
+        , max_confl(_max_confl)
+        , max_time(_max_time)
+    {}
+
+    void operator()()
+    {
+        //Pin before adding anything, as in OneThreadCalc
+        if (data->pinning != ThreadPinning::none) {
+            data->numa->pin_this_thread(data->pinning, tid);
+        }
+        TRACE_THREAD_NAME("cube solver " + std::to_string(tid));
+
+        OneThreadAddCls cls_adder(data_for_thread, tid);
+        cls_adder();
+
+        Solver& s = *data->solvers[tid];
+        const uint64_t start_confl = s.sumConflicts;
+        const double start_time = cpuTime();
+        if (tid == 0) make_cubes(s);
+        solve_cubes(s);
+
+        data->cpu_times[tid] = cpuTime();
+        data->confl_per_sec[tid] = float_div(
+            s.sumConflicts - start_confl, data->cpu_times[tid] - start_time);
+    }
+
+    //Thread 0 first searches a little, so the problem is simplified and
+    //VSIDS scores mean something, then splits it into cubes by lookahead.
+    //The other threads wait meanwhile
+    void make_cubes(Solver& s)
+    {
+        s.conf.max_confl = std::min(max_confl, s.sumConflicts + s.conf.cube_warmup_confl);
+        lbool ret = s.solve_with_assumptions(&assumps, only_sampling_solution);
+
+        std::unique_lock<std::mutex> lock(q.mu);
+        if (q.done) return;
+        if (ret != l_Undef || s.sumConflicts >= max_confl || cpuTime() >= max_time) {
+            q.ret = ret;
+            q.which_solved = tid;
+            q.finish();
+            return;
+        }
+        s.unset_must_interrupt_asap();
+        lock.unlock();
+
+        vector<vector<Lit>> cubes;
+        s.conf.maxTime = max_time;
+        CubeFinder finder(&s);
+        const bool found = finder.find(assumps, s.conf.cube_depth, cubes);
+
+        lock.lock();
+        q.num_lookahead_failed = finder.get_num_failed();
+        if (q.done) return;
+        if (cpuTime() >= max_time) {
+            q.finish();
+            return;
+        }
+        if (!found || cubes.empty()) {
+            //Nothing to split, finish it here
+            lock.unlock();
+            if (!s.okay()) {
+                ret = l_False;
+            } else {
+                s.conf.max_confl = max_confl;
+                s.conf.maxTime = max_time;
+                ret = s.solve_with_assumptions(&assumps, only_sampling_solution);
+            }
+            lock.lock();
+            if (q.done) return;
+            q.ret = ret;
+            q.which_solved = tid;
+            q.finish();
+            return;
+        }
+        q.todo.insert(q.todo.end(), cubes.begin(), cubes.end());
+        q.num_cubes = cubes.size();
+        q.splitting = false;
+        q.cv.notify_all();
+    }
+
+    //Solves the cubes from the queue as extra assumptions
+    void solve_cubes(Solver& s)
+    {
+        vector<Lit> cube;
+        vector<Lit> lits;
+        bool have_cube = false;
+        uint64_t budget = 0;
+
+        std::unique_lock<std::mutex> lock(q.mu);
+        while(!q.done) {
+            if (!have_cube) {
+                if (q.todo.empty()) {
+                    if (q.busy == 0 && !q.splitting) {
+                        q.all_refuted = true;
+                        q.finish();
+                        break;
+                    }
+                    q.idle++;
+                    q.cv.wait(lock);
+                    q.idle--;
+                    continue;
+                }
+                cube = std::move(q.todo.front());
+                q.todo.pop_front();
+                q.busy++;
+                have_cube = true;
+                budget = s.conf.cube_confl_budget;
+            }
+            //Under the lock, so a finish() cannot be missed
+            s.unset_must_interrupt_asap();
+            lock.unlock();
+
+            lits = assumps;
+            lits.insert(lits.end(), cube.begin(), cube.end());
+            s.conf.maxTime = max_time;
+            s.conf.max_confl = std::min(max_confl, s.sumConflicts + budget);
+            const lbool ret = s.solve_with_assumptions(&lits, only_sampling_solution);
+
+            lock.lock();
+            if (q.done) break;
+            if (ret == l_True
+                || (ret == l_False && (!s.okay() || !uses_cube(s.get_final_conflict(), cube)))
+            ) {
+                q.ret = ret;
+                q.which_solved = tid;
+                q.finish();
+                break;
+            }
+
+            if (ret == l_False) {
+                for(const Lit l: s.get_final_conflict()) {
+                    if (std::find(cube.begin(), cube.end(), ~l) == cube.end()) {
+                        q.conflict.push_back(l);
+                    }
+                }
+                q.num_refuted++;
+                q.busy--;
+                have_cube = false;
+                continue;
+            }
+
+            //Out of budget. Give half of the cube to an idle thread, or go on
+            if (s.sumConflicts >= max_confl || cpuTime() >= max_time) {
+                q.finish();
+                break;
+            }
+            const Lit l = q.idle > 0 ? pick_split_lit(s, lits) : lit_Undef;
+            if (l != lit_Undef) {
+                q.todo.push_back(cube);
+                q.todo.back().push_back(~l);
+                cube.push_back(l);
+                q.num_splits++;
+                q.cv.notify_all();
+                budget = s.conf.cube_confl_budget;
+            } else {
+                budget *= 2;
+            }
+        }
+    }
+
+    static bool uses_cube(const vector<Lit>& conflict, const vector<Lit>& cube)
+    {
+        for(const Lit l: conflict) {
+            if (std::find(cube.begin(), cube.end(), ~l) != cube.end()) return true;
+        }
+        return false;
+    }
+
+    //Highest VSIDS variable of the problem that is not assumed yet
+    Lit pick_split_lit(const Solver& s, const vector<Lit>& in_use) const
+    {
+        const vector<double> scores = s.get_vsids_scores();
+        vector<uint8_t> used(scores.size(), 0);
+        for(const Lit l: in_use) used[l.var()] = 1;
+
+        uint32_t best = var_Undef;
+        for(uint32_t v = 0; v < data->total_num_vars && v < scores.size(); v++) {
+            if (used[v]) continue;
+            if (best == var_Undef || scores[v] > scores[best]) best = v;
+        }
+        if (best == var_Undef) return lit_Undef;
+        return Lit(best, false);
+    }
+
+    DataForThread& data_for_thread;
+    CMSatPrivateData* data;
+    CubeQueue& q;
+    const size_t tid;
+    const vector<Lit>& assumps;
+    const bool only_sampling_solution;
+    const uint64_t max_confl;
+    const double max_time;
+};
+
+//Thread 0 splits the problem into cubes, see OneThreadCube::make_cubes().
+//The cubes are solved as extra assumptions by all threads from a shared
+//queue. A thread that runs out of budget on a cube splits it on its highest
+//VSIDS variable if another thread is idle (work stealing). Learnt units and
+//binaries are exchanged through SharedData as in the portfolio mode
+static lbool cube_and_conquer(
+    const vector<Lit>* assumptions,
+    CMSatPrivateData* data,
+    bool only_sampling_solution
+) {
+    const vector<Lit> assumps = assumptions ? *assumptions : vector<Lit>();
+    const size_t num_threads = data->solvers.size();
+    Solver& s0 = *data->solvers[0];
+    const double max_time = s0.conf.maxTime;
+
+    CubeQueue q(num_threads);
+    for(size_t i = 0; i < num_threads; i++) {
+        data->solvers[i]->set_must_interrupt_inter_asap_ptr(&q.interrupt[i]);
+    }
+
+    //Every thread adds the clauses to its own solver
+    DataForThread data_for_thread(data, assumptions);
+    vector<thread> thds;
+    for(size_t i = 0; i < num_threads; i++) {
+        thds.push_back(thread(OneThreadCube(
+            data_for_thread, data, q, i, assumps, only_sampling_solution,
+            data->solvers[i]->conf.max_confl, max_time)));
+    }
+    {
+        //Pass on interrupt_asap() to the threads, also during the split
+        std::unique_lock<std::mutex> lock(q.mu);
+        while(!q.done) {
+            q.cv.wait_for(lock, std::chrono::milliseconds(10));
+            if (data->must_interrupt->load(std::memory_order_relaxed)) q.finish();
+        }
+    }
+    for(std::thread& t: thds) t.join();
+    for(Solver* s: data->solvers) {
+        s->set_must_interrupt_inter_asap_ptr(data->must_interrupt);
+    }
+    data->cls_lits.clear();
+    data->vars_to_add = 0;
+
+    if (s0.conf.verbosity) {
+        cout << "c [cube] cubes: " << q.num_cubes
+        << " splits: " << q.num_splits
+        << " refuted: " << q.num_refuted
+        << " result: " << (q.all_refuted ? l_False : q.ret)
+        << endl;
+    }
+
+    if (!q.all_refuted) {
+        data->which_solved = std::max(q.which_solved, 0);
+        return q.ret;
+    }
+
+    //Every cube was refuted. If lookahead refuted some part of the search
+    //space, we do not know which assumptions that used, so take all of them
+    data->which_solved = 0;
+    s0.conflict.clear();
+    std::sort(q.conflict.begin(), q.conflict.end());
+    for(const Lit a: assumps) {
+        if (q.num_lookahead_failed > 0
+            || std::binary_search(q.conflict.begin(), q.conflict.end(), ~a)
+        ) {
+            s0.conflict.push_back(~a);
+        }
+    }
+    return l_False;
+}
+
 lbool calc(
     const vector< Lit >* assumptions,
     Todo todo,
@@ -900,6 +1530,7 @@ lbool calc(
 
     //Reset the interrupt signal if it was set
     data->must_interrupt->store(false, std::memory_order_relaxed);
+    MetricsDumper metrics_dumper(data);
 
     //Set timeout information
     if (data->timeout != numeric_limits<double>::max()) {
@@ -938,10 +1569,23 @@ lbool calc(
         }
         data->okay = data->solvers[0]->okay();
         data->cpu_times[0] = cpuTime();
+        if (ret != l_Undef) data->thread_wins[0]++;
 	data->solvers[0]->conclude_idrup(ret);
         return ret;
     }
 
+    //Multi-threaded cube-and-conquer
+    if (todo == Todo::todo_solve && data->solvers[0]->conf.cube_depth > 0) {
+        const lbool ret = cube_and_conquer(assumptions, data, only_sampling_solution);
+        data->solvers[0]->unset_must_interrupt_asap();
+        data->okay = data->solvers[data->which_solved]->okay();
+        if (ret == l_False && (assumptions == nullptr || assumptions->empty())) {
+            data->okay = false;
+        }
+        if (ret != l_Undef) data->thread_wins[data->which_solved]++;
+        return ret;
+    }
+
     //Multi-threaded case
     DataForThread data_for_thread(data, assumptions);
     vector<thread> thds;
@@ -953,6 +1597,10 @@ lbool calc(
         t.join();
     }
     lbool real_ret = *data_for_thread.ret;
+    if (data_for_thread.answer_found_at >= 0) {
+        data->last_answer_to_return = real_time_sec() - data_for_thread.answer_found_at;
+        data->max_answer_to_return = std::max(data->max_answer_to_return, data->last_answer_to_return);
+    }
 
     //This does it for all of them, there is only one must-interrupt
     data_for_thread.solvers[0]->unset_must_interrupt_asap();
@@ -961,6 +1609,7 @@ lbool calc(
     data->cls_lits.clear();
     data->vars_to_add = 0;
     data->okay = data->solvers[*data_for_thread.which_solved]->okay();
+    if (real_ret != l_Undef) data->thread_wins[*data_for_thread.which_solved]++;
     return real_ret;
 }
 
@@ -985,6 +1634,54 @@ DLL_PUBLIC lbool SATSolver::solve(const vector< Lit >* assumptions, bool only_sa
     return calc(assumptions, Todo::todo_solve, data, only_sampling_solution);
 }
 
+DLL_PUBLIC lbool SATSolver::enumerate_solutions(
+    const std::function<bool(const vector<lbool>& model)>& callback,
+    uint64_t max_sols,
+    const vector<Lit>* assumptions,
+    bool only_sampling_solution)
+{
+    if (max_sols == 0) return l_True;
+
+    //Block solutions and continue inside the search, if we can
+    Solver& s = *data->solvers[0];
+    if (data->solvers.size() == 1
+        && data->log == nullptr
+        && !s.frat->enabled()
+        && !s.conf.simulate_frat
+    ) {
+        Solver::EnumState st;
+        st.callback = &callback;
+        st.max_sols = max_sols;
+        s.enum_state = &st;
+        const lbool ret = solve(assumptions, only_sampling_solution);
+        s.enum_state = nullptr;
+        return ret;
+    }
+
+    //Otherwise ban the solutions one-by-one from the outside
+    uint64_t num_found = 0;
+    vector<Lit> ban;
+    while(true) {
+        const lbool ret = solve(assumptions, only_sampling_solution);
+        if (ret != l_True) return ret;
+        num_found++;
+        if (!callback(get_model()) || num_found >= max_sols) return l_True;
+
+        ban.clear();
+        const vector<lbool>& model = get_model();
+        if (get_sampl_vars_set()) {
+            for(const uint32_t var: get_sampl_vars()) {
+                if (model[var] != l_Undef) ban.push_back(Lit(var, model[var] == l_True));
+            }
+        } else {
+            for(uint32_t var = 0; var < nVars(); var++) {
+                if (model[var] != l_Undef) ban.push_back(Lit(var, model[var] == l_True));
+            }
+        }
+        add_clause(ban);
+    }
+}
+
 DLL_PUBLIC lbool SATSolver::simplify(const vector< Lit >* assumptions, const string* strategy)
 {
     if (data->promised_single_call
@@ -1116,6 +1813,76 @@ DLL_PUBLIC void SATSolver::print_stats(double wallclock_time_started) const
     }
 
     data->solvers[data->which_solved]->print_stats(cpu_time, cpu_time_total, wallclock_time_started);
+    if (data->solvers.size() > 1) {
+        print_stats_line("c answer-to-return time"
+            , data->last_answer_to_return, "s"
+            , data->max_answer_to_return, "s max");
+        for(size_t i = 0; i < data->solvers.size(); i++) {
+            print_stats_line("c thread " + std::to_string(i) + " wins"
+                , data->thread_wins[i]
+                , "profile " + data->portfolio.profile_name(i));
+            print_stats_line("c thread " + std::to_string(i) + " confl/s"
+                , data->confl_per_sec[i]);
+        }
+    }
+}
+
+DLL_PUBLIC void SATSolver::set_portfolio(const std::string& portfolio)
+{
+    if (data->solvers.size() > 1) {
+        const char err[] = "ERROR: You must call set_portfolio() before set_num_threads()";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    std::istringstream in(portfolio);
+    data->portfolio.parse(in);
+}
+
+DLL_PUBLIC void SATSolver::set_portfolio_file(const std::string& fname)
+{
+    if (data->solvers.size() > 1) {
+        const char err[] = "ERROR: You must call set_portfolio_file() before set_num_threads()";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    data->portfolio.parse_file(fname);
+}
+
+DLL_PUBLIC unsigned SATSolver::get_portfolio_size() const
+{
+    return data->portfolio.size();
+}
+
+DLL_PUBLIC const std::vector<uint64_t>& SATSolver::get_thread_wins() const
+{
+    return data->thread_wins;
+}
+
+DLL_PUBLIC double SATSolver::get_last_answer_to_return_time() const
+{
+    return data->last_answer_to_return;
+}
+
+DLL_PUBLIC void SATSolver::set_thread_pinning(const std::string& mode)
+{
+    data->pinning = thread_pinning_from_string(mode);
+    if (data->pinning != ThreadPinning::none && data->numa == nullptr) {
+        data->numa = new NumaTopology;
+    }
+}
+
+DLL_PUBLIC void SATSolver::set_cube_and_conquer(unsigned depth)
+{
+    for(Solver* s: data->solvers) {
+        s->conf.cube_depth = depth;
+    }
+}
+
+DLL_PUBLIC unsigned SATSolver::get_num_numa_nodes() const
+{
+    if (data->numa) return data->numa->num_nodes();
+    NumaTopology numa;
+    return numa.num_nodes();
 }
 
 DLL_PUBLIC void SATSolver::set_find_xors(bool do_find_xors)
@@ -1326,6 +2093,15 @@ bool DLL_PUBLIC SATSolver::get_next_constraint(std::vector<Lit>& out, bool& is_x
     return data->solvers[0]->get_next_constraint(out, is_xor, rhs);
 }
 
+size_t DLL_PUBLIC SATSolver::get_next_constraints(
+    Lit* lits, size_t lits_cap,
+    size_t* offsets, size_t max_constraints,
+    uint8_t* flags)
+{
+    assert(!data->solvers.empty());
+    return data->solvers[0]->get_next_constraints(lits, lits_cap, offsets, max_constraints, flags);
+}
+
 void DLL_PUBLIC SATSolver::end_getting_constraints()
 {
     assert(!data->solvers.empty());
@@ -1661,27 +2437,52 @@ void into_rhs(vector<Lit>& lits, bool rhs) {
 
 DLL_PUBLIC void SATSolver::open_file_and_dump_irred_clauses(const char* fname)
 {
+    //The header needs the counts, so the constraints are gone through twice
+    const size_t max_cls = 1ULL << 16;
+    vector<Lit> lits(std::max<size_t>(nVars(), 1ULL << 20));
+    vector<size_t> offsets(max_cls+1);
+    vector<uint8_t> flags(max_cls);
+
     start_getting_constraints(false);
-    uint32_t num_cls = 0;
-    int32_t max_vars = -1;
-    vector<Lit> lits; bool is_xor; bool rhs;
-    while (true) {
-        bool ret = get_next_constraint(lits, is_xor, rhs);
-        if (!ret) break;
-        num_cls++;
-        for(const Lit l: lits) {
-            if ((int32_t)l.var() > max_vars) max_vars = (int32_t)l.var();
+    uint64_t num_cls = 0;
+    uint32_t num_vars = 0;
+    size_t n;
+    while ((n = get_next_constraints(lits.data(), lits.size(), offsets.data(), max_cls, flags.data())) > 0) {
+        num_cls += n;
+        for(size_t i = 0; i < offsets[n]; i++) {
+            num_vars = std::max(num_vars, lits[i].var()+1);
         }
     }
+    end_getting_constraints();
 
     std::ofstream f(fname);
-    f << "p cnf " << max_vars << " " << num_cls << endl;
-    while (true) {
-        bool ret = get_next_constraint(lits, is_xor, rhs);
-        if (!ret) break;
-        if (is_xor) {into_rhs(lits, rhs); f << "x " << lits << " 0\n";}
-        else f << lits << " 0\n";
+    f << "p cnf " << num_vars << " " << num_cls << endl;
+    start_getting_constraints(false);
+    vector<Lit> cl;
+    while ((n = get_next_constraints(lits.data(), lits.size(), offsets.data(), max_cls, flags.data())) > 0) {
+        for(size_t i = 0; i < n; i++) {
+            cl.assign(lits.begin()+offsets[i], lits.begin()+offsets[i+1]);
+            if (flags[i] & 1) {into_rhs(cl, flags[i] & 2); f << "x " << cl << " 0\n";}
+            else f << cl << " 0\n";
+        }
     }
+    end_getting_constraints();
+}
+
+DLL_PUBLIC void SATSolver::open_file_and_dump_irred_clauses_binary(const char* fname)
+{
+    BinaryCnfWriter w;
+    w.new_vars(nVars());
+    start_getting_constraints(false);
+    vector<Lit> lits; bool is_xor; bool rhs;
+    while (get_next_constraint(lits, is_xor, rhs)) {
+        if (is_xor) w.add_xor_clause(lits, rhs);
+        else w.add_clause(lits);
+    }
+    end_getting_constraints();
+    if (get_sampl_vars_set()) w.set_sampl_vars(get_sampl_vars());
+    if (get_opt_sampl_vars_set()) w.set_opt_sampl_vars(get_opt_sampl_vars());
+    w.write(fname);
 }
 
 DLL_PUBLIC void SATSolver::set_pred_short_size(int32_t sz)
@@ -1851,6 +2652,69 @@ DLL_PUBLIC void SATSolver::set_oracle_removed_is_learnt(bool val) {
     s.conf.oracle_removed_is_learnt = val;
 }
 
+DLL_PUBLIC void SATSolver::set_oracle_vivif_threads(uint32_t num) {
+    if (num == 0) {
+        const char err[] = "ERROR: Oracle vivification needs at least one thread";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    Solver& s = *data->solvers[0];
+    s.conf.oracle_vivif_threads = num;
+}
+
+DLL_PUBLIC std::string SATSolver::get_metrics_json() const
+{
+    return metrics_json(data);
+}
+
+DLL_PUBLIC void SATSolver::set_metrics_file(const std::string& fname, double every_secs)
+{
+    if (!(every_secs > 0)) {
+        const char err[] = "ERROR: Metrics must be dumped at a positive interval";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    std::ofstream* f = new std::ofstream(fname.c_str());
+    if (!*f) {
+        delete f;
+        const string err = "ERROR: Cannot open metrics file '" + fname + "' for writing";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    delete data->metrics_file;
+    data->metrics_file = f;
+    data->metrics_every = every_secs;
+}
+
+DLL_PUBLIC bool SATSolver::dump_trace(const std::string& fname) const
+{
+    #ifdef CMS_TRACE
+    Tracer::dump(fname);
+    return true;
+    #else
+    (void)fname;
+    return false;
+    #endif
+}
+
+DLL_PUBLIC void SATSolver::save_state(const std::string& fname)
+{
+    actually_add_clauses_to_threads(data);
+    data->solvers[0]->save_state(fname);
+}
+
+DLL_PUBLIC void SATSolver::load_state(const std::string& fname)
+{
+    if (data->total_num_vars != 0) {
+        const char err[] = "ERROR: load_state() must be called before any variable is added";
+        std::cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    for(Solver* s: data->solvers) s->load_state(fname);
+    data->total_num_vars = data->solvers[0]->nVarsOuter();
+    data->okay = data->solvers[0]->okay();
+}
+
 // Weight stuff
 DLL_PUBLIC bool SATSolver::get_weighted() const {
     const Solver& s = *data->solvers[0];
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include <string>
 #include <limits>
 #include <cstdio>
+#include <functional>
 #include "solvertypesmini.h"
 
 namespace CMSat {
@@ -60,6 +61,7 @@ namespace CMSat {
         void new_vars(const size_t n); //and many new variables to the solver -- much faster
         unsigned nVars() const; //get number of variables inside the solver
         bool add_clause(const std::vector<Lit>& lits);
+        bool add_clauses(const Lit* lits, const uint64_t* offsets, size_t num_cls); //Add num_cls clauses at once, clause i being lits[offsets[i]] .. lits[offsets[i+1]-1]
         bool add_red_clause(const std::vector<Lit>& lits);
         bool add_xor_clause(const std::vector<unsigned>& vars, bool rhs);
         bool add_xor_clause(const std::vector<Lit>& lits, bool rhs = true);
@@ -68,6 +70,13 @@ namespace CMSat {
             signed cutoff,
             Lit out = lit_Undef
         );
+        //sum of weights[i]*lits[i] >= cutoff, optionally <-> out. Weights may be negative
+        bool add_pb_clause(
+            const std::vector<Lit>& lits,
+            const std::vector<signed>& weights,
+            signed cutoff,
+            Lit out = lit_Undef
+        );
         void set_lit_weight(Lit lit, double weight);
 
         ////////////////////////////
@@ -75,8 +84,21 @@ namespace CMSat {
         // You can call solve() multiple times: incremental mode is supported!
         ////////////////////////////
 
-        lbool solve(const std::vector<Lit>* assumptions = nullptr, bool only_indep_solution = false); //solve the problem, optionally with assumptions. If only_indep_solution is set, only the independent variables set with set_independent_vars() are returned in the solution
+        lbool solve(const std::vector<Lit>* assumptions = nullptr, bool only_indep_solution = false); //solve the problem, optionally with assumptions. If only_indep_solution is set, only the independent variables set with set_independent_vars() are returned in the solution. Assumptions shared as a prefix with the previous call are not re-propagated, unless clauses or variables were added or simplify() was called in between
         lbool simplify(const std::vector<Lit>* assumptions = nullptr, const std::string* strategy = nullptr); //simplify the problem, optionally with assumptions
+
+        // Enumerates the solutions, projected on the sampling vars if set_sampl_vars()
+        // has been called, and on all variables otherwise. Each solution is passed to
+        // the callback, which returns false to stop the enumeration. Every solution
+        // passed to the callback except the last is blocked by a permanent clause.
+        // Returns l_False once all solutions have been found, l_True if the callback
+        // or max_sols stopped it (get_model() is then the last solution), and
+        // l_Undef if a time/conflict limit was reached or the solver was interrupted
+        lbool enumerate_solutions(
+            const std::function<bool(const std::vector<lbool>& model)>& callback,
+            uint64_t max_sols = std::numeric_limits<uint64_t>::max(),
+            const std::vector<Lit>* assumptions = nullptr,
+            bool only_sampling_solution = false);
         const std::vector<lbool>& get_model() const; //get model that satisfies the problem. Only makes sense if previous solve()/simplify() call was l_True
         const std::vector<Lit>& get_conflict() const; //get conflict in terms of the assumptions given in case the previous call to solve() was l_False
         bool okay() const; //the problem is still solveable, i.e. the empty clause hasn't been derived
@@ -103,6 +125,14 @@ namespace CMSat {
         ////////////////////////////
 
         void set_num_threads(unsigned n); //Number of threads to use. Must be set before any vars/clauses are added
+        void set_portfolio(const std::string& portfolio); //Per-thread configuration: one line per thread of space-separated "field=value" SolverConf overrides, optionally "builtin=N" to start from the N-th built-in thread setup and "name=X". '#' starts a comment. Must be called before set_num_threads(). Throws std::runtime_error if malformed
+        void set_portfolio_file(const std::string& fname); //Same as set_portfolio(), but reads the portfolio from a file
+        unsigned get_portfolio_size() const; //Number of profiles in the portfolio, 0 if none is set
+        const std::vector<uint64_t>& get_thread_wins() const; //For each thread, the number of solve()/simplify() calls it finished first
+        void set_thread_pinning(const std::string& mode); //"none" (default), "core" or "node". Pins thread i to one core, or to all cores of NUMA node (i % nodes), at the start of every multi-threaded solve()/simplify(). The thread's solver memory is then allocated on that node by first-touch. Linux only, ignored elsewhere
+        unsigned get_num_numa_nodes() const; //Number of NUMA nodes we can run on, 1 if unknown
+        void set_cube_and_conquer(unsigned depth); //With multiple threads, solve() splits the problem by lookahead into at most 2^depth cubes and solves them as extra assumptions on a work-stealing pool of threads, instead of racing the threads on the whole problem. Aimed at hard UNSAT problems. 0 (default) turns it off
+        double get_last_answer_to_return_time() const; //Wall time (s) between a thread finding the answer of the last multi-threaded solve()/simplify() and all threads stopping
         void set_allow_otf_gauss(); //allow on-the-fly gaussian elimination
         /**
          * CPU time (in seconds) that can be consumed before the next call to solve() must return
@@ -160,6 +190,7 @@ namespace CMSat {
         void set_orig_global_timeout_multiplier(const double mult);
         void set_oracle_get_learnts(bool val);
         void set_oracle_removed_is_learnt(bool val);
+        void set_oracle_vivif_threads(uint32_t num);
         double get_orig_global_timeout_multiplier();
         bool minimize_clause(std::vector<Lit>& cl);
 
@@ -209,6 +240,11 @@ namespace CMSat {
         void add_empty_cl_to_frat(); // allows to treat SAT as UNSAT and perform learning
         void interrupt_asap(); //call this asynchronously, and the solver will try to cleanly abort asap
         void add_in_partial_solving_stats(); //used only by Ctrl+C handler. Ignore.
+        std::string get_metrics_json() const; //Live conflicts/propagations/decisions/restarts, memory per subsystem, reduceDB and inprocessing pause histograms and thread sync counts, summed over all threads, as one line of JSON. Lock-free, may be polled from another thread during solve()/simplify()
+        bool dump_trace(const std::string& fname) const; //Write the events recorded so far by all threads as Chrome trace-event JSON (chrome://tracing, Perfetto). Returns false if the library was built without tracing (cmake -DTRACE_EVENTS=ON). Call only when no solve()/simplify() is running. Throws std::runtime_error if the file cannot be opened
+        void set_metrics_file(const std::string& fname, double every_secs = 1.0); //Write get_metrics_json() to fname as JSON lines, every every_secs wall-clock seconds during solve()/simplify() and once at their end. Throws std::runtime_error if the file cannot be opened
+        void save_state(const std::string& fname); //Checkpoint the state of the first thread to fname: irredundant and learnt clauses, XORs, variable activities and phases, equivalences and eliminated clauses. Call only when no solve()/simplify() is running. Not supported with FRAT, BVA or BNN constraints. Throws std::runtime_error on failure
+        void load_state(const std::string& fname); //Resume from a file written by save_state(). Must be called before any variable or clause is added. Throws std::runtime_error if the file cannot be read or is corrupt
 
         ////////////////////////////
         // Extract useful information from the solver
@@ -255,6 +291,21 @@ namespace CMSat {
                uint32_t max_len = std::numeric_limits<uint32_t>::max(),
                uint32_t max_glue = std::numeric_limits<uint32_t>::max());
         bool get_next_constraint(std::vector<Lit>& ret, bool& is_xor, bool& rhs);
+        // Bulk version of get_next_constraint(), with no allocation per constraint.
+        // Copies the next constraints back to back into `lits` while they fit
+        // into `lits_cap` literals and `max_constraints` constraints, and
+        // returns how many it copied. 0 means there are no more constraints.
+        // * Constraint i is lits[offsets[i]] ... lits[offsets[i+1]-1], so
+        //   `offsets` must have room for max_constraints+1 entries
+        // * flags[i] is 0 for a clause. For an XOR, bit 0 is set and bit 1 is
+        //   the RHS. `flags` may be nullptr if there are no XORs
+        // * Throws std::runtime_error if the next constraint can never be
+        //   copied: it is longer than `lits_cap` (nVars() is always enough),
+        //   or it is an XOR and `flags` is nullptr
+        size_t get_next_constraints(
+            Lit* lits, size_t lits_cap,
+            size_t* offsets, size_t max_constraints,
+            uint8_t* flags = nullptr);
         void end_getting_constraints();
 
         uint32_t simplified_nvars();
@@ -269,6 +320,7 @@ namespace CMSat {
         /////////////////////
         // Backwards compatibility, implemented using the above "small clauses" functions
         void open_file_and_dump_irred_clauses(const char* fname);
+        void open_file_and_dump_irred_clauses_binary(const char* fname); //Same, in the binary CNF format of src/binarycnf.h. Throws std::runtime_error if the file cannot be written
         bool removed_var(uint32_t var) const;
 
 #ifdef WEIGHTED
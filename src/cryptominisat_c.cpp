@@ -24,6 +24,11 @@ THE SOFTWARE.
 #include "constants.h"
 #include "cryptominisat.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
 
 // C wrappers for SATSolver so that it can be used from other languages (e.g. Rust)
 using namespace CMSat;
@@ -38,6 +43,10 @@ const Lit* fromc(const c_Lit* x)
 {
     return reinterpret_cast<const Lit*>(x);
 }
+Lit* fromc(c_Lit* x)
+{
+    return reinterpret_cast<Lit*>(x);
+}
 const lbool* fromc(const c_lbool* x)
 {
     return reinterpret_cast<const lbool*>(x);
@@ -67,6 +76,39 @@ Dest unwrap(const std::vector<T>& vec)
     return Dest {toc(vec.data()), vec.size()};
 }
 
+// Parses 0-terminated DIMACS literals into lits/offsets as taken by
+// SATSolver::add_clauses(), and creates the variables not yet in the solver.
+// Returns false, touching nothing, if the buffer is not valid
+static bool from_dimacs(
+    SATSolver* self, const int32_t* in, size_t num,
+    std::vector<Lit>& lits, std::vector<uint64_t>& offsets)
+{
+    if (num > 0 && in[num-1] != 0) {
+        std::cerr << "ERROR: last clause of the buffer is not terminated by 0" << std::endl;
+        return false;
+    }
+    lits.clear();
+    lits.reserve(num);
+    offsets.clear();
+    offsets.push_back(0);
+    uint32_t max_var = 0;
+    for(size_t i = 0; i < num; i++) {
+        if (in[i] == 0) {
+            offsets.push_back(lits.size());
+            continue;
+        }
+        const uint32_t var = (in[i] < 0 ? -(int64_t)in[i] : in[i]) - 1;
+        if (var >= (1ULL<<28)) {
+            std::cerr << "ERROR: variable " << var+1 << " is too large" << std::endl;
+            return false;
+        }
+        max_var = std::max(max_var, var+1);
+        lits.push_back(Lit(var, in[i] < 0));
+    }
+    if (max_var > self->nVars()) self->new_vars(max_var - self->nVars());
+    return true;
+}
+
 #define NOEXCEPT_START noexcept { try {
 #define NOEXCEPT_END } catch(...) { \
     std::cerr << "ERROR: exception thrown past FFI boundary" << std::endl;\
@@ -92,6 +134,31 @@ extern "C"
         return self->add_clause(wrap(fromc(lits), num_lits));
     } NOEXCEPT_END
 
+    DLL_PUBLIC bool cmsat_add_clauses(SATSolver* self, const int32_t* lits, size_t num_lits) NOEXCEPT_START {
+        std::vector<Lit> cls;
+        std::vector<uint64_t> offsets;
+        if (!from_dimacs(self, lits, num_lits, cls, offsets)) return false;
+        return self->add_clauses(cls.data(), offsets.data(), offsets.size()-1);
+    } NOEXCEPT_END
+
+    DLL_PUBLIC bool cmsat_add_xor_clauses(SATSolver* self, const int32_t* lits, size_t num_lits) NOEXCEPT_START {
+        std::vector<Lit> xors;
+        std::vector<uint64_t> offsets;
+        if (!from_dimacs(self, lits, num_lits, xors, offsets)) return false;
+        std::vector<uint32_t> vars;
+        bool ret = true;
+        for(size_t i = 0; i+1 < offsets.size(); i++) {
+            vars.clear();
+            bool rhs = true;
+            for(uint64_t at = offsets[i]; at < offsets[i+1]; at++) {
+                vars.push_back(xors[at].var());
+                rhs ^= xors[at].sign();
+            }
+            ret = self->add_xor_clause(vars, rhs);
+        }
+        return ret;
+    } NOEXCEPT_END
+
     DLL_PUBLIC bool cmsat_add_xor_clause(SATSolver* self, const unsigned* vars, size_t num_vars, bool rhs) NOEXCEPT_START {
         return self->add_xor_clause(wrap(vars, num_vars), rhs);
     } NOEXCEPT_END
@@ -109,6 +176,23 @@ extern "C"
         return toc(self->solve(&temp));
     } NOEXCEPT_END
 
+    DLL_PUBLIC void cmsat_solve_with_assumptions_batch(
+        SATSolver* self, const int32_t* assumptions, size_t num_lits, c_lbool* results) NOEXCEPT_START {
+        std::vector<Lit> assumps;
+        std::vector<uint64_t> offsets;
+        if (!from_dimacs(self, assumptions, num_lits, assumps, offsets)) {
+            for(size_t i = 0, at = 0; i < num_lits; i++) {
+                if (assumptions[i] == 0) results[at++] = toc(l_Undef);
+            }
+            return;
+        }
+        std::vector<Lit> temp;
+        for(size_t i = 0; i+1 < offsets.size(); i++) {
+            temp.assign(assumps.begin()+offsets[i], assumps.begin()+offsets[i+1]);
+            results[i] = toc(self->solve(&temp));
+        }
+    } NOEXCEPT_END
+
     DLL_PUBLIC slice_lbool cmsat_get_model(const SATSolver* self) NOEXCEPT_START {
         return unwrap<slice_lbool>(self->get_model());
     } NOEXCEPT_END
@@ -167,4 +251,24 @@ extern "C"
     DLL_PUBLIC void cmsat_set_max_time(SATSolver* self, double max_time) NOEXCEPT_START {
         self->set_max_time(max_time);
     } NOEXCEPT_END
+
+    DLL_PUBLIC void cmsat_start_getting_constraints(SATSolver* self, bool red, bool simplified) NOEXCEPT_START {
+        self->start_getting_constraints(red, simplified);
+    } NOEXCEPT_END
+
+    DLL_PUBLIC size_t cmsat_get_next_constraints(SATSolver* self,
+        c_Lit* lits, size_t lits_cap,
+        size_t* offsets, size_t max_constraints,
+        uint8_t* flags) NOEXCEPT_START {
+        try {
+            return self->get_next_constraints(fromc(lits), lits_cap, offsets, max_constraints, flags);
+        } catch (const std::runtime_error&) {
+            //The constraint is kept, so the caller can retry with bigger buffers
+            return (size_t)-1;
+        }
+    } NOEXCEPT_END
+
+    DLL_PUBLIC void cmsat_end_getting_constraints(SATSolver* self) NOEXCEPT_START {
+        self->end_getting_constraints();
+    } NOEXCEPT_END
 }
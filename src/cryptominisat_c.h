@@ -63,10 +63,23 @@ CMS_DLL_PUBLIC void cmsat_free(SATSolver* s) NOEXCEPT;
 CMS_DLL_PUBLIC unsigned cmsat_nvars(const SATSolver* self) NOEXCEPT;
 CMS_DLL_PUBLIC bool cmsat_add_clause(SATSolver* self, const c_Lit* lits, size_t num_lits) NOEXCEPT;
 CMS_DLL_PUBLIC bool cmsat_add_xor_clause(SATSolver* self, const unsigned* vars, size_t num_vars, bool rhs) NOEXCEPT;
+
+// Bulk versions, taking DIMACS literals (+-(var+1)) where each clause is
+// terminated by 0, like IPASIR. Variables not yet in the solver are created.
+// An XOR is of its literals and must be true: a negated literal flips the
+// RHS, as in 'x' lines of DIMACS. A buffer whose last clause is not
+// terminated, or with a variable of 2^28 or more, is rejected: nothing is
+// added and false is returned
+CMS_DLL_PUBLIC bool cmsat_add_clauses(SATSolver* self, const int32_t* lits, size_t num_lits) NOEXCEPT;
+CMS_DLL_PUBLIC bool cmsat_add_xor_clauses(SATSolver* self, const int32_t* lits, size_t num_lits) NOEXCEPT;
 CMS_DLL_PUBLIC void cmsat_new_vars(SATSolver* self, const size_t n) NOEXCEPT;
 
 CMS_DLL_PUBLIC c_lbool cmsat_solve(SATSolver* self) NOEXCEPT;
 CMS_DLL_PUBLIC c_lbool cmsat_solve_with_assumptions(SATSolver* self, const c_Lit* assumptions, size_t num_assumptions) NOEXCEPT;
+// Solves once under each 0-terminated set of DIMACS assumptions, into results[i]
+// If the buffer is rejected as above, every result is L_UNDEF
+CMS_DLL_PUBLIC void cmsat_solve_with_assumptions_batch(SATSolver* self, const int32_t* assumptions, size_t num_lits, c_lbool* results) NOEXCEPT;
+// Points into the solver, valid until the next call that changes the solver
 CMS_DLL_PUBLIC slice_lbool cmsat_get_model(const SATSolver* self) NOEXCEPT;
 CMS_DLL_PUBLIC slice_Lit cmsat_get_conflict(const SATSolver* self) NOEXCEPT;
 
@@ -87,6 +100,19 @@ CMS_DLL_PUBLIC void cmsat_set_yes_comphandler(SATSolver* self) NOEXCEPT;
 CMS_DLL_PUBLIC c_lbool cmsat_simplify(SATSolver* self, const c_Lit* assumptions, size_t num_assumptions) NOEXCEPT;
 CMS_DLL_PUBLIC void cmsat_set_max_time(SATSolver* self, double max_time) NOEXCEPT;
 
+// Bulk export of the constraints, see SATSolver::get_next_constraints()
+// Constraint i is lits[offsets[i]] ... lits[offsets[i+1]-1]. flags[i] is 0 for a
+// clause, for an XOR bit 0 is set and bit 1 is the RHS. Returns 0 when done.
+// Returns (size_t)-1 if the next constraint can never fit: it is longer than
+// lits_cap (cmsat_nvars() literals are always enough), or it is an XOR and
+// flags is NULL. That constraint is kept, so the call can be retried.
+CMS_DLL_PUBLIC void cmsat_start_getting_constraints(SATSolver* self, bool red, bool simplified) NOEXCEPT;
+CMS_DLL_PUBLIC size_t cmsat_get_next_constraints(SATSolver* self,
+    c_Lit* lits, size_t lits_cap,
+    size_t* offsets, size_t max_constraints,
+    uint8_t* flags) NOEXCEPT;
+CMS_DLL_PUBLIC void cmsat_end_getting_constraints(SATSolver* self) NOEXCEPT;
+
 #ifdef __cplusplus
 } // end extern c
 #endif
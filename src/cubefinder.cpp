@@ -0,0 +1,212 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "cubefinder.h"
+#include "solver.h"
+#include "time_mem.h"
+#include "varreplacer.h"
+
+#include <algorithm>
+
+using namespace CMSat;
+
+CubeFinder::CubeFinder(Solver* _solver) :
+    solver(_solver)
+{}
+
+bool CubeFinder::find(
+    const vector<Lit>& assumps,
+    uint32_t depth,
+    vector<vector<Lit>>& _cubes
+) {
+    assert(solver->okay());
+    const double my_time = cpuTime();
+    solver->drop_kept_assumps();
+    if (!solver->okay()) return false;
+    assert(solver->decisionLevel() == 0);
+
+    cubes = &_cubes;
+    cubes->clear();
+    cube.clear();
+    if (!set_assumps(assumps)) {
+        solver->cancelUntil<false, true>(0);
+        return false;
+    }
+    rank_vars();
+    split(depth);
+    solver->cancelUntil<false, true>(0);
+    cubes = nullptr;
+
+    verb_print(1, "[cube] depth: " << depth
+        << " cubes: " << _cubes.size()
+        << " failed lits: " << num_failed
+        << " refuted: " << num_refuted
+        << " looks: " << num_looks
+        << solver->conf.print_times(cpuTime() - my_time));
+    return true;
+}
+
+//Every assumption gets its own decision level, the way Searcher sets them
+bool CubeFinder::set_assumps(const vector<Lit>& assumps)
+{
+    for(Lit p: assumps) {
+        p = solver->varReplacer->get_lit_replaced_with_outer(p);
+        p = solver->map_outer_to_inter(p);
+        if (solver->varData[p.var()].removed != Removed::none) return false;
+
+        solver->new_decision_level();
+        if (solver->value(p) == l_True) continue;
+        if (solver->value(p) == l_False) return false;
+        solver->enqueue<true>(p);
+        if (!solver->propagate<true>().isnullptr()) return false;
+    }
+    return true;
+}
+
+void CubeFinder::rank_vars()
+{
+    ranked.clear();
+    for(uint32_t v = 0; v < solver->nVars(); v++) {
+        const auto& vdata = solver->varData[v];
+        if (vdata.removed != Removed::none || vdata.is_bva) continue;
+        if (solver->value(v) != l_Undef) continue;
+        ranked.push_back(v);
+    }
+    const auto& act = solver->var_act_vsids;
+    std::stable_sort(ranked.begin(), ranked.end(),
+        [&](const uint32_t a, const uint32_t b) { return act[a] > act[b]; });
+}
+
+//Interrupted, or out of time. The cube so far is emitted as it is, so the
+//cubes still cover every solution
+bool CubeFinder::must_stop() const
+{
+    return solver->must_interrupt_asap() || cpuTime() >= solver->conf.maxTime;
+}
+
+//Returns false if l fails. Leaves the trail as it found it
+bool CubeFinder::look(const Lit l, uint32_t& props)
+{
+    num_looks++;
+    const size_t old_trail_size = solver->trail_size();
+    solver->new_decision_level();
+    solver->enqueue<true>(l);
+    const PropBy p = solver->propagate<true>();
+    props = solver->trail_size() - old_trail_size;
+    solver->cancelUntil<false, true>(solver->decisionLevel()-1);
+    return p.isnullptr();
+}
+
+//Sets l at a new decision level and adds it to the cube
+bool CubeFinder::set_lit(const Lit l)
+{
+    solver->new_decision_level();
+    solver->enqueue<true>(l);
+    cube.push_back(l);
+    return solver->propagate<true>().isnullptr();
+}
+
+void CubeFinder::emit()
+{
+    vector<Lit> outer;
+    outer.reserve(cube.size());
+    for(const Lit l: cube) outer.push_back(solver->map_inter_to_outer(l));
+    cubes->push_back(outer);
+}
+
+void CubeFinder::split(uint32_t depth)
+{
+    const uint32_t start_level = solver->decisionLevel();
+    const size_t start_cube_size = cube.size();
+    Lit best = lit_Undef;
+    while(true) {
+        if (depth == 0 || must_stop()) break;
+
+        //Look ahead on the top candidates. A failed literal sets its
+        //negation and we look again, as that may change the scores
+        best = lit_Undef;
+        uint64_t best_score = 0;
+        uint32_t looked = 0;
+        bool refuted = false;
+        Lit forced = lit_Undef;
+        for(const uint32_t v: ranked) {
+            if (looked >= solver->conf.cube_lookahead_cands) break;
+            if (solver->value(v) != l_Undef) continue;
+            looked++;
+
+            uint32_t pos_props;
+            uint32_t neg_props;
+            const bool pos_ok = look(Lit(v, false), pos_props);
+            const bool neg_ok = look(Lit(v, true), neg_props);
+            if (!pos_ok && !neg_ok) {
+                num_failed += 2;
+                refuted = true;
+                break;
+            }
+            if (!pos_ok || !neg_ok) {
+                num_failed++;
+                forced = Lit(v, !pos_ok);
+                break;
+            }
+
+            //Prefer balanced splits that propagate a lot on both sides
+            const uint64_t score = (uint64_t)(pos_props+1)*(neg_props+1);
+            if (best == lit_Undef || score > best_score) {
+                best_score = score;
+                //Take the side that propagates less first
+                best = Lit(v, pos_props > neg_props);
+            }
+        }
+
+        if (forced != lit_Undef) {
+            if (set_lit(forced)) continue;
+            refuted = true;
+        }
+        if (refuted) {
+            num_refuted++;
+            solver->cancelUntil<false, true>(start_level);
+            cube.resize(start_cube_size);
+            return;
+        }
+        break;
+    }
+
+    if (best == lit_Undef || depth == 0 || must_stop()) {
+        emit();
+    } else {
+        for(const Lit l: {best, ~best}) {
+            const uint32_t level = solver->decisionLevel();
+            if (set_lit(l)) {
+                split(depth-1);
+            } else {
+                //l was just looked ahead on, so this is not expected
+                num_failed++;
+                num_refuted++;
+            }
+            solver->cancelUntil<false, true>(level);
+            cube.pop_back();
+        }
+    }
+    solver->cancelUntil<false, true>(start_level);
+    cube.resize(start_cube_size);
+}
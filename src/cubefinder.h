@@ -0,0 +1,85 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#ifndef _CUBEFINDER_H_
+#define _CUBEFINDER_H_
+
+#include <vector>
+#include <cstdint>
+#include "solvertypes.h"
+
+using std::vector;
+
+namespace CMSat {
+
+class Solver;
+
+//Splits the search space under a set of assumptions into cubes by lookahead,
+//for cube-and-conquer solving. Every split variable is picked among the
+//highest-VSIDS unassigned variables by probing both of its literals, the
+//same way Solver::probe_inter() does at level 0, and scoring the number of
+//literals each side propagates. Failed literals found on the way are added
+//to the cube they were found in.
+class CubeFinder
+{
+public:
+    CubeFinder(Solver* solver);
+
+    //Cubes are in outer numbering and do not contain the assumptions.
+    //Together they cover every solution under the assumptions. Returns false
+    //if the assumptions could not be set up, e.g. they are conflicting
+    bool find(const vector<Lit>& assumps, uint32_t depth, vector<vector<Lit>>& cubes);
+
+    //Number of literals that failed during lookahead. If non-zero, some
+    //parts of the search space were refuted without recording which
+    //assumptions that relied on
+    uint64_t get_num_failed() const;
+
+private:
+    bool set_assumps(const vector<Lit>& assumps);
+    void rank_vars();
+    bool must_stop() const;
+    bool look(const Lit l, uint32_t& props);
+    bool set_lit(const Lit l);
+    void split(uint32_t depth);
+    void emit();
+
+    Solver* solver;
+    vector<uint32_t> ranked; //non-BVA variables, highest VSIDS first
+    vector<Lit> cube;
+    vector<vector<Lit>>* cubes = nullptr;
+
+    //stats
+    uint64_t num_failed = 0;
+    uint64_t num_refuted = 0;
+    uint64_t num_looks = 0;
+};
+
+inline uint64_t CubeFinder::get_num_failed() const
+{
+    return num_failed;
+}
+
+} //end namespace
+
+#endif //_CUBEFINDER_H_
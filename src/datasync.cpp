@@ -24,6 +24,7 @@ THE SOFTWARE.
 #include "varreplacer.h"
 #include "solver.h"
 #include "shareddata.h"
+#include "trace.h"
 
 #include <iostream>
 #include <iomanip>
@@ -112,6 +113,7 @@ bool DataSync::syncData()
         return true;
     }
     numCalls++;
+    TRACE_SCOPE("sync");
 
     assert(sharedData != nullptr);
     assert(solver->decisionLevel() == 0);
@@ -212,6 +214,9 @@ bool DataSync::shareUnitData()
                 continue;
             }
 
+            //At level 0, and propagated in syncData() before search resumes,
+            //so BNN counters see it, and its sublevel is below that of
+            //anything a BNN reason may later be computed for
             solver->enqueue<false>(litToEnqueue);
 
             thisGotUnitData++;
@@ -28,9 +28,11 @@ THE SOFTWARE.
 #include "watchalgos.h"
 #include "clauseallocator.h"
 #include "sqlstats.h"
+#include "propsnapshot.h"
 
 #include <iomanip>
 #include <random>
+#include <thread>
 using namespace CMSat;
 using std::cout;
 using std::endl;
@@ -234,6 +236,7 @@ bool DistillerLong::distill_long_cls_all(
     frat_func_start();
 
     double my_time = cpuTime();
+    par_wall_time = 0;
     const size_t origTrailSize = solver->trail_size();
 
     //Time-limiting
@@ -332,7 +335,7 @@ bool DistillerLong::distill_long_cls_all(
     //Add back the prioritized clauses
     for(const auto off: todo) offs.push_back(off);
 
-    const double time_used = cpuTime() - my_time;
+    const double time_used = cpuTime() - my_time + par_wall_time;
     const double time_remain = float_div(
         maxNumProps - ((int64_t)solver->propStats.bogoProps-(int64_t)oldBogoProps),
         orig_maxNumProps);
@@ -368,6 +371,9 @@ bool DistillerLong::distill_long_cls_all(
 }
 
 bool DistillerLong::go_through_clauses(vector<ClOffset>& cls, bool also_remove, bool only_remove) {
+    const uint32_t num_threads = std::min<size_t>(solver->conf.distill_threads, cls.size()/1000+1);
+    if (num_threads > 1) return go_through_clauses_par(cls, also_remove, only_remove, num_threads);
+
     frat_func_start();
     bool time_out = false;
     vector<ClOffset>::iterator i, j;
@@ -420,6 +426,182 @@ bool DistillerLong::go_through_clauses(vector<ClOffset>& cls, bool also_remove,
     return time_out;
 }
 
+// Every thread takes every N-th clause and distills it on its own
+// propagator over a snapshot of the clauses, each with the full prop budget.
+// The snapshot is equivalent to the clause DB throughout the commit below,
+// as every shortened clause is implied by the snapshot and implies the
+// clause it replaces. Removals are not: two clauses may each be redundant
+// only because of the other. So clauses found removable are distilled again,
+// serially, against the up-to-date clause DB, after all shortenings are in.
+bool DistillerLong::go_through_clauses_par(
+    vector<ClOffset>& cls
+    , const bool also_remove
+    , const bool only_remove
+    , const uint32_t num_threads
+) {
+    frat_func_start();
+    assert(solver->prop_at_head());
+    assert(solver->decisionLevel() == 0);
+
+    //Removal only propagates irred clauses, see try_distill_clause_and_return_new().
+    //The candidates have been taken out of the clause lists by the caller.
+    const PropSnapshot snap(solver, !also_remove, cls);
+    vector<SnapResult> res(cls.size());
+    vector<uint64_t> props(num_threads, 0);
+    const int64_t budget = maxNumProps;
+    auto work = [&](const uint32_t t) {
+        SnapshotPropagator prop(snap);
+        for(size_t i = t; i < cls.size(); i += num_threads) {
+            if ((int64_t)prop.props >= budget || solver->must_interrupt_asap()) break;
+            prop.props += 5;
+            const uint32_t cl_idx = snap.index_of(cls[i]);
+            assert(cl_idx != PropSnapshot::no_idx);
+            try_distill_on_snapshot(prop, cl_idx, cls[i], also_remove, only_remove, res[i]);
+        }
+        props[t] = prop.props;
+    };
+    const double wall_start = real_time_sec();
+    vector<std::thread> threads;
+    for(uint32_t t = 0; t < num_threads; t++) threads.push_back(std::thread(work, t));
+    for(auto& th: threads) th.join();
+    par_wall_time += real_time_sec() - wall_start;
+    maxNumProps -= *std::max_element(props.begin(), props.end());
+
+    //Commit in order
+    bool time_out = false;
+    vector<size_t> removable;
+    for(size_t i = 0; i < cls.size(); i++) {
+        if (res[i].kind == SnapResult::Kind::untried) {
+            time_out = true;
+            continue;
+        }
+        Clause& cl = *solver->cl_alloc.ptr(cls[i]);
+        if (also_remove) cl.tried_to_remove = 1;
+        else cl.distilled = 1;
+        runStats.checkedClauses++;
+        if (!solver->okay()) continue;
+
+        if (res[i].kind == SnapResult::Kind::shortened) {
+            cls[i] = commit_shortened(cls[i], res[i].lits, also_remove);
+        } else if (res[i].kind == SnapResult::Kind::removable) {
+            removable.push_back(i);
+        }
+    }
+    if (time_out) runStats.timeOut++;
+
+    oldBogoProps = solver->propStats.bogoProps;
+    for(const size_t i: removable) {
+        if (!solver->okay()) break;
+        if ((int64_t)solver->propStats.bogoProps-(int64_t)oldBogoProps >= maxNumProps
+            || solver->must_interrupt_asap()
+        ) {
+            time_out = true;
+            break;
+        }
+        maxNumProps -= 5;
+        Clause& cl = *solver->cl_alloc.ptr(cls[i]);
+        cls[i] = try_distill_clause_and_return_new(cls[i], &cl.stats, also_remove, only_remove);
+    }
+
+    uint32_t j = 0;
+    for(uint32_t i = 0; i < cls.size(); i++) {
+        if (cls[i] != CL_OFFSET_MAX) cls[j++] = cls[i];
+    }
+    cls.resize(j);
+
+    verb_print(2, "[distill-long-par] threads: " << num_threads
+        << " to-verify-removal: " << removable.size()
+        << " snapshot-MB: " << snap.mem_used()/(1024.0*1024.0));
+
+    frat_func_end();
+    return time_out;
+}
+
+// Same as try_distill_clause_and_return_new(), but on a snapshot and
+// without touching the clause
+void DistillerLong::try_distill_on_snapshot(
+    SnapshotPropagator& prop
+    , const uint32_t cl_idx
+    , const ClOffset offset
+    , const bool also_remove
+    , const bool only_remove
+    , SnapResult& res
+) const {
+    const Clause& cl = *solver->cl_alloc.ptr(offset);
+    const bool red = cl.red();
+    if (red) assert(!also_remove);
+
+    vector<Lit> todo;
+    for(const Lit l: cl) {
+        if (prop.value(l) == l_True) {
+            res.kind = SnapResult::Kind::unchanged;
+            return;
+        }
+        if (prop.value(l) == l_Undef) todo.push_back(l);
+    }
+    if (solver->conf.distill_sort == 4 && todo.size() < 500) {
+        if (offset % 2  == 0) std::sort(todo.begin(), todo.end(), VSIDS_largest_first(solver->var_act_vsids));
+        else std::sort(todo.begin(), todo.end(), LitCountDescSort(lit_counts));
+    }
+
+    bool confl = false;
+    bool True_confl = false;
+    res.lits.clear();
+    for(const Lit lit: todo) {
+        const lbool val = prop.value(lit);
+        if (val == l_Undef) {
+            res.lits.push_back(lit);
+            if (!prop.enqueue_and_propagate(~lit, cl_idx)) {
+                confl = true;
+                break;
+            }
+        } else if (val == l_False) {
+            if (only_remove) res.lits.push_back(lit);
+        } else {
+            res.lits.push_back(lit);
+            True_confl = true;
+            break;
+        }
+    }
+    prop.cancel_to_level0();
+
+    if (also_remove && !red && !True_confl && confl) {
+        res.kind = SnapResult::Kind::removable;
+    } else if (res.lits.size() < cl.size()) {
+        res.kind = SnapResult::Kind::shortened;
+    } else {
+        res.kind = SnapResult::Kind::unchanged;
+    }
+}
+
+ClOffset DistillerLong::commit_shortened(
+    const ClOffset offset
+    , const vector<Lit>& new_lits
+    , const bool also_remove
+) {
+    Clause& cl = *solver->cl_alloc.ptr(offset);
+    assert(new_lits.size() < cl.size());
+    const bool red = cl.red();
+    *solver->frat << deldelay << cl << fin;
+    solver->detachClause(cl, false);
+    runStats.numLitsRem += cl.size() - new_lits.size();
+    runStats.numClShorten++;
+
+    // new clause will inherit this clause's ID, see try_distill_clause_and_return_new()
+    ClauseStats backup_stats(cl.stats);
+    solver->free_cl(offset, false);
+    Clause *cl2 = solver->add_clause_int(new_lits, red, &backup_stats);
+    *solver->frat << findelay;
+
+    if (cl2 == nullptr) {
+        STATS_DO(solver->stats_del_cl(offset));
+        return CL_OFFSET_MAX;
+    }
+    if (also_remove) cl2->tried_to_remove = 1;
+    else cl2->distilled = 1;
+    return solver->cl_alloc.get_offset(cl2);
+}
+
 ClOffset DistillerLong::try_distill_clause_and_return_new(
     ClOffset offset, const ClauseStats* const stats,
     const bool also_remove, const bool only_remove
@@ -488,7 +670,7 @@ ClOffset DistillerLong::try_distill_clause_and_return_new(
             assert(val == l_True);
             cl[j++] = cl[i];
             True_confl = true;
-            confl = solver->varData[cl[i].var()].reason;
+            confl = solver->varReason[cl[i].var()];
             break;
         }
     }
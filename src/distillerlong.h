@@ -36,6 +36,8 @@ using std::vector;
 
 class Solver;
 class Clause;
+class PropSnapshot;
+class SnapshotPropagator;
 
 class DistillerLong {
     public:
@@ -79,6 +81,21 @@ class DistillerLong {
             bool only_remove,
             bool red, uint32_t red_lev = numeric_limits<uint32_t>::max());
         bool go_through_clauses(vector<ClOffset>& cls, const bool also_remove, const bool only_remove);
+
+        //Parallel distillation over a PropSnapshot
+        struct SnapResult {
+            enum class Kind : uint8_t {untried, unchanged, shortened, removable};
+            Kind kind = Kind::untried;
+            vector<Lit> lits;
+        };
+        bool go_through_clauses_par(
+            vector<ClOffset>& cls, const bool also_remove, const bool only_remove,
+            const uint32_t num_threads);
+        void try_distill_on_snapshot(
+            SnapshotPropagator& prop, const uint32_t cl_idx, const ClOffset offset,
+            const bool also_remove, const bool only_remove, SnapResult& res) const;
+        ClOffset commit_shortened(
+            const ClOffset offset, const vector<Lit>& new_lits, const bool also_remove);
         Solver* solver;
 
         //For distill
@@ -87,6 +104,7 @@ class DistillerLong {
         uint64_t oldBogoProps;
         int64_t maxNumProps;
         int64_t orig_maxNumProps;
+        double par_wall_time = 0; //the main thread only waits for the workers
 
         //Global status
         Stats runStats;
@@ -337,6 +337,7 @@ bool DistillerLongWithImpl::sub_str_all_cl_with_watch(
         //Timeout?
         if (timeAvailable <= 0
             || !solver->okay()
+            || solver->must_interrupt_asap()
         ) {
             need_to_finish = true;
             tmpStats.ranOutOfTime++;
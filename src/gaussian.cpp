@@ -113,7 +113,7 @@ struct ColSorter {
         }
 
         return false;
-        //return solver->varData[a].level < solver->varData[b].level;
+        //return solver->varLevel[a] < solver->varLevel[b];
         //return solver->var_act_vsids[a] > solver->var_act_vsids[b];
     }
 
@@ -166,7 +166,7 @@ void EGaussian::select_columnorder() {
         cout << "assump:" << (int)assump
         << " act: " << std::setprecision(2) << std::scientific
         << solver->var_act_vsids[x] << std::fixed
-        << " level: " << solver->varData[x].level
+        << " level: " << solver->varLevel[x]
         << endl;
     }
     #endif
@@ -661,7 +661,7 @@ uint32_t EGaussian::get_max_level(const GaussQData& gqd, const uint32_t row_n)
 
     for (uint32_t i = 1; i < cl->size(); i++) {
         Lit l = (*cl)[i];
-        uint32_t nLevel = solver->varData[l.var()].level;
+        uint32_t nLevel = solver->varLevel[l.var()];
         if (nLevel > nMaxLevel) {
             nMaxLevel = nLevel;
             nMaxInd = i;
@@ -920,7 +920,7 @@ void EGaussian::prop_lit(
         for(auto const& a: *x) {
             assert(solver->value(a) != l_True);
             if (solver->value(a) == l_False) {
-                assert(solver->varData[a.var()].level == 0);
+                assert(solver->varLevel[a.var()] == 0);
                 assert(solver->unit_cl_IDs[a.var()] != 0);
             }
             if (solver->value(a) == l_Undef) num_unset ++;
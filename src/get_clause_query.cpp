@@ -21,6 +21,8 @@ THE SOFTWARE.
 ***********************************************/
 
 #include <limits>
+#include <stdexcept>
+#include <string>
 
 #include "get_clause_query.h"
 #include "solver.h"
@@ -59,7 +61,17 @@ void GetClauseQuery::start_getting_constraints(bool _red, bool _simplified,
     elimed_at2 = 0;
     undef_at = 0;
     xor_at = 0;
+    pending_set = false;
     simplified = _simplified;
+
+    //Mapping to the outside numbering is a random access per literal, skip it if it's the identity
+    renumbered = false;
+    for(uint32_t v = 0; v < solver->nVarsOuter(); v++) {
+        if (solver->map_inter_to_outer(v) != v) {
+            renumbered = true;
+            break;
+        }
+    }
     if (simplified) {
         if (solver->get_num_bva_vars() != 0) {
             cout << "ERROR! You must not have BVA variables for simplified CNF getting" << endl;
@@ -92,6 +104,14 @@ vector<uint32_t> GetClauseQuery::translate_sampl_set(
     }
 }
 
+// Same as Solver::clause_outer_numbered(), but into `out`, so its memory is reused
+template<class T> void GetClauseQuery::outer_numbered(const T& cl, vector<Lit>& out) const
+{
+    out.clear();
+    if (!renumbered) for(const Lit l: cl) out.push_back(l);
+    else for(const Lit l: cl) out.push_back(solver->map_inter_to_outer(l));
+}
+
 bool GetClauseQuery::get_next_constraint(std::vector<Lit>& out, bool& is_xor, bool& rhs) {
     out.clear();
     is_xor = false;
@@ -113,9 +133,9 @@ bool GetClauseQuery::get_next_constraint(std::vector<Lit>& out, bool& is_xor, bo
         if (solver->value(v) != l_Undef) {
             out.clear();
             out.push_back(Lit(v, solver->value(v) == l_False));
-            if (!simplified) out = solver->clause_outer_numbered(out);
+            if (!simplified && renumbered) out[0] = solver->map_inter_to_outer(out[0]);
             if (all_vars_outside(out)) {
-                if (!simplified) if (!simplified) solver->map_inter_to_outer(out);
+                if (!simplified && renumbered) solver->map_inter_to_outer(out);
                 units_at++;
                 return true;
             }
@@ -136,9 +156,9 @@ bool GetClauseQuery::get_next_constraint(std::vector<Lit>& out, bool& is_xor, bo
                 out.clear();
                 out.push_back(l);
                 out.push_back(w.lit2());
-                if (!simplified) out = solver->clause_outer_numbered(out);
+                if (!simplified && renumbered) for(auto& ol: out) ol = solver->map_inter_to_outer(ol);
                 if (all_vars_outside(out)) {
-                    if (!simplified) solver->map_inter_to_outer(out);
+                    if (!simplified && renumbered) solver->map_inter_to_outer(out);
                     watched_at_sub++;
                     return true;
                 }
@@ -174,10 +194,10 @@ bool GetClauseQuery::get_next_constraint(std::vector<Lit>& out, bool& is_xor, bo
                 if (cl->size() <= max_len
                     && cl->stats.glue <= max_glue
                 ) {
-                    if (!simplified) out = solver->clause_outer_numbered(*cl);
+                    if (!simplified) outer_numbered(*cl, out);
                     else {out.clear(); for(const auto& l: *cl) out.push_back(l);}
                     if (all_vars_outside(out)) {
-                        if (!simplified) solver->map_inter_to_outer(out);
+                        if (!simplified && renumbered) solver->map_inter_to_outer(out);
                         at_lev[lev]++;
                         return true;
                     }
@@ -191,13 +211,13 @@ bool GetClauseQuery::get_next_constraint(std::vector<Lit>& out, bool& is_xor, bo
         const ClOffset offs = solver->longIrredCls[at];
         const Clause* cl = solver->cl_alloc.ptr(offs);
         if (cl->size() <= max_len) {
-            if (!simplified) out = solver->clause_outer_numbered(*cl);
+            if (!simplified) outer_numbered(*cl, out);
             else {
                 out.clear();
                 for(const auto& l: *cl) out.push_back(l);
             }
             if (all_vars_outside(out)) {
-                if (!simplified) solver->map_inter_to_outer(out);
+                if (!simplified && renumbered) solver->map_inter_to_outer(out);
                 at++;
                 return true;
             }
@@ -207,16 +227,20 @@ bool GetClauseQuery::get_next_constraint(std::vector<Lit>& out, bool& is_xor, bo
 
     //XOR clauses
     while(!red && xor_at < solver->xorclauses.size()) {
-        const auto x = solver->xorclauses[xor_at];
+        const Xor& x = solver->xorclauses[xor_at];
         if (x.size() <= max_len) {
-            if (!simplified) out = solver->clause_outer_numbered(x.vars);
-            else {
+            if (!simplified) {
+                out.clear();
+                for(const auto& v: x.vars) {
+                    out.push_back(Lit(renumbered ? solver->map_inter_to_outer(v) : v, false));
+                }
+            } else {
                 out.clear();
                 for(const auto& v: x.vars) out.push_back(Lit(v, false));
             }
             // NOTE; we must NEVER return the trivial XOR
             if (!x.trivial() && all_vars_outside(out)) {
-                if (!simplified) solver->map_inter_to_outer(out);
+                if (!simplified && renumbered) solver->map_inter_to_outer(out);
                 is_xor = true;
                 rhs = x.rhs;
                 xor_at++;
@@ -254,7 +278,54 @@ bool GetClauseQuery::get_next_constraint(std::vector<Lit>& out, bool& is_xor, bo
     return false;
 }
 
+// Copies the next constraints one after the other into `lits`, until either
+// buffer is full. The constraint that does not fit is kept for the next call.
+size_t GetClauseQuery::get_next_constraints(
+    Lit* lits, const size_t lits_cap,
+    size_t* offsets, const size_t max_constraints,
+    uint8_t* flags)
+{
+    size_t num = 0;
+    size_t at_lit = 0;
+    offsets[0] = 0;
+    while (num < max_constraints) {
+        if (!pending_set) {
+            if (!get_next_constraint(pending, pending_xor, pending_rhs)) break;
+            pending_set = true;
+        }
+        if (at_lit + pending.size() > lits_cap) {
+            if (num == 0) {
+                const string err = "ERROR: literal buffer of size "
+                    + std::to_string(lits_cap) + " cannot hold constraint of size "
+                    + std::to_string(pending.size());
+                std::cerr << err << endl;
+                throw std::runtime_error(err);
+            }
+            break;
+        }
+        if (pending_xor && flags == nullptr) {
+            if (num == 0) {
+                const char err[] = "ERROR: XOR constraint found, but no buffer given for the flags";
+                std::cerr << err << endl;
+                throw std::runtime_error(err);
+            }
+            break;
+        }
+
+        std::copy(pending.begin(), pending.end(), lits + at_lit);
+        at_lit += pending.size();
+        if (flags) flags[num] = pending_xor ? (1 | ((uint8_t)pending_rhs << 1)) : 0;
+        num++;
+        offsets[num] = at_lit;
+        pending_set = false;
+    }
+    return num;
+}
+
 bool GetClauseQuery::all_vars_outside(const vector<Lit>& cl) const {
+    //Only BVA introduces variables that are not visible outside
+    if (solver->get_num_bva_vars() == 0) return true;
+
     for(const auto& l: cl) if (solver->varData[solver->map_outer_to_inter(l.var())].is_bva)
         return false;
 
@@ -46,6 +46,10 @@ public:
            uint32_t max_len = std::numeric_limits<uint32_t>::max(),
            uint32_t max_glue = std::numeric_limits<uint32_t>::max());
     bool get_next_constraint(std::vector<Lit>& ret, bool& is_xor, bool& rhs);
+    size_t get_next_constraints(
+        Lit* lits, size_t lits_cap,
+        size_t* offsets, size_t max_constraints,
+        uint8_t* flags);
     void end_getting_constraints();
     vector<uint32_t> translate_sampl_set(const vector<uint32_t>& sampl_set);
 
@@ -68,7 +72,15 @@ private:
     uint32_t undef_at = numeric_limits<uint32_t>::max();
     uint32_t xor_at = numeric_limits<uint32_t>::max();
     bool simplified = false;
+    bool renumbered = true;
 
+    //Constraint that did not fit into the buffer of get_next_constraints()
+    vector<Lit> pending;
+    bool pending_set = false;
+    bool pending_xor = false;
+    bool pending_rhs = true;
+
+    template<class T> void outer_numbered(const T& cl, vector<Lit>& out) const;
     bool all_vars_outside(const vector<Lit>& cl) const;
 };
 }
@@ -0,0 +1,174 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "inprocess_sched.h"
+#include "solvertypes.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace CMSat;
+using std::string;
+using std::vector;
+
+//Passes that only ever make the CNF smaller and whose budget is scaled by
+//conf.global_timeout_multiplier. Everything else (occ, renumbering,
+//consolidation, must-* tokens, ...) is accounted but left alone.
+bool InprocessSched::adaptable(const string& token)
+{
+    return token == "scc-vrepl"
+        || token == "sub-impl"
+        || token == "str-impl"
+        || token == "intree-probe"
+        || token == "full-probe"
+        || token == "sub-str-cls-with-bin"
+        || token == "sub-cls-with-bin"
+        || token == "distill-bins"
+        || token == "distill-litrem"
+        || token == "distill-cls"
+        || token == "distill-cls-onlyrem"
+        || token == "oracle-vivif"
+        || token == "backbone";
+}
+
+double InprocessSched::PassStats::yield_per_sec() const
+{
+    //Below 1ms we cannot tell passes apart
+    return (double)yield()/std::max(time_used, 0.001);
+}
+
+static uint64_t decrease(uint64_t before, uint64_t after)
+{
+    return before > after ? before - after : 0;
+}
+
+static uint64_t increase(uint64_t before, uint64_t after)
+{
+    return after > before ? after - before : 0;
+}
+
+void InprocessSched::record(
+    const string& token
+    , const Snapshot& before
+    , const Snapshot& after
+    , const double time_used
+) {
+    PassStats& p = passes[token];
+    const uint64_t yield_before = p.yield();
+    p.calls++;
+    p.time_used += time_used;
+    p.cls_removed += decrease(before.cls, after.cls);
+    p.lits_removed += decrease(before.lits, after.lits);
+    p.units += increase(before.assigned, after.assigned);
+    p.equivs += increase(before.replaced, after.replaced);
+    p.elimed += increase(before.elimed, after.elimed);
+
+    if (p.yield() == yield_before) {
+        //Run once more, then skip 1, 3, 7, 15, 15, ... rounds
+        p.useless_streak++;
+        p.skip_left = (1U << std::min<uint32_t>(p.useless_streak-1, 4)) - 1;
+    } else {
+        p.useless_streak = 0;
+        p.skip_left = 0;
+    }
+}
+
+bool InprocessSched::should_skip(const string& token)
+{
+    auto it = passes.find(token);
+    if (it == passes.end() || it->second.skip_left == 0) return false;
+
+    it->second.skip_left--;
+    it->second.skipped++;
+    return true;
+}
+
+double InprocessSched::budget_mult(const string& token) const
+{
+    auto it = passes.find(token);
+    if (it == passes.end() || it->second.calls == 0) return 1.0;
+
+    double sum = 0;
+    uint32_t num = 0;
+    for(const auto& p: passes) {
+        if (!adaptable(p.first) || p.second.calls == 0) continue;
+        sum += p.second.yield_per_sec();
+        num++;
+    }
+    if (num == 0 || sum == 0) return 1.0;
+
+    const double avg = sum/(double)num;
+    const double mult = it->second.yield_per_sec()/avg;
+    return std::max(0.25, std::min(2.0, mult));
+}
+
+void InprocessSched::reorder(vector<string>& tokens) const
+{
+    //Passes not yet run go first, in schedule order
+    auto key = [&](const string& token) {
+        auto it = passes.find(token);
+        if (it == passes.end() || it->second.calls == 0) {
+            return std::numeric_limits<double>::infinity();
+        }
+        return it->second.yield_per_sec();
+    };
+
+    auto start = tokens.begin();
+    while(start != tokens.end()) {
+        if (!adaptable(*start)) {
+            start++;
+            continue;
+        }
+        auto end = start;
+        while(end != tokens.end() && adaptable(*end)) end++;
+        std::stable_sort(start, end, [&](const string& a, const string& b) {
+            return key(a) > key(b);
+        });
+        start = end;
+    }
+}
+
+const InprocessSched::PassStats* InprocessSched::get_stats(const string& token) const
+{
+    auto it = passes.find(token);
+    if (it == passes.end()) return nullptr;
+    return &it->second;
+}
+
+void InprocessSched::print_stats(const double cpu_time) const
+{
+    for(const auto& it: passes) {
+        const string& name = it.first;
+        const PassStats& p = it.second;
+        print_stats_line("c [pass] " + name + " time"
+            , p.time_used
+            , stats_line_percent(p.time_used, cpu_time)
+            , "% time"
+        );
+        print_stats_line("c [pass] " + name + " calls/skip/yield"
+            , p.calls
+            , p.skipped
+            , p.yield()
+        );
+    }
+}
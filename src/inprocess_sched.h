@@ -0,0 +1,97 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#ifndef CMS_INPROCESS_SCHED_H
+#define CMS_INPROCESS_SCHED_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace CMSat {
+
+// Per-pass cost accounting for the inprocessing schedule, and an optional
+// adaptive policy built on it.
+//
+// Every strategy token executed by Solver::execute_inprocess_strategy() is
+// bracketed by two snapshots of the CNF size; the difference is the pass'
+// yield. The occurrence-based tokens run as one group and are accounted
+// under "occ".
+//
+// When adaptive inprocessing is on, the pure simplification passes (see
+// adaptable()) are
+//  - skipped with exponential backoff after rounds where they found nothing
+//  - given a budget scaled by their yield/s relative to the other passes
+//  - reordered within a run of adaptable tokens, highest yield/s first
+// Since this depends on measured time, it is not deterministic.
+class InprocessSched
+{
+public:
+    struct Snapshot {
+        uint64_t cls = 0; //irredundant long + binary clauses
+        uint64_t lits = 0; //literals in them
+        uint64_t assigned = 0; //vars set at level 0
+        uint64_t replaced = 0; //vars replaced by an equivalent literal
+        uint64_t elimed = 0; //vars eliminated
+    };
+
+    struct PassStats {
+        uint64_t calls = 0;
+        uint64_t skipped = 0;
+        double time_used = 0;
+        uint64_t cls_removed = 0;
+        uint64_t lits_removed = 0;
+        uint64_t units = 0;
+        uint64_t equivs = 0;
+        uint64_t elimed = 0;
+
+        uint32_t useless_streak = 0;
+        uint32_t skip_left = 0;
+
+        uint64_t yield() const {
+            return cls_removed + lits_removed + units + equivs + elimed;
+        }
+        double yield_per_sec() const;
+    };
+
+    static bool adaptable(const std::string& token);
+
+    void record(const std::string& token, const Snapshot& before,
+        const Snapshot& after, double time_used);
+
+    //Only meaningful for adaptable tokens
+    void reorder(std::vector<std::string>& tokens) const;
+    bool should_skip(const std::string& token);
+    double budget_mult(const std::string& token) const;
+
+    const PassStats* get_stats(const std::string& token) const;
+    void print_stats(double cpu_time) const;
+
+private:
+    std::map<std::string, PassStats> passes;
+};
+
+}
+
+#endif //CMS_INPROCESS_SCHED_H
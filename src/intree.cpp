@@ -58,11 +58,6 @@ bool InTree::replace_until_fixedpoint(bool& aborted)
         if (!solver->clauseCleaner->remove_and_clean_all()) return false;
         bool OK = solver->varReplacer->replace_if_enough_is_found(0, &bogoprops);
         if (!OK) return false;
-
-        if (solver->varReplacer->get_scc_depth_warning_triggered()) {
-            aborted = true;
-            return solver->okay();
-        }
         this_replace = solver->varReplacer->get_num_replaced_vars();
 
         if (bogoprops > time_limit) {
@@ -223,6 +218,7 @@ void InTree::tree_look()
             (int64_t)solver->propStats.bogoProps
             + (int64_t)solver->propStats.otfHyperTime
             || timeout
+            || solver->must_interrupt_asap()
         ) {
             break;
         }
@@ -252,7 +248,7 @@ void InTree::tree_look()
                 ResetReason tmp = reset_reason_stack.back();
                 reset_reason_stack.pop_back();
                 if (tmp.var_reason_changed != var_Undef) {
-                    solver->varData[tmp.var_reason_changed].reason = tmp.orig_propby;
+                    solver->varReason[tmp.var_reason_changed] = tmp.orig_propby;
                     if (solver->conf.verbosity >= 10) {
                         cout << "RESet reason for VAR " << tmp.var_reason_changed+1 << " to:  ????" << /*tmp.orig_propby.lit2() << */ " red: " << (int)tmp.orig_propby.isRedStep() << endl;
                     }
@@ -294,8 +290,8 @@ bool InTree::handle_lit_popped_from_queue(
     if (other_lit != lit_Undef) {
         //update 'other_lit' 's ancestor to 'lit'
         assert(solver->value(other_lit) == l_True);
-        reset_reason_stack.back() = ResetReason(other_lit.var(), solver->varData[other_lit.var()].reason);
-        solver->varData[other_lit.var()].reason = PropBy(~lit, red, false, false, ID);
+        reset_reason_stack.back() = ResetReason(other_lit.var(), solver->varReason[other_lit.var()]);
+        solver->varReason[other_lit.var()] = PropBy(~lit, red, false, false, ID);
         verb_print(10, "Set reason for VAR " << other_lit.var()+1
         << " to: " << ~lit << " red: " << (int)red);
     }
@@ -43,10 +43,13 @@ void CMSat::Lucky::doit()
 
     if (check_all(true)) goto end;
     if (check_all(false)) goto end;
+    if (solver->must_interrupt_asap()) goto end;
     if (search_fwd_sat(true)) goto end;
     if (search_fwd_sat(false)) goto end;
+    if (solver->must_interrupt_asap()) goto end;
     if (search_backw_sat(true)) goto end;
     if (search_backw_sat(false)) goto end;
+    if (solver->must_interrupt_asap()) goto end;
     if (horn_sat(true)) goto end;
     if (horn_sat(false)) goto end;
 
@@ -37,6 +37,8 @@ THE SOFTWARE.
 #include "main.h"
 #include "time_mem.h"
 #include "dimacsparser.h"
+#include "binarycnf.h"
+#include "opbparser.h"
 #include "cryptominisat.h"
 #include "signalcode.h"
 #include "argparse.hpp"
@@ -67,6 +69,11 @@ void Main::readInAFile(SATSolver* solver2, const string& filename)
 {
     solver2->add_sql_tag("filename", filename);
     if (conf.verbosity) cout << "c Reading file '" << filename << "'" << endl;
+    if (BinaryCnfParser<SATSolver>::is_binary_cnf(filename)) {
+        BinaryCnfParser<SATSolver> parser(solver2, conf.verbosity);
+        if (!parser.parse(filename)) exit(-1);
+        return;
+    }
     #ifndef USE_ZLIB
     FILE * in = fopen(filename.c_str(), "rb");
     DimacsParser<StreamBuffer<FILE*, FN>, SATSolver> parser(solver2, &debugLib, conf.verbosity);
@@ -84,9 +91,18 @@ void Main::readInAFile(SATSolver* solver2, const string& filename)
         std::exit(1);
     }
 
-    bool strict_header = false;
-    if (!parser.parse_DIMACS(in, strict_header)) {
-        exit(-1);
+    if (OpbParser<StreamBuffer<FILE*, FN>, SATSolver>::is_opb_fname(filename)) {
+        #ifndef USE_ZLIB
+        OpbParser<StreamBuffer<FILE*, FN>, SATSolver> opb_parser(solver2, conf.verbosity);
+        #else
+        OpbParser<StreamBuffer<gzFile, GZ>, SATSolver> opb_parser(solver2, conf.verbosity);
+        #endif
+        if (!opb_parser.parse_opb(in)) exit(-1);
+    } else {
+        bool strict_header = false;
+        if (!parser.parse_DIMACS(in, strict_header)) {
+            exit(-1);
+        }
     }
 
     #ifndef USE_ZLIB
@@ -236,6 +252,44 @@ void Main::add_supported_options() {
         .default_value(1)
         .action([&](const auto& a) {num_threads = std::atoi(a.c_str());})
         .help("Number of threads");
+    program.add_argument("--portfolio")
+        .action([&](const auto& a) {portfolio_fname = a;})
+        .help("File with per-thread configurations, one line of 'field=value' overrides per thread. Unless --threads is given, one thread is used per line");
+    program.add_argument("--pin")
+        .action([&](const auto& a) {thread_pinning = a;})
+        .default_value(thread_pinning)
+        .help("Pin threads: 'none', 'core' (one core each) or 'node' (all cores of one NUMA node, round-robin). Memory of each thread is then allocated on its node");
+    program.add_argument("--cubes")
+        .action([&](const auto& a) {conf.cube_depth = std::atoi(a.c_str());})
+        .default_value(conf.cube_depth)
+        .help("With multiple threads, split the problem by lookahead into at most 2^N cubes and solve them on a work-stealing pool of threads instead of racing a portfolio. 0 = off");
+    program.add_argument("--cubecands")
+        .action([&](const auto& a) {conf.cube_lookahead_cands = std::atoi(a.c_str());})
+        .default_value(conf.cube_lookahead_cands)
+        .help("Number of highest-activity variables to look ahead on at every cube split");
+    program.add_argument("--cubebudget")
+        .action([&](const auto& a) {conf.cube_confl_budget = std::atoll(a.c_str());})
+        .default_value(conf.cube_confl_budget)
+        .help("Conflicts spent on a cube before it is split again for an idle thread");
+    program.add_argument("--metricsfile")
+        .action([&](const auto& a) {metrics_fname = a;})
+        .help("Periodically write live solver metrics to this file as JSON lines");
+    program.add_argument("--metricsevery")
+        .action([&](const auto& a) {metrics_every = std::atof(a.c_str());})
+        .default_value(metrics_every)
+        .help("Seconds (wall-clock) between two lines of --metricsfile");
+    program.add_argument("--tracefile")
+        .action([&](const auto& a) {trace_fname = a;})
+        .help("Write the restart/reduceDB/inprocessing timeline as Chrome trace JSON here. Needs a build with cmake -DTRACE_EVENTS=ON");
+    program.add_argument("--savestate")
+        .action([&](const auto& a) {save_state_fname = a;})
+        .help("Checkpoint the solver (learnt clauses, activities, phases, simplifications) to this file before exiting");
+    program.add_argument("--tobinary")
+        .action([&](const auto& a) {to_binary_fname = a;})
+        .help("Convert the input to the binary CNF format (read back automatically, mmap-ed) in this file, then exit. Only irredundant clauses, XORs and sampling variables are kept");
+    program.add_argument("--loadstate")
+        .action([&](const auto& a) {load_state_fname = a;})
+        .help("Resume from a checkpoint written by --savestate. The input file, if given, is added on top of it");
     program.add_argument("-m", "--mult")
         .action([&](const auto& a) {conf.orig_global_timeout_multiplier = std::atof(a.c_str());})
         .default_value(conf.orig_global_timeout_multiplier)
@@ -553,6 +607,10 @@ void Main::add_supported_options() {
         .action([&](const auto& a) {conf.simplify_at_every_startup = std::atoi(a.c_str());})
         .default_value(conf.simplify_at_every_startup)
         .help("Perform simplification at EVERY start -- only matters in library mode");
+    program.add_argument("--reusetrail")
+        .action([&](const auto& a) {conf.reuse_assump_trail = std::atoi(a.c_str());})
+        .default_value(conf.reuse_assump_trail)
+        .help("Keep the trail of the assumptions shared with the previous solve() call -- only matters in library mode");
     program.add_argument("-n", "--nonstop")
         .action([&](const auto& a) {conf.never_stop_search = std::atoi(a.c_str());})
         .default_value(conf.never_stop_search)
@@ -568,6 +626,14 @@ void Main::add_supported_options() {
     program.add_argument("--preschedule")
         .action([&](const auto& a) {conf.simplify_schedule_startup = a;})
         .help("Schedule for simplification at startup");
+    program.add_argument("--oraclevivifthreads")
+        .action([&](const auto& a) {conf.oracle_vivif_threads = std::atoi(a.c_str());})
+        .default_value(conf.oracle_vivif_threads)
+        .help("Number of threads, each with its own oracle, to shard oracle vivification over");
+    program.add_argument("--adaptinproc")
+        .action([&](const auto& a) {conf.do_adaptive_inprocess = std::atoi(a.c_str());})
+        .default_value(conf.do_adaptive_inprocess)
+        .help("Skip, reorder and scale the budget of inprocessing passes based on their observed yield per second. Not deterministic.");
     program.add_argument("--occsimp")
         .action([&](const auto& a) {conf.perform_occur_based_simp = std::atoi(a.c_str());})
         .default_value(conf.perform_occur_based_simp)
@@ -681,6 +747,10 @@ void Main::add_supported_options() {
         .action([&](const auto& a) {conf.doVarElim = std::atoi(a.c_str());})
         .default_value(conf.doVarElim)
         .help("Perform variable elimination as per Een and Biere");
+    program.add_argument("--incextend")
+        .action([&](const auto& a) {conf.incremental_extend = std::atoi(a.c_str());})
+        .default_value(conf.incremental_extend)
+        .help("When extending a model to the eliminated variables, only redo the eliminated clauses that depend on variables whose value changed since the previous model");
     program.add_argument("--varelimto")
         .action([&](const auto& a) {conf.varelim_time_limitM = std::atoll(a.c_str());})
         .default_value(conf.varelim_time_limitM)
@@ -720,6 +790,10 @@ void Main::add_supported_options() {
         .action([&](const auto& a) {conf.xor_finder_time_limitM = std::atoll(a.c_str());})
         .default_value(conf.xor_finder_time_limitM)
         .help("Time limit for finding XORs");
+    program.add_argument("--xorfindthreads")
+        .action([&](const auto& a) {conf.xor_finder_threads = std::atoi(a.c_str());})
+        .default_value(conf.xor_finder_threads)
+        .help("Look for XORs on this many threads, each with the full time limit. Duplicate XORs are removed after. Ignored with FRAT");
     program.add_argument("--maxxormat")
         .action([&](const auto& a) {conf.maxXORMatrix = std::atoll(a.c_str());})
         .default_value(conf.maxXORMatrix)
@@ -869,6 +943,10 @@ void Main::add_supported_options() {
         .action([&](const auto& a) {conf.distill_sort = std::atoi(a.c_str());})
         .default_value(conf.distill_sort)
         .help("Distill sorting type");
+    program.add_argument("--distillthreads")
+        .action([&](const auto& a) {conf.distill_threads = std::atoi(a.c_str());})
+        .default_value(conf.distill_threads)
+        .help("Evaluate long clause distillation candidates on this many threads, each propagating over a read-only snapshot of the clauses. Strengthenings are committed serially");
     ;
 
     /* po::options_description mem_save_opts("Memory saving options"); */
@@ -913,7 +991,11 @@ void Main::add_supported_options() {
     program.add_argument("--cardfind")
         .action([&](const auto& a) {conf.doFindCard = std::atoi(a.c_str());})
         .default_value(conf.doFindCard)
-        .help("Find cardinality constraints");
+        .help("Find cardinality constraints. 1 = only report them, 2 = also replace pairwise-encoded at-most-one groups with native constraints");
+    program.add_argument("--cardnativemin")
+        .action([&](const auto& a) {conf.card_native_min_size = std::atoi(a.c_str());})
+        .default_value(conf.card_native_min_size)
+        .help("Only replace at-most-one groups at least this large with native constraints");
 
     /* hiddenOptions.add_options() */
     program.add_argument("--sync")
@@ -932,10 +1014,6 @@ void Main::add_supported_options() {
         .action([&](const auto& a) {conf.do_print_times = std::atoi(a.c_str());})
         .default_value(conf.do_print_times)
         .help("Print time it took for each simplification run. If set to 0, logs are easier to compare");
-    program.add_argument("--maxsccdepth")
-        .action([&](const auto& a) {conf.max_scc_depth = std::atoi(a.c_str());})
-        .default_value(conf.max_scc_depth)
-        .help("The maximum for scc search depth");
     program.add_argument("--simfrat")
         .action([&](const auto& a) {conf.simulate_frat = std::atoi(a.c_str());})
         .default_value(conf.simulate_frat)
@@ -1242,8 +1320,24 @@ int Main::solve()
     if (program.is_used("maxconfl")) solver->set_max_confl(program.get<uint64_t>("maxconfl"));
 
     parse_sampling_vars();
+    if (!portfolio_fname.empty()) {
+        try {
+            solver->set_portfolio_file(portfolio_fname);
+        } catch (std::runtime_error& e) {
+            cerr << e.what() << endl;
+            exit(-1);
+        }
+        if (!program.is_used("threads")) num_threads = solver->get_portfolio_size();
+    }
     check_num_threads_sanity(num_threads);
     solver->set_num_threads(num_threads);
+    try {
+        solver->set_thread_pinning(thread_pinning);
+        if (!metrics_fname.empty()) solver->set_metrics_file(metrics_fname, metrics_every);
+    } catch (std::runtime_error& e) {
+        cerr << e.what() << endl;
+        exit(-1);
+    }
     if (sql != 0) solver->set_sqlite(sqlite_filename);
 
     //Print command line used to execute the solver: for options and inputs
@@ -1269,7 +1363,23 @@ int Main::solve()
 
     //Parse in DIMACS (maybe gzipped) files
     //solver->log_to_file("mydump.cnf");
-    parseInAllFiles(solver);
+    if (!load_state_fname.empty()) {
+        try {
+            solver->load_state(load_state_fname);
+        } catch (std::runtime_error&) {
+            exit(-1);
+        }
+    }
+    if (load_state_fname.empty() || fileNamePresent) parseInAllFiles(solver);
+    if (!to_binary_fname.empty()) {
+        try {
+            solver->open_file_and_dump_irred_clauses_binary(to_binary_fname.c_str());
+        } catch (std::runtime_error&) {
+            exit(-1);
+        }
+        if (conf.verbosity) cout << "c Wrote binary CNF to '" << to_binary_fname << "'" << endl;
+        exit(0);
+    }
     if (!assump_filename.empty()) {
         std::ifstream* tmp = new std::ifstream;
         tmp->open(assump_filename.c_str());
@@ -1294,6 +1404,23 @@ int Main::solve()
     if (conf.verbosity) {
         solver->print_stats(wallclock_time_started);
     }
+    if (!trace_fname.empty()) {
+        try {
+            if (!solver->dump_trace(trace_fname)) {
+                cout << "c WARNING: tracing is not compiled in, rebuild with cmake -DTRACE_EVENTS=ON" << endl;
+            }
+        } catch (std::runtime_error& e) {
+            cerr << e.what() << endl;
+            exit(-1);
+        }
+    }
+    if (!save_state_fname.empty()) {
+        try {
+            solver->save_state(save_state_fname);
+        } catch (std::runtime_error&) {
+            exit(-1);
+        }
+    }
 
     printResultFunc(&cout, false, ret);
     if (resultfile) {
@@ -1326,6 +1453,34 @@ lbool Main::multi_solutions()
         solver->set_single_run();
     }
 
+    if (max_nr_of_solutions > 1
+        && !dont_ban_solutions
+        && fratf == nullptr
+        && !conf.simulate_frat
+        && debugLib.empty()
+    ) {
+        //Let the solver block the solutions and continue from where it was.
+        //The last solution is printed by the caller
+        unsigned long current_nr_of_solutions = 0;
+        return solver->enumerate_solutions(
+            [&](const vector<lbool>&) {
+                current_nr_of_solutions++;
+                if (current_nr_of_solutions >= max_nr_of_solutions) return false;
+
+                printResultFunc(&cout, false, l_True);
+                if (resultfile) {
+                    printResultFunc(resultfile, true, l_True);
+                }
+                if (conf.verbosity) {
+                    cout
+                    << "c Number of solutions found until now: "
+                    << std::setw(6) << current_nr_of_solutions
+                    << endl;
+                }
+                return true;
+            }, max_nr_of_solutions, &assumps, only_sampl_solution);
+    }
+
     unsigned long current_nr_of_solutions = 0;
     lbool ret = l_True;
     while(current_nr_of_solutions < max_nr_of_solutions && ret == l_True) {
@@ -93,6 +93,14 @@ class Main: public MainCommon
         int printResult = true;
         string commandLine;
         uint32_t max_nr_of_solutions = 1;
+        string portfolio_fname;
+        string thread_pinning = "none";
+        string metrics_fname;
+        double metrics_every = 1.0;
+        string trace_fname;
+        string save_state_fname;
+        string load_state_fname;
+        string to_binary_fname;
         bool dont_ban_solutions = false;
         int sql = 0;
         string sqlite_filename;
@@ -0,0 +1,170 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "metrics.h"
+#include "time_mem.h"
+
+#include <cassert>
+#include <cmath>
+#include <sstream>
+#include <iomanip>
+
+using namespace CMSat;
+using std::string;
+using std::vector;
+
+Metrics::Metrics()
+{
+    for(auto& c: counters) c.store(0, std::memory_order_relaxed);
+    for(auto& m: mems) m.store(0, std::memory_order_relaxed);
+    for(auto& h: hists) {
+        h.sum_us.store(0, std::memory_order_relaxed);
+        for(auto& b: h.buckets) b.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint32_t Metrics::bucket_of(uint64_t us)
+{
+    uint32_t b = 0;
+    while (us > 0 && b < hist_buckets-1) {
+        us >>= 1;
+        b++;
+    }
+    return b;
+}
+
+void Metrics::record(const Hist h, const double secs)
+{
+    const uint64_t us = secs <= 0 ? 0 : (uint64_t)std::llround(secs*1e6);
+    hists[h].sum_us.fetch_add(us, std::memory_order_relaxed);
+    hists[h].buckets[bucket_of(us)].fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t Metrics::get_hist_count(const Hist h) const
+{
+    uint64_t n = 0;
+    for(const auto& b: hists[h].buckets) n += b.load(std::memory_order_relaxed);
+    return n;
+}
+
+const char* Metrics::name(const Counter c)
+{
+    switch(c) {
+        case conflicts: return "conflicts";
+        case propagations: return "propagations";
+        case decisions: return "decisions";
+        case restarts: return "restarts";
+        case simplifications: return "simplifications";
+        case sync_units_sent: return "sync_units_sent";
+        case sync_units_recv: return "sync_units_recv";
+        case sync_bins_sent: return "sync_bins_sent";
+        case sync_bins_recv: return "sync_bins_recv";
+        case assump_levels_reused: return "assump_levels_reused";
+        case num_counters: break;
+    }
+    assert(false);
+    return "";
+}
+
+const char* Metrics::name(const Mem m)
+{
+    switch(m) {
+        case mem_longclauses: return "longclauses";
+        case mem_watches: return "watches";
+        case mem_vardata: return "vardata";
+        case mem_search: return "search";
+        case mem_renumberer: return "renumberer";
+        case mem_occsimp: return "occsimp";
+        case mem_varreplacer: return "varreplacer";
+        case mem_subsimp: return "subsimp";
+        case mem_distill: return "distill";
+        case num_mems: break;
+    }
+    assert(false);
+    return "";
+}
+
+const char* Metrics::name(const Hist h)
+{
+    switch(h) {
+        case reducedb_pause: return "reducedb_pause_us";
+        case inprocess_pass: return "inprocess_pass_us";
+        case num_hists: break;
+    }
+    assert(false);
+    return "";
+}
+
+string Metrics::to_json(const vector<const Metrics*>& all, const double wall_secs)
+{
+    std::stringstream ss;
+    ss << "{\"time\":" << std::fixed << std::setprecision(3) << wall_secs
+    << ",\"threads\":" << all.size();
+
+    ss << ",\"counters\":{";
+    for(uint32_t c = 0; c < num_counters; c++) {
+        uint64_t sum = 0;
+        for(const Metrics* m: all) sum += m->get((Counter)c);
+        ss << (c ? "," : "") << "\"" << name((Counter)c) << "\":" << sum;
+    }
+    ss << "}";
+
+    ss << ",\"thread_conflicts\":[";
+    for(size_t i = 0; i < all.size(); i++) {
+        ss << (i ? "," : "") << all[i]->get(conflicts);
+    }
+    ss << "]";
+
+    double vm_mem_used = 0;
+    ss << ",\"mem_bytes\":{\"rss\":" << memUsedTotal(vm_mem_used);
+    for(uint32_t mi = 0; mi < num_mems; mi++) {
+        uint64_t sum = 0;
+        for(const Metrics* m: all) sum += m->get_mem((Mem)mi);
+        ss << ",\"" << name((Mem)mi) << "\":" << sum;
+    }
+    ss << "}";
+
+    ss << ",\"hist\":{";
+    for(uint32_t h = 0; h < num_hists; h++) {
+        uint64_t cnt = 0;
+        uint64_t sum_us = 0;
+        uint64_t buckets[hist_buckets] = {};
+        for(const Metrics* m: all) {
+            sum_us += m->get_hist_sum_us((Hist)h);
+            for(uint32_t b = 0; b < hist_buckets; b++) {
+                const uint64_t n = m->get_hist_bucket((Hist)h, b);
+                buckets[b] += n;
+                cnt += n;
+            }
+        }
+        ss << (h ? "," : "") << "\"" << name((Hist)h) << "\":{"
+        << "\"count\":" << cnt << ",\"sum\":" << sum_us << ",\"buckets\":[";
+        for(uint32_t b = 0; b < hist_buckets; b++) {
+            ss << (b ? "," : "") << buckets[b];
+        }
+        ss << "]}";
+    }
+    ss << "}}";
+
+    return ss.str();
+}
@@ -0,0 +1,128 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#ifndef CMS_METRICS_H
+#define CMS_METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace CMSat {
+
+// Live metrics of one solver thread, for the host to poll during long solves.
+//
+// Only the owning solver thread writes, and only with relaxed atomic stores,
+// at points where it already has the numbers at hand (end of a restart,
+// after reduceDB, after an inprocessing pass, before a search iteration).
+// Any thread may read at any time without locking. Values read while solving
+// are individually consistent but not a snapshot of the whole block.
+class Metrics
+{
+public:
+    enum Counter : uint32_t {
+        conflicts
+        , propagations
+        , decisions
+        , restarts
+        , simplifications
+        , sync_units_sent
+        , sync_units_recv
+        , sync_bins_sent
+        , sync_bins_recv
+        , assump_levels_reused
+        , num_counters
+    };
+
+    //Bytes used by the subsystems listed in Solver::print_mem_stats()
+    enum Mem : uint32_t {
+        mem_longclauses
+        , mem_watches
+        , mem_vardata
+        , mem_search
+        , mem_renumberer
+        , mem_occsimp
+        , mem_varreplacer
+        , mem_subsimp
+        , mem_distill
+        , num_mems
+    };
+
+    //Wall-clock durations. Bucket i counts the events that took [2^(i-1), 2^i)
+    //microseconds, bucket 0 those under 1us, the last one everything above.
+    enum Hist : uint32_t {
+        reducedb_pause
+        , inprocess_pass
+        , num_hists
+    };
+    static constexpr uint32_t hist_buckets = 28;
+
+    Metrics();
+
+    void set(const Counter c, const uint64_t val) {
+        counters[c].store(val, std::memory_order_relaxed);
+    }
+    void set_mem(const Mem m, const uint64_t bytes) {
+        mems[m].store(bytes, std::memory_order_relaxed);
+    }
+    void record(const Hist h, const double secs);
+
+    uint64_t get(const Counter c) const {
+        return counters[c].load(std::memory_order_relaxed);
+    }
+    uint64_t get_mem(const Mem m) const {
+        return mems[m].load(std::memory_order_relaxed);
+    }
+    uint64_t get_hist_count(const Hist h) const;
+    uint64_t get_hist_sum_us(const Hist h) const {
+        return hists[h].sum_us.load(std::memory_order_relaxed);
+    }
+    uint64_t get_hist_bucket(const Hist h, const uint32_t bucket) const {
+        return hists[h].buckets[bucket].load(std::memory_order_relaxed);
+    }
+
+    static uint32_t bucket_of(const uint64_t us);
+    static const char* name(const Counter c);
+    static const char* name(const Mem m);
+    static const char* name(const Hist h);
+
+    //One JSON object, on a single line, summing all threads' metrics.
+    //Per-thread conflicts are listed too, to spot stalled threads.
+    static std::string to_json(
+        const std::vector<const Metrics*>& all, const double wall_secs);
+
+private:
+    struct Histogram {
+        std::atomic<uint64_t> sum_us;
+        std::atomic<uint64_t> buckets[hist_buckets];
+    };
+
+    std::atomic<uint64_t> counters[num_counters];
+    std::atomic<uint64_t> mems[num_mems];
+    Histogram hists[num_hists];
+};
+
+}
+
+#endif //CMS_METRICS_H
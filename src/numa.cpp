@@ -0,0 +1,141 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "numa.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cassert>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <pthread.h>
+#endif
+
+using namespace CMSat;
+using std::vector;
+using std::string;
+
+ThreadPinning CMSat::thread_pinning_from_string(const string& mode)
+{
+    if (mode == "none") return ThreadPinning::none;
+    if (mode == "core") return ThreadPinning::core;
+    if (mode == "node") return ThreadPinning::node;
+    throw std::runtime_error("ERROR: unknown thread pinning mode '" + mode
+        + "', must be one of: none, core, node");
+}
+
+#if defined(__linux__)
+// Parses the kernel's cpulist format, e.g. "0-3,8-11"
+static vector<int> parse_cpulist(const string& str)
+{
+    vector<int> cpus;
+    std::stringstream ss(str);
+    string range;
+    while(std::getline(ss, range, ',')) {
+        if (range.empty() || range == "\n") continue;
+        const size_t dash = range.find('-');
+        int from, to;
+        try {
+            from = std::stoi(range.substr(0, dash));
+            to = (dash == string::npos) ? from : std::stoi(range.substr(dash+1));
+        } catch (std::exception&) {
+            return vector<int>();
+        }
+        for(int c = from; c <= to; c++) cpus.push_back(c);
+    }
+    return cpus;
+}
+#endif
+
+NumaTopology::NumaTopology()
+{
+    #if defined(__linux__)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    const bool have_allowed = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+    auto is_allowed = [&](int c) {
+        return !have_allowed || (c < CPU_SETSIZE && CPU_ISSET(c, &allowed));
+    };
+
+    for(int n = 0; ; n++) {
+        std::ifstream f("/sys/devices/system/node/node" + std::to_string(n) + "/cpulist");
+        if (!f) break;
+        string line;
+        std::getline(f, line);
+        vector<int> cpus;
+        for(int c: parse_cpulist(line)) if (is_allowed(c)) cpus.push_back(c);
+        if (!cpus.empty()) nodes.push_back(cpus);
+    }
+
+    if (nodes.empty()) {
+        vector<int> cpus;
+        for(int c = 0; c < CPU_SETSIZE; c++) if (have_allowed && is_allowed(c)) cpus.push_back(c);
+        if (!cpus.empty()) nodes.push_back(cpus);
+    }
+    #endif
+
+    if (nodes.empty()) {
+        vector<int> cpus;
+        const int num = std::max<int>(1, std::thread::hardware_concurrency());
+        for(int c = 0; c < num; c++) cpus.push_back(c);
+        nodes.push_back(cpus);
+    }
+}
+
+vector<int> NumaTopology::cpus_for_thread(ThreadPinning mode, unsigned thread_num) const
+{
+    assert(!nodes.empty());
+    const vector<int>& cpus = nodes[thread_num % nodes.size()];
+    switch(mode) {
+        case ThreadPinning::none:
+            return vector<int>();
+        case ThreadPinning::node:
+            return cpus;
+        case ThreadPinning::core: {
+            const size_t at = (thread_num / nodes.size()) % cpus.size();
+            return vector<int>(1, cpus[at]);
+        }
+    }
+    assert(false);
+    return vector<int>();
+}
+
+bool NumaTopology::pin_this_thread(ThreadPinning mode, unsigned thread_num) const
+{
+    if (mode == ThreadPinning::none) return true;
+
+    #if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(int c: cpus_for_thread(mode, thread_num)) {
+        if (c < CPU_SETSIZE) CPU_SET(c, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    #else
+    return false;
+    #endif
+}
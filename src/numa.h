@@ -0,0 +1,66 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#ifndef CMS_NUMA_H
+#define CMS_NUMA_H
+
+#include <vector>
+#include <string>
+
+namespace CMSat {
+
+enum class ThreadPinning {
+    none = 0 //let the OS place the threads
+    , core = 1 //thread i on a single core, nodes taken round-robin
+    , node = 2 //thread i on all cores of node (i % nodes)
+};
+
+ThreadPinning thread_pinning_from_string(const std::string& mode);
+
+// The CPUs this process may run on, grouped by NUMA node. Read from
+// /sys/devices/system/node on Linux; elsewhere, or if that is missing,
+// there is a single node with all CPUs.
+//
+// Pinning a solver thread before it adds its variables and clauses makes
+// the kernel's first-touch policy allocate its clause arena, watchlists
+// and variable data on the node it runs on.
+class NumaTopology
+{
+public:
+    NumaTopology();
+    size_t num_nodes() const { return nodes.size(); }
+    const std::vector<int>& cpus_of_node(size_t node) const { return nodes[node]; }
+
+    //The CPUs thread "thread_num" is allowed to run on, empty if any
+    std::vector<int> cpus_for_thread(ThreadPinning mode, unsigned thread_num) const;
+
+    //Returns false if pinning is not supported or failed
+    bool pin_this_thread(ThreadPinning mode, unsigned thread_num) const;
+
+private:
+    std::vector<std::vector<int>> nodes;
+};
+
+}
+
+#endif //CMS_NUMA_H
@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include <limits>
 #include <cmath>
 #include <functional>
+#include <queue>
 
 #include "occsimplifier.h"
 #include "clause.h"
@@ -54,6 +55,7 @@ THE SOFTWARE.
 #include "xorfinder.h"
 #include "gatefinder.h"
 #include "trim.h"
+#include "trace.h"
 extern "C" {
 #include "mpicosat/mpicosat.h"
 }
@@ -231,50 +233,198 @@ void OccSimplifier::extend_model(SolutionExtender* extender)
     print_elimed_clauses_reverse();
     #endif
 
+    if (!solver->conf.incremental_extend || elimed_cls.empty()) {
+        extend_model_full(extender);
+        ext_prev_base.clear();
+    } else {
+        const bool cone = build_ext_index()
+            && ext_prev_base.size() == solver->model.size();
+        ext_base = solver->model;
+        if (cone) extend_model_cone(extender);
+        else extend_model_full(extender);
+
+        #ifdef SLOW_DEBUG
+        if (cone) {
+            const vector<lbool> cone_model = solver->model;
+            solver->model = ext_base;
+            extend_model_full(extender);
+            assert(solver->model == cone_model);
+        }
+        #endif
+        std::swap(ext_prev_base, ext_base);
+        ext_prev_model = solver->model;
+    }
+
+    if (solver->conf.verbosity >= 2) {
+        cout << "c [extend] Extended " << ext_num_extended
+        << " of " << elimed_cls.size() << " var-elim clauses" << endl;
+    }
+}
+
+//Sets the value of the var the clauses were eliminated on
+void OccSimplifier::extend_elimed(
+    SolutionExtender* extender,
+    const ElimedClauses& elimed,
+    vector<Lit>& lits
+) {
+    Lit elimed_on = solver->varReplacer->get_lit_replaced_with_outer(elimed.at(0, elimed_cls_lits));
+    size_t at = 1;
+    bool satisfied = false;
+    lits.clear();
+    while(at < elimed.size()) {
+        //built clause, reached marker, "lits" is now valid
+        if (elimed.at(at, elimed_cls_lits) == lit_Undef) {
+            if (!satisfied) {
+                [[maybe_unused]] bool var_set;
+                if (!elimed.is_xor) var_set = extender->add_cl(lits, elimed_on.var());
+                else var_set =extender->add_xor_cl(lits, elimed_on.var());
+
+
+                #ifndef DEBUG_VARELIM
+                //all should be satisfied in fact
+                //no need to go any further
+                if (var_set) break;
+                #endif
+            }
+            satisfied = false;
+            lits.clear();
+
+        //Building clause, "lits" is not yet valid
+        } else if (!satisfied) {
+            Lit l = elimed.at(at, elimed_cls_lits);
+            l = solver->varReplacer->get_lit_replaced_with_outer(l);
+            lits.push_back(l);
+
+            //Elimed clause can be skipped, it's satisfied
+            if (!elimed.is_xor && solver->model_value(l) == l_True) satisfied = true;
+        }
+        at++;
+    }
+    extender->dummy_elimed(elimed_on.var());
+}
+
+void OccSimplifier::extend_model_full(SolutionExtender* extender)
+{
     //go through in reverse order
     vector<Lit> lits;
+    ext_num_extended = 0;
     for (long int i = (int)elimed_cls.size()-1; i >= 0; i--) {
-        ElimedClauses* it = &elimed_cls[i];
-        if (it->toRemove) continue;
+        const ElimedClauses& elimed = elimed_cls[i];
+        if (elimed.toRemove) continue;
+        extend_elimed(extender, elimed, lits);
+        ext_num_extended++;
+    }
+}
 
-        Lit elimed_on = solver->varReplacer->get_lit_replaced_with_outer(it->at(0, elimed_cls_lits));
-        size_t at = 1;
-        bool satisfied = false;
-        lits.clear();
-        while(at < it->size()) {
-            //built clause, reached marker, "lits" is now valid
-            if (it->at(at, elimed_cls_lits) == lit_Undef) {
-                if (!satisfied) {
-                    [[maybe_unused]] bool var_set;
-                    if (!it->is_xor) var_set = extender->add_cl(lits, elimed_on.var());
-                    else var_set =extender->add_xor_cl(lits, elimed_on.var());
-
-
-                    #ifndef DEBUG_VARELIM
-                    //all should be satisfied in fact
-                    //no need to go any further
-                    if (var_set) break;
-                    #endif
-                }
-                satisfied = false;
-                lits.clear();
+//Only the entries whose clauses contain a var that changed since the
+//previous model are re-extended, in reverse order. The rest keep the value
+//they had in the previous model. A re-extended entry whose value changed
+//makes the entries further down the stack that depend on it dirty
+void OccSimplifier::extend_model_cone(SolutionExtender* extender)
+{
+    vector<lbool>& model = solver->model;
+    assert(ext_prev_base.size() == model.size());
+    assert(ext_prev_model.size() == model.size());
 
-            //Building clause, "lits" is not yet valid
-            } else if (!satisfied) {
-                Lit l = it->at(at, elimed_cls_lits);
-                l = solver->varReplacer->get_lit_replaced_with_outer(l);
-                lits.push_back(l);
+    std::priority_queue<uint32_t> dirty;
+    const auto make_dirty = [&](const uint32_t v) {
+        for(uint32_t k = ext_occ_start[v]; k < ext_occ_start[v+1]; k++) {
+            const uint32_t at = ext_occ[k];
+            if (ext_dirty[at]) continue;
+            ext_dirty[at] = 1;
+            dirty.push(at);
+        }
+    };
+
+    //Eliminated vars, and the vars replaced by them, are all unset here
+    for(uint32_t v = 0; v < model.size(); v++) {
+        if (model[v] != ext_prev_base[v]) make_dirty(v);
+        else if (model[v] == l_Undef) model[v] = ext_prev_model[v];
+    }
 
-                //Elimed clause can be skipped, it's satisfied
-                if (!it->is_xor && solver->model_value(l) == l_True) satisfied = true;
+    vector<Lit> lits;
+    ext_num_extended = 0;
+    while(!dirty.empty()) {
+        const uint32_t at = dirty.top();
+        dirty.pop();
+        ext_dirty[at] = 0;
+        const uint32_t on = ext_elimed_on[at];
+        assert(on != var_Undef);
+
+        model[on] = l_Undef;
+        if (ext_replacing[at]) solver->varReplacer->unextend_model(on);
+        extend_elimed(extender, elimed_cls[at], lits);
+        ext_num_extended++;
+        if (model[on] != ext_prev_model[on]) make_dirty(on);
+    }
+}
+
+//Indexes, for every var, the entries of elimed_cls whose clauses contain
+//it. Returns false if the index cannot be used, i.e. if a var is
+//eliminated twice, or an entry contains a var that is eliminated by an
+//entry extended after it
+bool OccSimplifier::build_ext_index()
+{
+    const uint32_t n = solver->nVarsOuter();
+    const size_t num_replaced = solver->varReplacer->get_num_replaced_vars();
+    if (ext_index_built
+        && ext_num_replaced == num_replaced
+        && ext_occ_start.size() == n+1
+    ) {
+        return ext_index_ok;
+    }
+    ext_index_built = true;
+    ext_index_ok = false;
+    ext_num_replaced = num_replaced;
+    ext_prev_base.clear();
+
+    vector<uint32_t> entry_of(n, var_Undef);
+    ext_elimed_on.assign(elimed_cls.size(), var_Undef);
+    ext_replacing.assign(elimed_cls.size(), 0);
+    for(uint32_t i = 0; i < elimed_cls.size(); i++) {
+        if (elimed_cls[i].toRemove) continue;
+        const Lit on = elimed_cls[i].at(0, elimed_cls_lits);
+        const uint32_t var = solver->varReplacer->get_lit_replaced_with_outer(on).var();
+        //Eliminated twice, the second one would override the first
+        if (entry_of[var] != var_Undef) return false;
+        entry_of[var] = i;
+        ext_elimed_on[i] = var;
+        ext_replacing[i] = solver->varReplacer->var_is_replacing(var);
+    }
+
+    //Count, then fill
+    vector<uint32_t> last(n, var_Undef);
+    ext_occ_start.assign(n+1, 0);
+    for(int pass = 0; pass < 2; pass++) {
+        std::fill(last.begin(), last.end(), var_Undef);
+        for(uint32_t i = 0; i < elimed_cls.size(); i++) {
+            const uint32_t on = ext_elimed_on[i];
+            if (on == var_Undef) continue;
+            const ElimedClauses& elimed = elimed_cls[i];
+            for(uint64_t at = 1; at < elimed.size(); at++) {
+                Lit l = elimed.at(at, elimed_cls_lits);
+                if (l == lit_Undef) continue;
+                const uint32_t var = solver->varReplacer->get_lit_replaced_with_outer(l).var();
+                if (var == on || last[var] == i) continue;
+                //Would be unset when this entry is extended
+                if (entry_of[var] != var_Undef && entry_of[var] < i) return false;
+                last[var] = i;
+                if (pass == 0) ext_occ_start[var+1]++;
+                else ext_occ[ext_occ_start[var]++] = i;
             }
-            at++;
         }
-        extender->dummy_elimed(elimed_on.var());
-    }
-    if (solver->conf.verbosity >= 2) {
-        cout << "c [extend] Extended " << elimed_cls.size() << " var-elim clauses" << endl;
+        if (pass == 0) {
+            for(uint32_t v = 0; v < n; v++) ext_occ_start[v+1] += ext_occ_start[v];
+            ext_occ.resize(ext_occ_start[n]);
+        } else {
+            //Filling moved every start to the next one's
+            for(uint32_t v = n; v > 0; v--) ext_occ_start[v] = ext_occ_start[v-1];
+            ext_occ_start[0] = 0;
+        }
     }
+    ext_dirty.assign(elimed_cls.size(), 0);
+    ext_index_ok = true;
+    return true;
 }
 
 void OccSimplifier::unlink_clause(
@@ -2282,6 +2432,7 @@ bool OccSimplifier::execute_simplifier_strategy(const string& strategy)
 
         token = trim(token);
         std::transform(token.begin(), token.end(), token.begin(), ::tolower);
+        TRACE_SCOPE(token.empty() ? nullptr : token.c_str());
         if (!token.empty() && solver->conf.verbosity) {
             cout << "c --> Executing OCC strategy token: " << token << '\n';
             *solver->frat << __PRETTY_FUNCTION__ << " Executing OCC strategy token:" << token.c_str() << "\n";
@@ -2484,6 +2635,7 @@ bool OccSimplifier::ternary_res()
     //NOTE: the "clauses" here will change in size as we add resolvents
     size_t at = rnd_uint(solver->mtrand, clauses.size()-1);
     for(size_t i = 0; i < clauses.size(); i++) {
+        if ((i&0xfff) == 0xfff && solver->must_interrupt_asap()) break;
         ClOffset offs = clauses[(at+i) % clauses.size()];
         Clause * cl = solver->cl_alloc.ptr(offs);
         *limit_to_decrease -= 10;
@@ -2980,6 +3132,7 @@ bool OccSimplifier::uneliminate(uint32_t var)
     const bool is_xor = elimed_cls[at_elimed_cls].is_xor;
     elimed_cls[at_elimed_cls].toRemove = true;
     can_remove_elimed_clauses = true;
+    ext_index_built = false;
     assert(elimed_cls[at_elimed_cls].at(0, elimed_cls_lits).var() == var);
 
     //Re-insert into Solver
@@ -3235,6 +3388,7 @@ void OccSimplifier::clean_elimed_cls()
 
         if (i->toRemove) {
             elimed_map_built = false;
+            ext_index_built = false;
             i_lits += i->size();
             assert(i_lits == i->end);
             i->start = numeric_limits<uint64_t>::max();
@@ -4682,6 +4836,7 @@ void OccSimplifier::create_dummy_elimed_clause(const Lit lit, bool is_xor)
     elimed_cls_lits.push_back(solver->map_inter_to_outer(lit));
     elimed_cls.push_back(ElimedClauses(elimed_cls_lits.size()-1, elimed_cls_lits.size(), is_xor));
     elimed_map_built = false;
+    ext_index_built = false;
 }
 
 bool OccSimplifier::occ_based_lit_rem(uint32_t var, uint32_t& removed) {
@@ -5249,6 +5404,9 @@ size_t OccSimplifier::mem_used() const
     b += elimed_cls.capacity()*sizeof(ElimedClauses);
     b += elimed_cls_lits.capacity()*sizeof(Lit);
     b += blk_var_to_cls.size()*sizeof(uint32_t);
+    b += (ext_elimed_on.capacity() + ext_occ_start.capacity() + ext_occ.capacity())*sizeof(uint32_t);
+    b += ext_replacing.capacity() + ext_dirty.capacity();
+    b += (ext_base.capacity() + ext_prev_base.capacity() + ext_prev_model.capacity())*sizeof(lbool);
     b += velim_order.mem_used();
     b += varElimComplexity.capacity()*sizeof(int)*2;
     b += elim_calc_need_update.mem_used();
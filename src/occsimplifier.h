@@ -47,6 +47,8 @@ class SolutionExtender;
 class Solver;
 class SubsumeStrengthen;
 class GateFinder;
+class StateWriter;
+class StateReader;
 
 struct ElimedClauses {
     ElimedClauses() = default;
@@ -230,9 +232,12 @@ public:
     template<class T>
     void unserialize_elimed_cls(T& ar);
 #endif
+    void save_state(StateWriter& w) const;
+    void load_state(StateReader& r);
 
 private:
     friend class SubsumeStrengthen;
+    friend struct BenchAccess; //tests/bench/cms_bench.cpp
     SubsumeStrengthen* sub_str;
     void check_cls_sanity();
 
@@ -565,6 +570,28 @@ private:
     void clean_elimed_cls();
     bool can_remove_elimed_clauses = false;
 
+    /////////////////////
+    //Model extension
+    void extend_elimed(SolutionExtender* extender, const ElimedClauses& elimed, vector<Lit>& lits);
+    void extend_model_full(SolutionExtender* extender);
+    void extend_model_cone(SolutionExtender* extender);
+    bool build_ext_index();
+
+    //For extending only the cone of the vars that changed since the
+    //previous model. Indexed by elimed_cls entry, or by outer var
+    bool ext_index_built = false;
+    bool ext_index_ok = false;
+    size_t ext_num_replaced = 0;
+    vector<uint32_t> ext_elimed_on; ///<var_Undef if entry is to be removed
+    vector<uint8_t> ext_replacing; ///<elimed_on is replacing other vars
+    vector<uint32_t> ext_occ_start;
+    vector<uint32_t> ext_occ; ///<entries whose value depends on the var
+    vector<uint8_t> ext_dirty;
+    vector<lbool> ext_base; ///<model before extension
+    vector<lbool> ext_prev_base;
+    vector<lbool> ext_prev_model; ///<previous model after extension
+    uint64_t ext_num_extended = 0; ///<entries re-extended in last call
+
     ///Stats from this run
     Stats runStats;
 
@@ -0,0 +1,333 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <limits>
+#include <iostream>
+#include "streambuffer.h"
+#include "solvertypesmini.h"
+
+namespace CMSat {
+
+// Parses linear pseudo-Boolean problems in the OPB format of the PB competition:
+//
+// * #variable= 3 #constraint= 2
+// +2 x1 -3 ~x2 +1 x3 >= 1 ;
+// +1 x1 +1 x2 = 1 ;
+//
+// Relations can be >=, <= or =. As an extension (also used by
+// scripts/translate_opb.py), a >= or <= constraint may be reified by
+// ending it with "<-> x4" before the ';'. Every constraint is added
+// natively via add_pb_clause(). Objective functions are ignored, only
+// satisfiability is decided. Non-linear terms are not supported.
+template <class C, class S>
+class OpbParser
+{
+    public:
+        OpbParser(S* solver, unsigned _verbosity);
+
+        template <class T> bool parse_opb(T input_stream);
+        static bool is_opb_fname(const std::string& fname);
+
+    private:
+        bool parse_opb_main(C& in);
+        bool parse_comment(C& in);
+        bool parse_objective(C& in);
+        bool parse_constraint(C& in);
+        bool parse_lit(C& in, Lit& lit);
+        bool new_var_if_needed(const uint32_t var);
+        void add(const int64_t cutoff, const bool negate, const Lit out);
+
+        S* solver;
+        unsigned verbosity;
+        size_t lineNum = 0;
+
+        //Reduce temp overhead
+        std::vector<Lit> lits;
+        std::vector<int64_t> coeffs;
+        std::vector<signed> weights;
+
+        size_t constraints_added = 0;
+};
+
+template<class C, class S>
+OpbParser<C, S>::OpbParser(S* _solver, unsigned _verbosity):
+    solver(_solver)
+    , verbosity(_verbosity)
+{}
+
+template<class C, class S>
+bool OpbParser<C, S>::is_opb_fname(const std::string& fname)
+{
+    for(const std::string ext: {".opb", ".opb.gz"}) {
+        if (fname.size() > ext.size() &&
+            fname.compare(fname.size()-ext.size(), ext.size(), ext) == 0) return true;
+    }
+    return false;
+}
+
+template<class C, class S>
+bool OpbParser<C, S>::new_var_if_needed(const uint32_t var)
+{
+    if (var >= (1ULL<<28)) {
+        std::cerr
+        << "ERROR! "
+        << "Variable requested is far too large: " << var + 1 << std::endl
+        << "--> At line " << lineNum+1
+        << std::endl;
+        return false;
+    }
+
+    if (var >= solver->nVars()) solver->new_vars(var - solver->nVars() +1);
+    return true;
+}
+
+template<class C, class S>
+bool OpbParser<C, S>::parse_lit(C& in, Lit& lit)
+{
+    in.skipWhitespace();
+    bool neg = false;
+    if (*in == '~') {
+        neg = true;
+        ++in;
+    }
+    if (*in != 'x') {
+        std::cerr
+        << "PARSE ERROR! At line " << lineNum+1
+        << " we expected a literal such as 'x3' or '~x3'"
+        << std::endl;
+        return false;
+    }
+    ++in;
+    int64_t var;
+    if (!in.template parseInt<int64_t>(var, lineNum+1)) return false;
+    if (var <= 0) {
+        std::cerr
+        << "PARSE ERROR! At line " << lineNum+1
+        << " variable numbers must start at 1"
+        << std::endl;
+        return false;
+    }
+    if (!new_var_if_needed(var-1)) return false;
+    lit = Lit(var-1, neg);
+    return true;
+}
+
+// "#variable= N" in the header tells us the number of variables
+template<class C, class S>
+bool OpbParser<C, S>::parse_comment(C& in)
+{
+    std::string line;
+    while (*in != '\n' && *in != EOF) {
+        line.push_back(*in);
+        ++in;
+    }
+    in.skipLine();
+    lineNum++;
+
+    const std::string tag = "#variable=";
+    const size_t at = line.find(tag);
+    if (lineNum == 1 && at != std::string::npos) {
+        const uint64_t num = std::strtoull(line.c_str() + at + tag.size(), nullptr, 10);
+        if (num > 0 && !new_var_if_needed(num-1)) return false;
+    }
+    return true;
+}
+
+template<class C, class S>
+bool OpbParser<C, S>::parse_objective(C& in)
+{
+    if (verbosity) {
+        std::cout
+        << "c WARNING: OPB objective function at line " << lineNum+1
+        << " is ignored, only satisfiability is decided"
+        << std::endl;
+    }
+    while (*in != ';') {
+        if (*in == EOF) {
+            std::cerr << "PARSE ERROR! Objective function is not terminated with ';'" << std::endl;
+            return false;
+        }
+        if (*in == '\n') lineNum++;
+        ++in;
+    }
+    ++in;
+    in.skipLine();
+    lineNum++;
+    return true;
+}
+
+template<class C, class S>
+void OpbParser<C, S>::add(const int64_t cutoff, const bool negate, const Lit out)
+{
+    weights.clear();
+    for(const int64_t c: coeffs) weights.push_back(negate ? -c : c);
+    solver->add_pb_clause(lits, weights, negate ? -cutoff : cutoff, out);
+    constraints_added++;
+}
+
+template<class C, class S>
+bool OpbParser<C, S>::parse_constraint(C& in)
+{
+    lits.clear();
+    coeffs.clear();
+    const int64_t max_coeff = std::numeric_limits<signed>::max();
+
+    //Terms
+    for (;;) {
+        in.skipWhitespace();
+        if (*in == '>' || *in == '<' || *in == '=') break;
+
+        int64_t coeff;
+        if (!in.template parseInt<int64_t>(coeff, lineNum+1)) return false;
+        if (coeff > max_coeff || coeff < -max_coeff) {
+            std::cerr
+            << "PARSE ERROR! At line " << lineNum+1
+            << " coefficient " << coeff << " is too large"
+            << std::endl;
+            return false;
+        }
+        Lit lit;
+        if (!parse_lit(in, lit)) return false;
+        in.skipWhitespace();
+        if (*in == 'x' || *in == '~') {
+            std::cerr
+            << "PARSE ERROR! At line " << lineNum+1
+            << " non-linear terms (products of literals) are not supported"
+            << std::endl;
+            return false;
+        }
+        lits.push_back(lit);
+        coeffs.push_back(coeff);
+    }
+
+    //Relation
+    std::string rel;
+    while (*in == '>' || *in == '<' || *in == '=') {
+        rel.push_back(*in);
+        ++in;
+    }
+    if (rel != ">=" && rel != "<=" && rel != "=") {
+        std::cerr
+        << "PARSE ERROR! At line " << lineNum+1
+        << " unknown relation '" << rel << "'"
+        << std::endl;
+        return false;
+    }
+
+    int64_t rhs;
+    if (!in.template parseInt<int64_t>(rhs, lineNum+1)) return false;
+    if (rhs > max_coeff || rhs < -max_coeff) {
+        std::cerr
+        << "PARSE ERROR! At line " << lineNum+1
+        << " right hand side " << rhs << " is too large"
+        << std::endl;
+        return false;
+    }
+
+    //Optional reification
+    Lit out = lit_Undef;
+    in.skipWhitespace();
+    if (*in == '<') {
+        for(const char c: {'<', '-', '>'}) {
+            if (*in != c) {
+                std::cerr << "PARSE ERROR! At line " << lineNum+1 << " expected '<->'" << std::endl;
+                return false;
+            }
+            ++in;
+        }
+        if (rel == "=") {
+            std::cerr
+            << "PARSE ERROR! At line " << lineNum+1
+            << " equality constraints cannot be reified"
+            << std::endl;
+            return false;
+        }
+        if (!parse_lit(in, out)) return false;
+        in.skipWhitespace();
+    }
+
+    if (*in != ';') {
+        std::cerr
+        << "PARSE ERROR! At line " << lineNum+1
+        << " constraint is not terminated with ';'"
+        << std::endl;
+        return false;
+    }
+    ++in;
+    in.skipWhitespace();
+    if (!in.skipEOL(lineNum)) return false;
+    lineNum++;
+
+    if (rel == ">=" || rel == "=") add(rhs, false, out);
+    if (rel == "<=" || rel == "=") add(rhs, true, out);
+    return true;
+}
+
+template<class C, class S>
+bool OpbParser<C, S>::parse_opb_main(C& in)
+{
+    for (;;) {
+        in.skipWhitespace();
+        switch (*in) {
+        case EOF:
+            return true;
+        case '*':
+            if (!parse_comment(in)) return false;
+            break;
+        case '\n':
+            in.skipLine();
+            lineNum++;
+            break;
+        case 'm':
+            if (!parse_objective(in)) return false;
+            break;
+        default:
+            if (!parse_constraint(in)) return false;
+            break;
+        }
+    }
+}
+
+template <class C, class S>
+template <class T>
+bool OpbParser<C, S>::parse_opb(T input_stream)
+{
+    const uint32_t origNumVars = solver->nVars();
+    C in(input_stream);
+    if (!parse_opb_main(in)) return false;
+
+    if (verbosity) {
+        std::cout
+        << "c -- pb constraints added: " << constraints_added << std::endl
+        << "c -- vars added " << (solver->nVars() - origNumVars)
+        << std::endl;
+    }
+    return true;
+}
+
+}
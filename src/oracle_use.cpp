@@ -23,6 +23,10 @@ THE SOFTWARE.
 #include "solver.h"
 #include "oracle/oracle.h"
 
+#include <functional>
+#include <memory>
+#include <thread>
+
 using namespace CMSat;
 
 inline vector<int> negate(vector<int> vec) {
@@ -74,6 +78,58 @@ vector<vector<int>> Solver::get_irred_cls_for_oracle() const
     return clauses;
 }
 
+// One oracle vivifying every N-th clause of the list, N being the number of
+// workers. Every oracle holds the whole formula, so what it learns is
+// implied by it. Clauses strengthened by one worker are handed to all the
+// others between rounds.
+struct OracleVivifWorker {
+    std::unique_ptr<sspp::oracle::Oracle> oracle;
+    vector<uint32_t> todo; //indices into the clause list
+    size_t at = 0; //next in todo
+    vector<uint32_t> strengthened; //this round
+    bool out = false; //out of budget, or interrupted
+    bool unsat = false;
+
+    bool finished() const { return at == todo.size(); }
+
+    void round(
+        vector<vector<int>>& clauses
+        , const size_t max_cls
+        , const int64_t max_mems
+        , const std::atomic<bool>& must_interrupt)
+    {
+        for(size_t n = 0; n < max_cls && !finished(); n++, at++) {
+            auto& cl = clauses[todo[at]];
+            for (int j = 0; j < (int)cl.size(); j++) {
+                if (oracle->getStats().mems > max_mems
+                    || must_interrupt.load(std::memory_order_relaxed)
+                ) {
+                    out = true;
+                    return;
+                }
+                auto assump = negate(cl);
+                swapdel(assump, j);
+                auto ret = oracle->Solve(assump, true, 500LL*1000LL*1000LL);
+                if (ret.isUnknown()) {
+                    out = true;
+                    return;
+                }
+                if (ret.isFalse()) {
+                    sort(assump.begin(), assump.end());
+                    cl = negate(assump);
+                    oracle->AddClauseIfNeededAndStr(cl, true);
+                    strengthened.push_back(todo[at]);
+                    j = -1; //start from beginning
+                    if (cl.empty()) {
+                        unsat = true;
+                        return;
+                    }
+                }
+            }
+        }
+    }
+};
+
 bool Solver::oracle_vivif(bool& finished)
 {
     assert(!frat->enabled());
@@ -85,40 +141,79 @@ bool Solver::oracle_vivif(bool& finished)
     if (!okay()) return okay();
     if (nVars() < 10) return okay();
     double my_time = cpuTime();
+    double my_wall_time = real_time_sec();
 
     auto clauses = get_irred_cls_for_oracle();
     detach_and_free_all_irred_cls();
 
-    sspp::oracle::Oracle oracle(nVars(), clauses, {});
-    oracle.SetVerbosity(conf.verbosity);
-    bool sat = false;
-    for (int i = 0; i < (int)clauses.size(); i++) {
-        for (int j = 0; j < (int)clauses[i].size(); j++) {
-            if (oracle.getStats().mems > 1600LL*1000LL*1000LL) goto end;
-            auto assump = negate(clauses[i]);
-            swapdel(assump, j);
-            auto ret = oracle.Solve(assump, true, 500LL*1000LL*1000LL);
-            if (ret.isUnknown()) {
-                goto end;
-            }
-            if (ret.isFalse()) {
-                sort(assump.begin(), assump.end());
-                auto clause = negate(assump);
-                oracle.AddClauseIfNeededAndStr(clause, true);
-                clauses[i] = clause;
-                j = -1; //start from beginning
-                if (clause.empty()) {
-                    ok = false;
-                    return false;
+    //Each worker gets the full mems budget, so with more threads more of
+    //the formula is covered in about the same wall-clock time
+    const uint32_t num_workers = std::max<uint32_t>(1,
+        std::min<size_t>(conf.oracle_vivif_threads, clauses.size()/100+1));
+    const int64_t max_mems = 1600LL*1000LL*1000LL;
+    const size_t merge_every = 500;
+
+    vector<OracleVivifWorker> workers(num_workers);
+    for(uint32_t i = 0; i < clauses.size(); i++) {
+        workers[i % num_workers].todo.push_back(i);
+    }
+    auto run_all = [&](std::function<void(OracleVivifWorker&)> f) {
+        if (num_workers == 1) {
+            f(workers[0]);
+            return;
+        }
+        vector<std::thread> threads;
+        for(auto& w: workers) threads.push_back(std::thread(f, std::ref(w)));
+        for(auto& t: threads) t.join();
+    };
+
+    run_all([&](OracleVivifWorker& w) {
+        w.oracle.reset(new sspp::oracle::Oracle(nVars(), clauses, {}));
+        w.oracle->SetVerbosity(conf.verbosity);
+    });
+
+    uint32_t rounds = 0;
+    uint64_t merged = 0;
+    bool unsat = false;
+    while(true) {
+        bool active = false;
+        for(const auto& w: workers) active |= !w.out && !w.finished();
+        if (!active) break;
+
+        run_all([&](OracleVivifWorker& w) {
+            if (w.out || w.finished()) return;
+            w.round(clauses, merge_every, max_mems, *get_must_interrupt_inter_asap_ptr());
+        });
+        rounds++;
+
+        for(auto& w: workers) unsat |= w.unsat;
+        if (unsat) break;
+        if (num_workers == 1) {
+            workers[0].strengthened.clear();
+            continue;
+        }
+
+        for(auto& w: workers) {
+            std::sort(w.strengthened.begin(), w.strengthened.end());
+            w.strengthened.erase(std::unique(w.strengthened.begin(), w.strengthened.end()),
+                w.strengthened.end());
+            for(const uint32_t at: w.strengthened) {
+                for(auto& w2: workers) {
+                    if (&w2 == &w || w2.out || w2.finished()) continue;
+                    w2.oracle->AddClauseIfNeededAndStr(clauses[at], true);
                 }
-            } else if(!sat) {
-                sat = true;
             }
+            merged += w.strengthened.size();
+            w.strengthened.clear();
         }
     }
-    finished |= true;
+    if (unsat) {
+        ok = false;
+        return false;
+    }
+    finished = true;
+    for(const auto& w: workers) finished &= w.finished();
 
-    end:
     vector<Lit> tmp2;
     for(const auto& cl: clauses) {
         tmp2.clear();
@@ -129,7 +224,16 @@ bool Solver::oracle_vivif(bool& finished)
     }
 
     if (conf.oracle_get_learnts) {
-        for (const auto& cl: oracle.GetLearnedClauses()) {
+        vector<vector<int>> learnts;
+        for(const auto& w: workers) {
+            for (auto cl: w.oracle->GetLearnedClauses()) {
+                std::sort(cl.begin(), cl.end());
+                learnts.push_back(cl);
+            }
+        }
+        std::sort(learnts.begin(), learnts.end());
+        learnts.erase(std::unique(learnts.begin(), learnts.end()), learnts.end());
+        for (const auto& cl: learnts) {
             tmp2.clear();
             for(const auto& l: cl) tmp2.push_back(orc_to_lit(l));
             ClauseStats s;
@@ -142,12 +246,25 @@ bool Solver::oracle_vivif(bool& finished)
         }
     }
 
+    sspp::oracle::Stats st;
+    size_t covered = 0;
+    for(const auto& w: workers) {
+        covered += w.at;
+        st.cache_useful += w.oracle->getStats().cache_useful;
+        st.cache_added += w.oracle->getStats().cache_added;
+        st.learned_units += w.oracle->getStats().learned_units;
+    }
     verb_print(1, "[oracle-vivif] finished: " << finished
-            << " cache-used: " << oracle.getStats().cache_useful
-            << " cache-added: " << oracle.getStats().cache_added
-            << " learnt-units: " << oracle.getStats().learned_units
+            << " cache-used: " << st.cache_useful
+            << " cache-added: " << st.cache_added
+            << " learnt-units: " << st.learned_units
             << " finished (vivif or backbone): " << finished
-            << " T: " << std::setprecision(2) << (cpuTime()-my_time));
+            << " threads: " << num_workers
+            << " rounds: " << rounds
+            << " merged: " << merged
+            << " covered: " << covered << "/" << clauses.size()
+            << " T: " << std::setprecision(2) << (cpuTime()-my_time)
+            << " wallT: " << std::setprecision(2) << (real_time_sec()-my_wall_time));
     return solver->okay();
 }
 
@@ -354,6 +471,7 @@ bool Solver::oracle_sparsify()
             verb_print(1, "[oracle-sparsify] too many mems in oracle, aborting");
             goto fin;
         }
+        if (must_interrupt_asap()) goto fin;
     }
 
     fin:
@@ -0,0 +1,212 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "portfolio.h"
+#include "solverconf.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <functional>
+#include <map>
+#include <cassert>
+
+using namespace CMSat;
+using std::string;
+
+namespace {
+
+template<class T> T parse_num(const string& value)
+{
+    std::istringstream ss(value);
+    T ret;
+    ss >> ret;
+    if (ss.fail() || !ss.eof()) throw std::invalid_argument(value);
+    return ret;
+}
+
+Restart parse_restart(const string& value)
+{
+    if (value == "geom") return Restart::geom;
+    if (value == "luby") return Restart::luby;
+    if (value == "glue") return Restart::glue;
+    if (value == "fixed") return Restart::fixed;
+    if (value == "never") return Restart::never;
+    if (value == "auto") return Restart::automatic;
+    throw std::invalid_argument(value);
+}
+
+//Same names as the --polar command line option
+PolarityMode parse_polarity(const string& value)
+{
+    if (value == "true") return PolarityMode::polarmode_pos;
+    if (value == "false") return PolarityMode::polarmode_neg;
+    if (value == "rnd") return PolarityMode::polarmode_rnd;
+    if (value == "auto") return PolarityMode::polarmode_automatic;
+    if (value == "stable") return PolarityMode::polarmode_best;
+    if (value == "weight") return PolarityMode::polarmode_weighted;
+    throw std::invalid_argument(value);
+}
+
+typedef std::function<void(SolverConf&, const string&)> Setter;
+
+#define CONF_NUM(field) {#field, [](SolverConf& c, const string& v) { \
+    c.field = parse_num<decltype(c.field)>(v);}}
+
+const std::map<string, Setter>& conf_setters()
+{
+    static const std::map<string, Setter> setters = {
+        {"branch_strategy_setup", [](SolverConf& c, const string& v) {c.branch_strategy_setup = v;}},
+        {"restartType", [](SolverConf& c, const string& v) {c.restartType = parse_restart(v);}},
+        {"polarity_mode", [](SolverConf& c, const string& v) {c.polarity_mode = parse_polarity(v);}},
+        {"ratio_keep_glue", [](SolverConf& c, const string& v) {
+            c.ratio_keep_clauses[clean_to_int(ClauseClean::glue)] = parse_num<double>(v);}},
+        {"ratio_keep_activity", [](SolverConf& c, const string& v) {
+            c.ratio_keep_clauses[clean_to_int(ClauseClean::activity)] = parse_num<double>(v);}},
+        CONF_NUM(origSeed),
+        CONF_NUM(restart_first),
+        CONF_NUM(restart_inc),
+        CONF_NUM(varElimRatioPerIter),
+        CONF_NUM(inc_max_temp_lev2_red_cls),
+        CONF_NUM(max_temp_lev2_learnt_clauses),
+        CONF_NUM(glue_put_lev0_if_below_or_eq),
+        CONF_NUM(glue_put_lev1_if_below_or_eq),
+        CONF_NUM(every_lev1_reduce),
+        CONF_NUM(every_lev2_reduce),
+        CONF_NUM(doMinimRedMoreMore),
+        CONF_NUM(max_num_lits_more_more_red_min),
+        CONF_NUM(max_glue_more_minim),
+        CONF_NUM(more_red_minim_limit_binary),
+        CONF_NUM(diff_declev_for_chrono),
+        CONF_NUM(never_stop_search),
+        CONF_NUM(num_conflicts_of_search_inc),
+        CONF_NUM(orig_global_timeout_multiplier),
+        CONF_NUM(do_simplify_problem),
+        CONF_NUM(doVarElim),
+        CONF_NUM(do_bva),
+        CONF_NUM(doFindXors),
+        CONF_NUM(doIntreeProbe),
+        CONF_NUM(doFindAndReplaceEqLits),
+        CONF_NUM(do_distill_clauses),
+        CONF_NUM(doStrSubImplicit),
+    };
+    return setters;
+}
+#undef CONF_NUM
+
+}
+
+bool CMSat::set_conf_option(SolverConf& conf, const string& name, const string& value)
+{
+    const auto& setters = conf_setters();
+    auto it = setters.find(name);
+    if (it == setters.end()) return false;
+    it->second(conf, value);
+    return true;
+}
+
+void Portfolio::parse(std::istream& in, const string& fname)
+{
+    profiles.clear();
+    SolverConf check_conf;
+    string line;
+    size_t line_num = 0;
+    while(std::getline(in, line)) {
+        line_num++;
+        const size_t comment = line.find('#');
+        if (comment != string::npos) line.resize(comment);
+
+        std::istringstream ss(line);
+        string token;
+        Profile prof;
+        bool has_token = false;
+        while(ss >> token) {
+            has_token = true;
+            const size_t eq = token.find('=');
+            auto err = [&](const string& what) {
+                std::stringstream msg;
+                msg << "ERROR: " << fname << ":" << line_num
+                << ": " << what << " '" << token << "'";
+                return std::runtime_error(msg.str());
+            };
+            if (eq == string::npos || eq == 0 || eq+1 == token.size()) {
+                throw err("expected field=value, got");
+            }
+            const string name = token.substr(0, eq);
+            const string value = token.substr(eq+1);
+            if (name == "name") {
+                prof.name = value;
+            } else if (name == "builtin") {
+                try {
+                    prof.builtin = parse_num<int>(value);
+                } catch (std::invalid_argument&) {
+                    throw err("wrong value in");
+                }
+                if (prof.builtin < 0) throw err("wrong value in");
+            } else {
+                bool known;
+                try {
+                    known = set_conf_option(check_conf, name, value);
+                } catch (std::invalid_argument&) {
+                    throw err("wrong value in");
+                }
+                if (!known) throw err("unknown SolverConf field in");
+                prof.overrides.push_back(std::make_pair(name, value));
+            }
+        }
+        if (!has_token) continue;
+        if (prof.name.empty()) prof.name = "line" + std::to_string(line_num);
+        profiles.push_back(prof);
+    }
+    if (profiles.empty()) {
+        throw std::runtime_error("ERROR: " + fname + ": portfolio has no profiles");
+    }
+}
+
+void Portfolio::parse_file(const string& fname)
+{
+    std::ifstream in(fname);
+    if (!in) {
+        throw std::runtime_error("ERROR: cannot open portfolio file '" + fname + "'");
+    }
+    parse(in, fname);
+}
+
+const Portfolio::Profile& Portfolio::profile_for_thread(unsigned thread_num) const
+{
+    assert(!profiles.empty());
+    return profiles[thread_num % profiles.size()];
+}
+
+string Portfolio::profile_name(unsigned thread_num) const
+{
+    if (profiles.empty()) return "default";
+    return profile_for_thread(thread_num).name;
+}
+
+void Portfolio::apply_overrides(SolverConf& conf, unsigned thread_num) const
+{
+    for(const auto& o: profile_for_thread(thread_num).overrides) {
+        set_conf_option(conf, o.first, o.second);
+    }
+}
@@ -0,0 +1,74 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <istream>
+
+namespace CMSat {
+
+class SolverConf;
+
+// A per-thread list of SolverConf overrides. The text format has one line
+// per thread, thread i running the profile on line (i % number of lines):
+//
+//   # comment
+//   name=minisat builtin=1 restartType=luby
+//   branch_strategy_setup=vmtf varElimRatioPerIter=0.4
+//
+// "builtin=N" starts from the N-th built-in thread personality, "name=X"
+// only labels the profile in the statistics. Everything else is
+// "field=value" for a field of SolverConf, see set_conf_option().
+class Portfolio
+{
+public:
+    struct Profile {
+        std::string name;
+        int builtin = -1;
+        std::vector<std::pair<std::string, std::string>> overrides;
+    };
+
+    //Throws std::runtime_error on malformed input or unknown fields
+    void parse(std::istream& in, const std::string& fname = "portfolio");
+    void parse_file(const std::string& fname);
+
+    bool empty() const { return profiles.empty(); }
+    size_t size() const { return profiles.size(); }
+    const Profile& profile_for_thread(unsigned thread_num) const;
+    std::string profile_name(unsigned thread_num) const;
+    void apply_overrides(SolverConf& conf, unsigned thread_num) const;
+
+private:
+    std::vector<Profile> profiles;
+};
+
+//Returns false if "name" is not a field that can be set this way
+bool set_conf_option(SolverConf& conf, const std::string& name, const std::string& value);
+
+}
+
+#endif //PORTFOLIO_H
@@ -51,8 +51,9 @@ bool Solver::full_probe(const bool bin_only)
     std::shuffle(vars.begin(), vars.end(), mtrand);
 
     for(auto const& v: vars) {
-        if ((int64_t)solver->propStats.bogoProps > start_bogoprops + bogoprops_to_use)
-            break;
+        if ((int64_t)solver->propStats.bogoProps > start_bogoprops + bogoprops_to_use
+            || must_interrupt_asap()
+        ) break;
 
         uint32_t min_props;
         Lit l(v, false);
@@ -221,6 +222,7 @@ template<bool bin_only> bool Solver::probe_inter(const Lit l, uint32_t& min_prop
 
 lbool Solver::probe_outside(Lit l, uint32_t& min_props)
 {
+    drop_kept_assumps();
     assert(decisionLevel() == 0);
     assert(l.var() < nVarsOuter());
     if (!ok) return l_False;
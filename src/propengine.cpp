@@ -295,16 +295,16 @@ PropBy PropEngine::gauss_jordan_elim(const Lit p, const uint32_t currLevel)
 }
 
 lbool PropEngine::bnn_prop(
-    const uint32_t bnn_idx, uint32_t level, Lit /*l*/, BNNPropType prop_t)
+    const uint32_t bnn_idx, uint32_t level, Lit /*l*/, BNNPropType prop_t, const int32_t w)
 {
     BNN* bnn = bnns[bnn_idx];
     switch(prop_t) {
         case bnn_neg_t:
-            bnn->ts++;
-            bnn->undefs--;
+            bnn->ts += w;
+            bnn->undefs -= w;
             break;
         case bnn_pos_t:
-            bnn->undefs--;
+            bnn->undefs -= w;
             break;
         case bnn_out_t:
             break;
@@ -312,8 +312,8 @@ lbool PropEngine::bnn_prop(
     #ifdef SLOW_DEBUG
     assert (bnn->ts >= 0);
     assert (bnn->undefs >= 0);
-    assert (bnn->ts <= (int32_t)bnn->size());
-    assert (bnn->undefs <= (int32_t)bnn->size());
+    assert (bnn->ts <= bnn->total_weight());
+    assert (bnn->undefs <= bnn->total_weight());
     #endif
 
     const int32_t ts = bnn->ts;
@@ -355,6 +355,8 @@ lbool PropEngine::bnn_prop(
         return l_True;
     }
 
+    if (bnn->weighted) return bnn_prop_weighted(bnn_idx, bnn, level);
+
     if (
         ((!bnn->set && value(bnn->out) == l_True) || bnn->set) &&
             bnn->cutoff - ts == undefs)
@@ -386,6 +388,43 @@ lbool PropEngine::bnn_prop(
     return l_Undef;
 }
 
+// Slack-based propagation of a weighted BNN. Every undefined literal whose
+// weight is larger than the slack is forced. max_weight lets us skip the
+// scan when no literal can be heavy enough.
+lbool PropEngine::bnn_prop_weighted(const uint32_t bnn_idx, BNN* bnn, uint32_t level)
+{
+    const int32_t ts = bnn->ts;
+    const int32_t undefs = bnn->undefs;
+
+    if ((!bnn->set && value(bnn->out) == l_True) || bnn->set) {
+        //it's TRUE, undefs heavier than what we can lose must be set to 1
+        const int32_t slack = ts + undefs - bnn->cutoff;
+        if (bnn->max_weight <= slack) return l_Undef;
+        for(uint32_t i = 0; i < bnn->size(); i++) {
+            const Lit p = (*bnn)[i];
+            if (bnn->weight(i) > slack && value(p) == l_Undef) {
+                enqueue<false>(p, level, PropBy(bnn_idx, nullptr));
+            }
+        }
+        return l_True;
+    }
+
+    if (!bnn->set && value(bnn->out) == l_False) {
+        //it's FALSE, undefs that would make it reach the cutoff must be set to 0
+        const int32_t slack = bnn->cutoff - 1 - ts;
+        if (bnn->max_weight <= slack) return l_Undef;
+        for(uint32_t i = 0; i < bnn->size(); i++) {
+            const Lit p = (*bnn)[i];
+            if (bnn->weight(i) > slack && value(p) == l_Undef) {
+                enqueue<false>(~p, level, PropBy(bnn_idx, nullptr));
+            }
+        }
+        return l_True;
+    }
+
+    return l_Undef;
+}
+
 vector<Lit>* PropEngine::get_bnn_reason(BNN* bnn, Lit lit)
 {
 //     cout << "Getting BNN reason, lit: " << lit << " bnn: " << *bnn << endl;
@@ -403,11 +442,11 @@ vector<Lit>* PropEngine::get_bnn_reason(BNN* bnn, Lit lit)
         return &bnn_confl_reason;
     }
 
-    auto& reason = varData[lit.var()].reason;
+    auto& reason = varReason[lit.var()];
 //     cout
-//     << " reason lev: " << varData[lit.var()].level
+//     << " reason lev: " << varLevel[lit.var()]
 //     << " sublev: " << varData[lit.var()].sublevel
-//     << " reason type: " << varData[lit.var()].reason.getType()
+//     << " reason type: " << varReason[lit.var()].getType()
 //     << endl;
     assert(reason.isBNN());
     if (reason.bnn_reason_set()) {
@@ -450,13 +489,14 @@ void PropEngine::get_bnn_confl_reason(BNN* bnn, vector<Lit>* ret)
         if (!bnn->set)
             ret->push_back(~bnn->out);
 
-        int32_t need = bnn->size()-bnn->cutoff+1;
-        for(const auto& l: *bnn) {
+        int32_t need = bnn->total_weight()-bnn->cutoff+1;
+        for(uint32_t i = 0; i < bnn->size(); i++) {
+            const Lit l = (*bnn)[i];
             if (value(l) == l_False) {
                ret->push_back(l);
-               need--;
+               need -= bnn->weight(i);
             }
-            if (need == 0) break;
+            if (need <= 0) break;
         }
     }
 
@@ -468,12 +508,13 @@ void PropEngine::get_bnn_confl_reason(BNN* bnn, vector<Lit>* ret)
             ret->push_back(bnn->out);
 
         int32_t need = bnn->cutoff;
-        for(const auto& l: *bnn) {
+        for(uint32_t i = 0; i < bnn->size(); i++) {
+            const Lit l = (*bnn)[i];
             if (value(l) == l_True) {
                 ret->push_back(~l);
-                need--;
+                need -= bnn->weight(i);
             }
-            if (need == 0) break;
+            if (need <= 0) break;
         }
     }
 
@@ -505,14 +546,15 @@ void PropEngine::get_bnn_prop_reason(
 
             //Caused it to meet cutoff
             int32_t need = bnn->cutoff;
-            for(const auto& l: *bnn) {
+            for(uint32_t i = 0; i < bnn->size(); i++) {
+                const Lit l = (*bnn)[i];
                 if (varData[l.var()].sublevel <= varData[lit.var()].sublevel
                     && value(l) == l_True)
                 {
-                    need--;
+                    need -= bnn->weight(i);
                     ret->push_back(~l);
                 }
-                if (need == 0) break;
+                if (need <= 0) break;
             }
         }
 
@@ -522,15 +564,16 @@ void PropEngine::get_bnn_prop_reason(
             ret->push_back(lit); //this is what's propagated, must be 1st
 
             //Caused it to meet cutoff
-            int32_t need = bnn->size()-bnn->cutoff+1;
-            for(const auto& l: *bnn) {
+            int32_t need = bnn->total_weight()-bnn->cutoff+1;
+            for(uint32_t i = 0; i < bnn->size(); i++) {
+                const Lit l = (*bnn)[i];
                 if (varData[l.var()].sublevel <= varData[lit.var()].sublevel
                     && value(l) == l_False)
                 {
-                    need--;
+                    need -= bnn->weight(i);
                     ret->push_back(l);
                 }
-                if (need == 0) break;
+                if (need <= 0) break;
             }
         }
         return;
@@ -652,7 +695,7 @@ bool PropEngine::prop_long_cl_any_order(
             uint32_t nMaxInd = 1;
             // pass over all the literals in the clause and find the one with the biggest level
             for (uint32_t nInd = 2; nInd < c.size(); ++nInd) {
-                uint32_t nLevel = varData[c[nInd].var()].level;
+                uint32_t nLevel = varLevel[c[nInd].var()];
                 if (nLevel > nMaxLevel) {
                     nMaxLevel = nLevel;
                     nMaxInd = nInd;
@@ -672,16 +715,16 @@ bool PropEngine::prop_long_cl_any_order(
     return true;
 }
 
-void CMSat::PropEngine::reverse_one_bnn(uint32_t idx, BNNPropType t) {
+void CMSat::PropEngine::reverse_one_bnn(uint32_t idx, BNNPropType t, const int32_t w) {
     BNN* const bnn= bnns[idx];
     SLOW_DEBUG_DO(assert(bnn != nullptr));
     switch(t) {
         case bnn_neg_t:
-            bnn->ts--;
-            bnn->undefs++;
+            bnn->ts -= w;
+            bnn->undefs += w;
             break;
         case bnn_pos_t:
-            bnn->undefs++;
+            bnn->undefs += w;
             break;
         case bnn_out_t:
             break;
@@ -694,8 +737,8 @@ void CMSat::PropEngine::reverse_one_bnn(uint32_t idx, BNNPropType t) {
 
     SLOW_DEBUG_DO(assert(bnn->ts >= 0));
     SLOW_DEBUG_DO(assert(bnn->undefs >= 0));
-    SLOW_DEBUG_DO(assert(bnn->ts <= (int32_t)bnn->size()));
-    SLOW_DEBUG_DO(assert(bnn->undefs <= (int32_t)bnn->size()));
+    SLOW_DEBUG_DO(assert(bnn->ts <= bnn->total_weight()));
+    SLOW_DEBUG_DO(assert(bnn->undefs <= bnn->total_weight()));
 }
 
 void CMSat::PropEngine::reverse_prop(const CMSat::Lit l)
@@ -704,7 +747,7 @@ void CMSat::PropEngine::reverse_prop(const CMSat::Lit l)
     watch_subarray ws = watches[~l];
     for (const auto& i: ws) {
         if (i.isBNN()) {
-            reverse_one_bnn(i.get_bnn(), i.get_bnn_prop_t());
+            reverse_one_bnn(i.get_bnn(), i.get_bnn_prop_t(), i.get_bnn_weight());
         }
     }
     varData[l.var()].propagated = false;
@@ -743,7 +786,8 @@ PropBy PropEngine::propagate_any_order()
             // propagate BNN constraint
             if (i->isBNN()) {
                 *j++ = *i;
-                const lbool val = bnn_prop(i->get_bnn(), currLevel, p, i->get_bnn_prop_t());
+                const lbool val = bnn_prop(
+                    i->get_bnn(), currLevel, p, i->get_bnn_prop_t(), i->get_bnn_weight());
                 if (val == l_False) confl = PropBy(i->get_bnn(), nullptr);
                 continue;
             }
@@ -837,11 +881,11 @@ void PropEngine::updateVars(
 void PropEngine::print_trail()
 {
     for(size_t i = trail_lim[0]; i < trail.size(); i++) {
-        assert(varData[trail[i].lit.var()].level == trail[i].lev);
+        assert(varLevel[trail[i].lit.var()] == trail[i].lev);
         cout
         << "trail " << i << ":" << trail[i].lit
         << " lev: " << trail[i].lev
-        << " reason: " << varData[trail[i].lit.var()].reason
+        << " reason: " << varReason[trail[i].lit.var()]
         << endl;
     }
 }
@@ -1119,7 +1163,7 @@ vector<Lit>* PropEngine::get_xor_reason(const PropBy& reason, int32_t& ID) {
             cout
             << "l: " << l
             << " value: " << value(l)
-            << " level:" << varData[l.var()].level
+            << " level:" << varLevel[l.var()]
             << " type: " << removed_type_to_string(varData[l.var()].removed)
             << endl;
         }
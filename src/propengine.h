@@ -214,7 +214,7 @@ public:
 
     template<bool inprocess> bool propagate_occur(int64_t* limit_to_decrease);
     void reverse_prop(const Lit l);
-    void reverse_one_bnn(uint32_t idx, BNNPropType t);
+    void reverse_one_bnn(uint32_t idx, BNNPropType t, int32_t w);
     PropStats propStats;
     template<bool inprocess>
     void enqueue(const Lit p, const uint32_t level,
@@ -290,7 +290,8 @@ protected:
     void get_bnn_prop_reason(BNN* bnn, Lit lit, vector<Lit>* ret);
     lbool bnn_prop(
         const uint32_t bnn_idx, uint32_t level,
-        Lit l, BNNPropType prop_t);
+        Lit l, BNNPropType prop_t, const int32_t w);
+    lbool bnn_prop_weighted(const uint32_t bnn_idx, BNN* bnn, uint32_t level);
     void attachClause(
         const Clause& c
         , const bool checkAttach = true
@@ -429,7 +430,7 @@ uint32_t PropEngine::calc_glue(const T& ps)
     MYFLAG++;
     uint32_t nblevels = 0;
     for (Lit lit: ps) {
-        int l = varData[lit.var()].level;
+        int l = varLevel[lit.var()];
         if (l != 0 && permDiff[l] != MYFLAG) {
             permDiff[l] = MYFLAG;
             nblevels++;
@@ -563,8 +564,8 @@ void PropEngine::enqueue(const Lit p, const uint32_t level, const PropBy from, b
 
     const bool sign = p.sign();
     assigns[v] = boolToLBool(!sign);
-    varData[v].reason = from;
-    varData[v].level = level;
+    varReason[v] = from;
+    varLevel[v] = level;
     varData[v].sublevel = trail.size();
 
     if (level == 0 && frat->enabled())
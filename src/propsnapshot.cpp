@@ -0,0 +1,162 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "propsnapshot.h"
+#include "solver.h"
+#include "clauseallocator.h"
+
+using namespace CMSat;
+
+PropSnapshot::PropSnapshot(
+    const Solver* solver
+    , const bool with_red
+    , const vector<ClOffset>& extra
+) :
+    num_vars(solver->nVars())
+{
+    assigns0.resize(num_vars);
+    for(uint32_t v = 0; v < num_vars; v++) assigns0[v] = solver->value(v);
+
+    cl_start.push_back(0);
+    auto add_long = [&](const vector<ClOffset>& offs) {
+        for(const ClOffset off: offs) {
+            const Clause& cl = *solver->cl_alloc.ptr(off);
+            offs_to_idx[off] = cl_start.size()-1;
+            lits.insert(lits.end(), cl.begin(), cl.end());
+            cl_start.push_back(lits.size());
+        }
+    };
+    add_long(solver->longIrredCls);
+    if (with_red) for(const auto& offs: solver->longRedCls) add_long(offs);
+    add_long(extra);
+
+    bins.resize(num_vars*2);
+    for(uint32_t i = 0; i < num_vars*2; i++) {
+        const Lit l = Lit::toLit(i);
+        for(const auto& w: solver->watches[l]) {
+            if (!w.isBin() || (w.red() && !with_red)) continue;
+            bins[l.toInt()].push_back(w.lit2());
+        }
+    }
+}
+
+double PropSnapshot::mem_used() const
+{
+    double mem = lits.capacity()*sizeof(Lit)
+        + cl_start.capacity()*sizeof(uint32_t)
+        + assigns0.capacity()*sizeof(lbool)
+        + offs_to_idx.size()*(sizeof(ClOffset)+sizeof(uint32_t));
+    for(const auto& b: bins) mem += b.capacity()*sizeof(Lit);
+    return mem;
+}
+
+SnapshotPropagator::SnapshotPropagator(const PropSnapshot& _snap) :
+    snap(_snap)
+    , assigns(_snap.assigns0)
+{
+    watched.resize(snap.num_cls()*2);
+    watches.resize(snap.num_vars*2);
+    for(uint32_t cl = 0; cl < snap.num_cls(); cl++) {
+        //Watch the first two literals not false at level 0. Satisfied
+        //clauses can never propagate, they are not watched
+        const Lit* l = cl_lits(cl);
+        uint32_t at = 0;
+        bool sat = false;
+        for(uint32_t i = 0; i < cl_size(cl) && at < 2; i++) {
+            if (value(l[i]) == l_True) sat = true;
+            if (value(l[i]) == l_Undef) watched[cl*2+at++] = i;
+        }
+        if (sat || at < 2) continue;
+        watches[l[watched[cl*2]].toInt()].push_back(Watch{cl, l[watched[cl*2+1]]});
+        watches[l[watched[cl*2+1]].toInt()].push_back(Watch{cl, l[watched[cl*2]]});
+    }
+}
+
+void SnapshotPropagator::cancel_to_level0()
+{
+    for(const Lit l: trail) assigns[l.var()] = l_Undef;
+    trail.clear();
+    qhead = 0;
+}
+
+bool SnapshotPropagator::enqueue_and_propagate(const Lit lit, const uint32_t disabled)
+{
+    assert(value(lit) == l_Undef);
+    assign(lit);
+
+    while(qhead < trail.size()) {
+        const Lit f = ~trail[qhead++];
+
+        vector<Watch>& ws = watches[f.toInt()];
+        props += (snap.bins[f.toInt()].size() + ws.size())/4 + 1;
+        for(const Lit imp: snap.bins[f.toInt()]) {
+            if (value(imp) == l_False) return false;
+            if (value(imp) == l_Undef) assign(imp);
+        }
+
+        uint32_t i = 0;
+        uint32_t j = 0;
+        for(; i < ws.size(); i++) {
+            const Watch w = ws[i];
+            if (w.cl == disabled || value(w.blocker) == l_True) {
+                ws[j++] = w;
+                continue;
+            }
+            props += 4;
+
+            //Make sure pos[1] is the one that became false
+            uint32_t* pos = &watched[w.cl*2];
+            const Lit* l = cl_lits(w.cl);
+            if (l[pos[0]] == f) std::swap(pos[0], pos[1]);
+            const Lit other = l[pos[0]];
+            if (value(other) == l_True) {
+                ws[j++] = Watch{w.cl, other};
+                continue;
+            }
+
+            //Look for a new literal to watch
+            bool found = false;
+            const uint32_t sz = cl_size(w.cl);
+            for(uint32_t k = 0; k < sz; k++) {
+                if (k == pos[0] || k == pos[1]) continue;
+                if (value(l[k]) != l_False) {
+                    pos[1] = k;
+                    watches[l[k].toInt()].push_back(Watch{w.cl, other});
+                    found = true;
+                    break;
+                }
+            }
+            if (found) continue;
+
+            ws[j++] = w;
+            if (value(other) == l_False) {
+                for(i++; i < ws.size(); i++) ws[j++] = ws[i];
+                ws.resize(j);
+                return false;
+            }
+            assign(other);
+        }
+        ws.resize(j);
+    }
+    return true;
+}
@@ -0,0 +1,111 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#ifndef CMS_PROPSNAPSHOT_H
+#define CMS_PROPSNAPSHOT_H
+
+#include <vector>
+#include <unordered_map>
+#include <limits>
+#include "solvertypes.h"
+#include "cloffset.h"
+
+namespace CMSat {
+
+using std::vector;
+
+class Solver;
+
+// A frozen, read-only copy of the long and binary clauses and the level-0
+// assignment of the solver. Any number of SnapshotPropagator-s, e.g. one per
+// worker thread, can propagate over it while the solver itself is left
+// untouched.
+class PropSnapshot
+{
+public:
+    //with_red: also copy the redundant clauses
+    //extra: long clauses not currently in the solver's clause lists
+    PropSnapshot(const Solver* solver, const bool with_red, const vector<ClOffset>& extra);
+
+    static constexpr uint32_t no_idx = std::numeric_limits<uint32_t>::max();
+    uint32_t index_of(const ClOffset offs) const {
+        auto it = offs_to_idx.find(offs);
+        return it == offs_to_idx.end() ? no_idx : it->second;
+    }
+    uint32_t num_cls() const { return cl_start.size()-1; }
+    double mem_used() const;
+
+private:
+    friend class SnapshotPropagator;
+    uint32_t num_vars;
+    vector<lbool> assigns0;
+    vector<Lit> lits; //long clause i is lits[cl_start[i]..cl_start[i+1])
+    vector<uint32_t> cl_start;
+    vector<vector<Lit>> bins; //bins[l]: lits implied once l is false
+    std::unordered_map<ClOffset, uint32_t> offs_to_idx;
+};
+
+// 2-watched-literal propagation over a PropSnapshot. Watches store positions
+// into the shared clause literals, so nothing in the snapshot is written.
+class SnapshotPropagator
+{
+public:
+    explicit SnapshotPropagator(const PropSnapshot& snap);
+
+    lbool value(const Lit l) const { return assigns[l.var()] ^ l.sign(); }
+
+    //Sets "l" and propagates, ignoring clause "disabled". False on conflict.
+    bool enqueue_and_propagate(const Lit l, const uint32_t disabled);
+    void cancel_to_level0();
+
+    //Counted the same way as PropStats::bogoProps during inprocessing
+    uint64_t props = 0;
+
+private:
+    struct Watch {
+        uint32_t cl;
+        Lit blocker;
+    };
+    void assign(const Lit l) {
+        assigns[l.var()] = boolToLBool(!l.sign());
+        trail.push_back(l);
+        props++;
+    }
+    const Lit* cl_lits(const uint32_t cl) const {
+        return snap.lits.data() + snap.cl_start[cl];
+    }
+    uint32_t cl_size(const uint32_t cl) const {
+        return snap.cl_start[cl+1] - snap.cl_start[cl];
+    }
+
+    const PropSnapshot& snap;
+    vector<lbool> assigns;
+    vector<Lit> trail;
+    uint32_t qhead = 0;
+    vector<uint32_t> watched; //the 2 watched positions of each clause
+    vector<vector<Watch>> watches;
+};
+
+}
+
+#endif //CMS_PROPSNAPSHOT_H
@@ -24,6 +24,7 @@ THE SOFTWARE.
 #include "solver.h"
 #include "solverconf.h"
 #include "sqlstats.h"
+#include "trace.h"
 #ifdef FINAL_PREDICTOR
 #include "cl_predictors_xgb.h"
 #include "cl_predictors_lgbm.h"
@@ -247,10 +248,12 @@ void ReduceDB::gather_normal_cl_use_stats()
 //kept no. of clauses as other solvers do
 void ReduceDB::handle_lev2()
 {
+    TRACE_SCOPE("reducedb-lev2");
     solver->dump_memory_stats_to_sql();
     size_t orig_size = solver->longRedCls[2].size();
 
     const double my_time = cpuTime();
+    const double my_wall_time = real_time_sec();
     assert(solver->watches.get_smudged_list().empty());
 
     //lev2 -- clean
@@ -301,6 +304,7 @@ void ReduceDB::handle_lev2()
         );
     }
     total_time += cpuTime()-my_time;
+    solver->metrics->record(Metrics::reducedb_pause, real_time_sec()-my_wall_time);
 
     last_reducedb_num_conflicts = solver->sumConflicts;
 }
@@ -532,6 +536,7 @@ void ReduceDB::dump_sql_cl_data(
 
 void ReduceDB::handle_lev1()
 {
+    TRACE_SCOPE("reducedb-lev1");
     #ifdef VERBOSE_DEBUG
     cout << "c handle_lev1()" << endl;
     #endif
@@ -540,6 +545,7 @@ void ReduceDB::handle_lev1()
     uint32_t used_recently = 0;
     uint32_t non_recent_use = 0;
     double my_time = cpuTime();
+    const double my_wall_time = real_time_sec();
     size_t orig_size = solver->longRedCls[1].size();
 
     size_t j = 0;
@@ -609,6 +615,7 @@ void ReduceDB::handle_lev1()
         );
     }
     total_time += cpuTime()-my_time;
+    solver->metrics->record(Metrics::reducedb_pause, real_time_sec()-my_wall_time);
 }
 
 #ifdef FINAL_PREDICTOR
@@ -1036,6 +1043,7 @@ void ReduceDB::dump_pred_distrib(const vector<ClOffset>& offs, uint32_t lev) {
 
 void ReduceDB::handle_predictors()
 {
+    TRACE_SCOPE("reducedb-pred");
     if (solver->conf.dump_pred_distrib && num_times_pred_called == 0) {
         std::ofstream distrib_file("pred_distrib.csv");
         distrib_file
@@ -1106,6 +1114,7 @@ void ReduceDB::handle_predictors()
 
     assert(delayed_clause_free.empty());
     double my_time = cpuTime();
+    const double my_wall_time = real_time_sec();
 
     //Pre-reset, calculate common features
     vector<ClOffset> all_learnt;
@@ -1200,6 +1209,7 @@ void ReduceDB::handle_predictors()
         );
     }
     total_time += cpuTime()-my_time;
+    solver->metrics->record(Metrics::reducedb_pause, real_time_sec()-my_wall_time);
 }
 #endif
 
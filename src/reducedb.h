@@ -97,6 +97,7 @@ private:
     void remove_cl_from_lev2();
 
     void sort_red_cls(ClauseClean clean_type);
+    friend struct BenchAccess; //tests/bench/cms_bench.cpp
     void mark_top_N_clauses_lev2(const uint64_t keep_num);
 
     #ifdef FINAL_PREDICTOR
@@ -45,33 +45,39 @@ bool SCCFinder::performSCC(uint64_t* bogoprops_given)
     assert(binxors.empty());
     runStats.clear();
     runStats.numCalls = 1;
-    depth_warning_issued = false;
     const double my_time = cpuTime();
+    const uint32_t num_vertices = solver->nVars()*2;
 
+    build_graph();
     globalIndex = 0;
     index.clear();
-    index.resize(solver->nVars()*2, numeric_limits<uint32_t>::max());
+    index.resize(num_vertices, numeric_limits<uint32_t>::max());
     lowlink.clear();
-    lowlink.resize(solver->nVars()*2, numeric_limits<uint32_t>::max());
+    lowlink.resize(num_vertices, numeric_limits<uint32_t>::max());
+    next_succ.clear();
+    next_succ.resize(num_vertices);
     stackIndicator.clear();
-    stackIndicator.resize(solver->nVars()*2, false);
+    stackIndicator.resize(num_vertices, false);
     assert(stack.empty());
+    assert(call_stack.empty());
 
-    depth = 0;
-    for (uint32_t vertex = 0; vertex < solver->nVars()*2; vertex++) {
+    for (uint32_t vertex = 0; vertex < num_vertices; vertex++) {
         //Start a DFS at each node we haven't visited yet
         const uint32_t v = vertex>>1;
-        if (solver->value(v) != l_Undef) {
+        if (solver->value(v) != l_Undef
+            || solver->varData[v].removed != Removed::none
+        ) {
             continue;
         }
-        assert(depth == 0);
         if (index[vertex] == numeric_limits<uint32_t>::max()) {
             tarjan(vertex);
-            depth--;
             assert(stack.empty());
         }
     }
 
+    //The snapshot can be large, don't keep it around between calls
+    vector<uint32_t>().swap(succ);
+
     //Update & print stats
     runStats.cpu_time = cpuTime() - my_time;
     runStats.foundXorsNew = binxors.size();
@@ -90,59 +96,107 @@ bool SCCFinder::performSCC(uint64_t* bogoprops_given)
     return solver->okay();
 }
 
-void SCCFinder::tarjan(const uint32_t vertex)
+// Takes a snapshot of the binary implication graph: an edge v -> l2 for every
+// binary clause (~v V l2) where l2 is unassigned and not removed. Walking the
+// flat arrays is much cheaper than re-scanning the watchlists (that also
+// contain long clauses, BNNs, etc.) during the DFS.
+void SCCFinder::build_graph()
 {
-    depth++;
-    if (depth >= (uint32_t)solver->conf.max_scc_depth) {
-        if (solver->conf.verbosity && !depth_warning_issued) {
-            depth_warning_issued = true;
-            cout << "c [scc] WARNING: reached maximum depth of " << solver->conf.max_scc_depth << endl;
+    const uint32_t num_vertices = solver->nVars()*2;
+    succ_start.clear();
+    succ_start.resize(num_vertices+1);
+    succ.clear();
+
+    for (uint32_t vertex = 0; vertex < num_vertices; vertex++) {
+        succ_start[vertex] = succ.size();
+        const Lit vertLit = Lit::toLit(vertex);
+        if (solver->value(vertLit) != l_Undef
+            || solver->varData[vertLit.var()].removed != Removed::none
+        ) {
+            continue;
         }
-        return;
-    }
 
-    const Lit vertLit = Lit::toLit(vertex);
-    if (solver->varData[vertLit.var()].removed != Removed::none) {
-        return;
+        watch_subarray_const ws = solver->watches[~vertLit];
+        runStats.bogoprops += ws.size()/4;
+        for (const Watched& w: ws) {
+            //Only binary clauses matter
+            if (!w.isBin())
+                continue;
+
+            const Lit lit = w.lit2();
+            if (solver->value(lit) != l_Undef
+                || solver->varData[lit.var()].removed != Removed::none
+            ) {
+                continue;
+            }
+            succ.push_back(lit.toInt());
+        }
     }
+    succ_start[num_vertices] = succ.size();
+}
 
+void SCCFinder::visit(const uint32_t vertex)
+{
     runStats.bogoprops += 1;
     index[vertex] = globalIndex;  // Set the depth index for v
     lowlink[vertex] = globalIndex;
     globalIndex++;
-    stack.push(vertex); // Push v on the stack
+    next_succ[vertex] = succ_start[vertex];
+    stack.push_back(vertex); // Push v on the stack
     stackIndicator[vertex] = true;
+    call_stack.push_back(vertex);
+}
 
-    //Go through the watch
-    watch_subarray_const ws = solver->watches[~vertLit];
-    runStats.bogoprops += ws.size()/4;
-    for (const Watched& w: ws) {
-        //Only binary clauses matter
-        if (!w.isBin())
-            continue;
+// Iterative version of Tarjan's algorithm. call_stack holds the vertices that
+// the recursive version would have on the C++ stack, and next_succ remembers
+// where we left off in each of their successor lists. Hence there is no limit
+// on the depth of the DFS.
+void SCCFinder::tarjan(const uint32_t root)
+{
+    assert(call_stack.empty());
+    visit(root);
 
-        const Lit lit = w.lit2();
-        if (solver->value(lit) != l_Undef) {
+    while (!call_stack.empty()) {
+        const uint32_t vertex = call_stack.back();
+        if (next_succ[vertex] < succ_start[vertex+1]) {
+            const uint32_t w = succ[next_succ[vertex]++];
+
+            // Was successor w visited?
+            if (index[w] == numeric_limits<uint32_t>::max()) {
+                visit(w);
+            } else if (stackIndicator[w]) {
+                lowlink[vertex] = std::min(lowlink[vertex], index[w]);
+            }
             continue;
         }
-        doit(lit, vertex);
-    }
 
-    // Is v the root of an SCC?
-    if (lowlink[vertex] == index[vertex]) {
-        uint32_t vprime;
-        tmp.clear();
-        do {
-            assert(!stack.empty());
-            vprime = stack.top();
-            stack.pop();
-            stackIndicator[vprime] = false;
-            tmp.push_back(vprime);
-        } while (vprime != vertex);
-        if (tmp.size() >= 2) {
-            runStats.bogoprops += 3;
-            add_bin_xor_in_tmp();
+        //All successors done, "return" from vertex
+        call_stack.pop_back();
+        if (lowlink[vertex] == index[vertex]) {
+            pop_scc(vertex);
         }
+        if (!call_stack.empty()) {
+            const uint32_t parent = call_stack.back();
+            lowlink[parent] = std::min(lowlink[parent], lowlink[vertex]);
+        }
+    }
+}
+
+// Vertex is the root of an SCC, pop it off the stack
+void SCCFinder::pop_scc(const uint32_t vertex)
+{
+    uint32_t vprime;
+    tmp.clear();
+    do {
+        assert(!stack.empty());
+        vprime = stack.back();
+        stack.pop_back();
+        stackIndicator[vprime] = false;
+        tmp.push_back(vprime);
+    } while (vprime != vertex);
+    if (tmp.size() >= 2) {
+        runStats.bogoprops += 3;
+        add_bin_xor_in_tmp();
     }
 }
 
@@ -199,7 +253,11 @@ size_t SCCFinder::mem_used() const
     size_t mem = 0;
     mem += index.capacity()*sizeof(uint32_t);
     mem += lowlink.capacity()*sizeof(uint32_t);
-    mem += stack.size()*sizeof(uint32_t); //TODO under-estimates
+    mem += next_succ.capacity()*sizeof(uint32_t);
+    mem += call_stack.capacity()*sizeof(uint32_t);
+    mem += stack.capacity()*sizeof(uint32_t);
+    mem += succ_start.capacity()*sizeof(uint32_t);
+    mem += succ.capacity()*sizeof(uint32_t);
     mem += stackIndicator.capacity()*sizeof(char);
     mem += tmp.capacity()*sizeof(uint32_t);
 
@@ -24,7 +24,6 @@ THE SOFTWARE.
 #define SCCFINDER_H
 
 #include "clause.h"
-#include <stack>
 #include <set>
 
 namespace CMSat {
@@ -98,22 +97,28 @@ class SCCFinder {
 
         const Stats& get_stats() const;
         size_t mem_used() const;
-        bool depth_warning_triggered() const;
 
     private:
-        void tarjan(const uint32_t vertex);
-        bool depth_warning_issued;
-        void doit(const Lit lit, const uint32_t vertex);
+        void build_graph();
+        void tarjan(const uint32_t root);
+        void visit(const uint32_t vertex);
+        void pop_scc(const uint32_t vertex);
         void add_bin_xor_in_tmp();
 
+        //Snapshot of the binary implication graph in CSR form:
+        //successors of vertex v are succ[succ_start[v]..succ_start[v+1])
+        vector<uint32_t> succ_start;
+        vector<uint32_t> succ;
+
         //temporaries
         uint32_t globalIndex;
         vector<uint32_t> index;
         vector<uint32_t> lowlink;
-        std::stack<uint32_t, vector<uint32_t> > stack;
+        vector<uint32_t> next_succ; //next successor to explore, per vertex
+        vector<uint32_t> call_stack; //replaces recursion
+        vector<uint32_t> stack;
         vector<char> stackIndicator;
         vector<uint32_t> tmp;
-        uint32_t depth;
 
         Solver* solver;
         std::set<BinaryXor> binxors;
@@ -123,22 +128,6 @@ class SCCFinder {
         Stats globalStats;
 };
 
-inline void SCCFinder::doit(const Lit lit, const uint32_t vertex) {
-    // Was successor v' visited?
-    if (index[lit.toInt()] ==  numeric_limits<uint32_t>::max()) {
-        tarjan(lit.toInt());
-        depth--;
-        lowlink[vertex] = std::min(lowlink[vertex], lowlink[lit.toInt()]);
-    } else if (stackIndicator[lit.toInt()])  {
-        lowlink[vertex] = std::min(lowlink[vertex], lowlink[lit.toInt()]);
-    }
-}
-
-inline bool SCCFinder::depth_warning_triggered() const
-{
-    return depth_warning_issued;
-}
-
 inline const SCCFinder::Stats& SCCFinder::get_stats() const
 {
     return globalStats;
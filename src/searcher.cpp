@@ -41,6 +41,7 @@ THE SOFTWARE.
 
 #include "sqlstats.h"
 #include "datasync.h"
+#include "trace.h"
 #include "reducedb.h"
 #include "watchalgos.h"
 #include "hasher.h"
@@ -175,7 +176,7 @@ inline void Searcher::add_lit_to_learnt(
     }
     #endif
 
-    if (varData[var].level == 0) {
+    if (varLevel[var] == 0) {
         if (frat->enabled()) {
             assert(value(var) != l_Undef);
             assert(unit_cl_IDs[var] != 0);
@@ -190,11 +191,11 @@ inline void Searcher::add_lit_to_learnt(
 
     if (!inprocess) {
         #ifdef STATS_NEEDED_BRANCH
-        if (varData[var].level != 0 &&
-            !level_used_for_cl_arr[varData[var].level]
+        if (varLevel[var] != 0 &&
+            !level_used_for_cl_arr[varLevel[var]]
         ) {
-            level_used_for_cl_arr[varData[var].level] = 1;
-            level_used_for_cl.push_back(varData[var].level);
+            level_used_for_cl_arr[varLevel[var]] = 1;
+            level_used_for_cl.push_back(varLevel[var]);
         }
         #endif
 
@@ -212,7 +213,7 @@ inline void Searcher::add_lit_to_learnt(
         }
     }
 
-    if (varData[var].level >= nDecisionLevel) {
+    if (varLevel[var] >= nDecisionLevel) {
         pathC++;
     } else {
         learnt_clause.push_back(lit);
@@ -229,7 +230,7 @@ inline void Searcher::recursiveConfClauseMin()
 
     size_t i, j;
     for (i = j = 1; i < learnt_clause.size(); i++) {
-        if (varData[learnt_clause[i].var()].reason.isnullptr()
+        if (varReason[learnt_clause[i].var()].isnullptr()
             || !litRedundant(learnt_clause[i], abstract_level)
         ) {
             learnt_clause[j++] = learnt_clause[i];
@@ -243,7 +244,7 @@ void Searcher::normalClMinim()
 {
     size_t i,j;
     for (i = j = 1; i < learnt_clause.size(); i++) {
-        const PropBy& reason = varData[learnt_clause[i].var()].reason;
+        const PropBy& reason = varReason[learnt_clause[i].var()];
         size_t size;
         Lit *lits = nullptr;
         int32_t ID;
@@ -303,7 +304,7 @@ void Searcher::normalClMinim()
                 default: release_assert(false);
             }
 
-            if (!seen[p.var()] && varData[p.var()].level > 0) {
+            if (!seen[p.var()] && varLevel[p.var()] > 0) {
                 learnt_clause[j++] = learnt_clause[i];
                 break;
             } else {
@@ -592,7 +593,7 @@ void Searcher::print_fully_minimized_learnt_clause() const
     if (conf.verbosity >= 6) {
         cout << "Final clause: " << learnt_clause << endl;
         for (uint32_t i = 0; i < learnt_clause.size(); i++) {
-            cout << "lev learnt_clause[" << i << "]:" << varData[learnt_clause[i].var()].level << endl;
+            cout << "lev learnt_clause[" << i << "]:" << varLevel[learnt_clause[i].var()] << endl;
         }
     }
 }
@@ -608,7 +609,7 @@ size_t Searcher::find_backtrack_level_of_learnt()
                 max_i = i;
         }
         std::swap(learnt_clause[max_i], learnt_clause[1]);
-        return varData[learnt_clause[1].var()].level;
+        return varLevel[learnt_clause[1].var()];
     }
 }
 
@@ -645,7 +646,7 @@ void Searcher::create_learnt_clause(PropBy confl)
         }
         default: release_assert(false);
     }
-    uint32_t nDecisionLevel = varData[lit0.var()].level;
+    uint32_t nDecisionLevel = varLevel[lit0.var()];
 
     // 1st UIP clause generation
     learnt_clause.push_back(lit_Undef); //make space for ~p
@@ -660,8 +661,8 @@ void Searcher::create_learnt_clause(PropBy confl)
             assert(p != lit_Undef);
         } while(trail[index+1].lev < nDecisionLevel);
 
-        confl = varData[p.var()].reason;
-        assert(varData[p.var()].level > 0);
+        confl = varReason[p.var()];
+        assert(varLevel[p.var()] > 0);
 
         //This clears out vars that haven't been added to learnt_clause,
         //but their 'seen' has been set
@@ -756,11 +757,11 @@ void Searcher::simple_create_learnt_clause(
             until = out_learnt.size();
         }
         p = trail[index + 1].lit;
-        confl = varData[p.var()].reason;
+        confl = varReason[p.var()];
 
         //under normal circumstances this does not happen, but here, it can
         //reason is undefined for level 0
-        if (varData[p.var()].level == 0) {
+        if (varLevel[p.var()] == 0) {
             confl = PropBy();
         }
         seen[p.var()] = 0;
@@ -877,7 +878,7 @@ void Searcher::analyze_conflict(
     vars_used_for_cl.clear();
     for(auto& lev: level_used_for_cl) {
         vars_used_for_cl.push_back(trail[trail_lim[lev-1]].lit.var());
-        assert(varData[trail[trail_lim[lev-1]].lit.var()].reason == PropBy());
+        assert(varReason[trail[trail_lim[lev-1]].lit.var()] == PropBy());
         assert(level_used_for_cl_arr[lev] == 1);
         level_used_for_cl_arr[lev] = 0;
     }
@@ -923,7 +924,7 @@ bool Searcher::litRedundant(const Lit p, uint32_t abstract_levels)
         #endif
 
         Lit p_analyze = analyze_stack.top();
-        const PropBy reason = varData[analyze_stack.top().var()].reason;
+        const PropBy reason = varReason[analyze_stack.top().var()];
         PropByType type = reason.getType();
         analyze_stack.pop();
 
@@ -988,8 +989,8 @@ bool Searcher::litRedundant(const Lit p, uint32_t abstract_levels)
             }
             stats.recMinimCost++;
 
-            if (!seen[p2.var()] && varData[p2.var()].level > 0) {
-                if (!varData[p2.var()].reason.isnullptr()
+            if (!seen[p2.var()] && varLevel[p2.var()] > 0) {
+                if (!varReason[p2.var()].isnullptr()
                     && (abstractLevel(p2.var()) & abstract_levels) != 0
                 ) {
                     seen[p2.var()] = 1;
@@ -1060,20 +1061,32 @@ void Searcher::analyze_final_confl_with_assumptions(const Lit p, vector<Lit>& ou
 
     //It's been set at level 0. The seen[] may not be large enough to do
     //seen[p.var()] -- we might have mem-saved that
-    if (varData[p.var()].level == 0) {
+    if (varLevel[p.var()] == 0) {
         return;
     }
 
     seen[p.var()] = 1;
+    seen_to_decisions(out_conflict);
+    seen[p.var()] = 0;
 
+    learnt_clause = out_conflict;
+    minimize_using_bins();
+    out_conflict = learnt_clause;
+}
+
+// Resolves the variables marked in seen[] back to the decisions (and
+// assumptions) that implied them, and adds the negation of these decisions
+// to "out". Clears seen[] on the way.
+void Searcher::seen_to_decisions(vector<Lit>& out)
+{
     assert(!trail_lim.empty());
     for (int64_t i = (int64_t)trail.size() - 1; i >= (int64_t)trail_lim[0]; i--) {
         const uint32_t x = trail[i].lit.var();
         if (seen[x]) {
-            const PropBy reason = varData[x].reason;
+            const PropBy reason = varReason[x];
             if (reason.isnullptr()) {
-                assert(varData[x].level > 0);
-                out_conflict.push_back(~trail[i].lit);
+                assert(varLevel[x] > 0);
+                out.push_back(~trail[i].lit);
             } else {
                 int32_t ID;
                 switch(reason.getType()) {
@@ -1082,7 +1095,7 @@ void Searcher::analyze_final_confl_with_assumptions(const Lit p, vector<Lit>& ou
                         ID = cl.stats.ID;
                         assert(value(cl[0]) == l_True);
                         for(const Lit lit: cl) {
-                            if (varData[lit.var()].level > 0) {
+                            if (varLevel[lit.var()] > 0) {
                                 seen[lit.var()] = 1;
                             }
                         }
@@ -1092,14 +1105,14 @@ void Searcher::analyze_final_confl_with_assumptions(const Lit p, vector<Lit>& ou
                     case bnn_t : {
                         vector<Lit>* cl = get_bnn_reason(bnns[reason.getBNNidx()], lit_Undef);
                         for(const Lit lit: *cl) {
-                            if (varData[lit.var()].level > 0)seen[lit.var()] = 1;
+                            if (varLevel[lit.var()] > 0)seen[lit.var()] = 1;
                         }
                         break;
                     }
 
                     case binary_t: {
                         const Lit lit = reason.lit2();
-                        if (varData[lit.var()].level > 0) seen[lit.var()] = 1;
+                        if (varLevel[lit.var()] > 0) seen[lit.var()] = 1;
                         ID = reason.getID();
                         break;
                     }
@@ -1108,7 +1121,7 @@ void Searcher::analyze_final_confl_with_assumptions(const Lit p, vector<Lit>& ou
                         auto cl = get_xor_reason(reason, ID);
                         assert(value((*cl)[0]) == l_True);
                         for(const Lit lit: *cl) {
-                            if (varData[lit.var()].level > 0) seen[lit.var()] = 1;
+                            if (varLevel[lit.var()] > 0) seen[lit.var()] = 1;
                         }
                         break;
                     }
@@ -1119,11 +1132,6 @@ void Searcher::analyze_final_confl_with_assumptions(const Lit p, vector<Lit>& ou
             seen[x] = 0;
         }
     }
-    seen[p.var()] = 0;
-
-    learnt_clause = out_conflict;
-    minimize_using_bins();
-    out_conflict = learnt_clause;
 }
 
 void Searcher::update_assump_conflict_to_orig_outer(vector<Lit>& out_conflict) {
@@ -1237,6 +1245,7 @@ void Searcher::check_need_gauss_jordan_disable()
 
 lbool Searcher::search()
 {
+    TRACE_SCOPE("restart");
     assert(ok);
     #ifdef SLOW_DEBUG
     check_no_zero_ID_bins();
@@ -1292,6 +1301,13 @@ lbool Searcher::search()
             lbool dec_ret;
             if (fast_backw.fast_backw_on) dec_ret = new_decision_fast_backw();
             else dec_ret = new_decision<false>();
+            if (dec_ret == l_True
+                && solver->enum_state
+                && !fast_backw.fast_backw_on
+                && block_model_and_continue()
+            ) {
+                continue;
+            }
             if (dec_ret != l_Undef) {
                 search_ret = dec_ret;
                 goto end;
@@ -1317,9 +1333,118 @@ lbool Searcher::search()
     end:
     print_restart_stat();
     dump_search_loop_stats(my_time);
+    publish_search_metrics();
     return search_ret;
 }
 
+//Called once per restart, cheap enough to not need a rate limit
+void Searcher::publish_search_metrics()
+{
+    Metrics& m = *solver->metrics;
+    m.set(Metrics::conflicts, sumConflicts);
+    m.set(Metrics::propagations, solver->sumPropStats.propagations + propStats.propagations);
+    m.set(Metrics::decisions, solver->sumSearchStats.decisions + stats.decisions);
+    m.set(Metrics::restarts, solver->sumSearchStats.numRestarts + stats.numRestarts);
+
+    const DataSync::Stats& sync = solver->datasync->get_stats();
+    m.set(Metrics::sync_units_sent, sync.sentUnitData);
+    m.set(Metrics::sync_units_recv, sync.recvUnitData);
+    m.set(Metrics::sync_bins_sent, sync.sentBinData);
+    m.set(Metrics::sync_bins_recv, sync.recvBinData);
+}
+
+// Used during model enumeration, when all variables have been assigned.
+// Reports the model, then adds an irredundant clause blocking its projection
+// and backtracks only as far as needed for the search to continue from here.
+// The clause consists of the negated decisions that imply the projection, if
+// these are all on projection vars (or are assumptions), and otherwise of the
+// negated projection itself. Returns false if the enumeration must stop.
+bool Searcher::block_model_and_continue()
+{
+    assert(solver->prop_at_head());
+    assert(!frat->enabled());
+    if (!solver->enum_report_model()) return false;
+
+    learnt_clause.clear();
+    for(uint32_t outer_var: conf.sampling_vars) {
+        outer_var = solver->varReplacer->get_var_replaced_with_outer(outer_var);
+        const uint32_t v = map_outer_to_inter(outer_var);
+        assert(varData[v].removed == Removed::none);
+        assert(value(v) != l_Undef);
+        if (seen2[v] || varLevel[v] == 0) continue;
+        seen2[v] = 1;
+        learnt_clause.push_back(Lit(v, value(v) == l_True));
+    }
+
+    if (!learnt_clause.empty()) {
+        for(const Lit l: learnt_clause) seen[l.var()] = 1;
+        decision_clause.clear();
+        seen_to_decisions(decision_clause);
+        bool only_proj = true;
+        for(const Lit l: decision_clause) {
+            if (varLevel[l.var()] > assumptions.size() && !seen2[l.var()]) {
+                only_proj = false;
+                break;
+            }
+        }
+        for(const Lit l: learnt_clause) seen2[l.var()] = 0;
+        if (only_proj && decision_clause.size() <= learnt_clause.size()) {
+            learnt_clause.swap(decision_clause);
+        }
+    }
+
+    //Whole projection is fixed at level 0, there are no more solutions
+    if (learnt_clause.empty()) {
+        solver->ok = false;
+        return true;
+    }
+
+    //Highest level literal first, second highest next
+    for(uint32_t k = 0; k < 2 && k < learnt_clause.size(); k++) {
+        uint32_t best = k;
+        for(uint32_t i = k+1; i < learnt_clause.size(); i++) {
+            if (varLevel[learnt_clause[i].var()] > varLevel[learnt_clause[best].var()])
+                best = i;
+        }
+        std::swap(learnt_clause[k], learnt_clause[best]);
+    }
+
+    if (learnt_clause.size() == 1) {
+        cancelUntil(0);
+        enqueue<false>(learnt_clause[0]);
+        return true;
+    }
+
+    const uint32_t level = varLevel[learnt_clause[0].var()];
+    const uint32_t btlevel = varLevel[learnt_clause[1].var()];
+    const bool asserting = btlevel < level;
+    if (!asserting
+        || (conf.diff_declev_for_chrono > -1
+            && xorclauses.empty()
+            && gmatrices.empty()
+            && bnns.empty())
+    ) {
+        //Chronological backtracking: only undo the last level involved
+        cancelUntil(level-1);
+    } else {
+        cancelUntil(btlevel);
+    }
+
+    const int32_t ID = ++clauseID;
+    if (learnt_clause.size() == 2) {
+        solver->attach_bin_clause(learnt_clause[0], learnt_clause[1], false, ID, asserting);
+        if (asserting) enqueue<false>(learnt_clause[0], btlevel, PropBy(learnt_clause[1], false, ID));
+    } else {
+        Clause* cl = cl_alloc.Clause_new(learnt_clause, sumConflicts, ID);
+        cl->stats.ID = ID;
+        const ClOffset offset = cl_alloc.get_offset(cl);
+        solver->attachClause(*cl, asserting);
+        solver->longIrredCls.push_back(offset);
+        if (asserting) enqueue<false>(learnt_clause[0], btlevel, PropBy(offset));
+    }
+    return true;
+}
+
 void Searcher::dump_search_sql(const double my_time)
 {
     if (solver->sqlStats) {
@@ -1494,7 +1619,7 @@ void Searcher::dump_var_for_learnt_cl(const uint32_t v,
     //When it's a decision clause, the REAL clause could have already
     //set some variable to having been propagated (due to asserting clause)
     //so this assert() no longer holds for all literals
-    assert(is_decision || varData[v].reason == PropBy());
+    assert(is_decision || varReason[v] == PropBy());
     if (varData[v].dump) {
         uint64_t outer_var = map_inter_to_outer(v);
         solver->sqlStats->dec_var_clid(
@@ -1801,7 +1926,7 @@ bool Searcher::handle_conflict(PropBy confl)
         }
         for(Lit l: decision_clause) {
             seen[l.toInt()] = 0;
-            assert(varData[l.var()].reason == PropBy());
+            assert(varReason[l.var()] == PropBy());
         }
     }
 
@@ -2157,7 +2282,7 @@ void Searcher::rebuildOrderHeap() {
     vs.reserve(nVars());
     for (uint32_t v = 0; v < nVars(); v++) {
         if (varData[v].removed != Removed::none
-                || (value(v) != l_Undef && varData[v].level == 0)) continue;
+                || (value(v) != l_Undef && varLevel[v] == 0)) continue;
         else vs.push_back(v);
     }
 
@@ -2505,7 +2630,9 @@ lbool Searcher::solve(const uint64_t _max_confls) {
     resetStats();
     lbool status = l_Undef;
 
-    setup_branch_strategy();
+    //Only the heap of the current branching is refilled on backtrack, so with
+    //assumption levels kept from the last solve() call, switch after a restart
+    if (decisionLevel() == 0) setup_branch_strategy();
     setup_restart_strategy(false);
     setup_polarity_strategy();
     STATS_DO(check_calc_satzilla_features(true));
@@ -2515,7 +2642,9 @@ lbool Searcher::solve(const uint64_t _max_confls) {
 
     SLOW_DEBUG_DO(assert(fast_backw.fast_backw_on || solver->check_order_heap_sanity()));
     while(stats.conflicts < max_confl_per_search_solve_call && status == l_Undef) {
-        if (!conf.never_stop_search &&
+        //Assumption levels kept from the previous solve() call are only
+        //cancelled at the end of the first restart, inprocess after that
+        if (decisionLevel() == 0 && !conf.never_stop_search &&
                 (distill_clauses_if_needed() == l_False
                 || !full_probe_if_needed()
                 || !distill_bins_if_needed()
@@ -2528,7 +2657,7 @@ lbool Searcher::solve(const uint64_t _max_confls) {
             goto end;
         }
         SLOW_DEBUG_DO(assert(solver->check_order_heap_sanity()));
-        sls_if_needed();
+        if (decisionLevel() == 0) sls_if_needed();
 
         assert(watches.get_smudged_list().empty());
         params.clear();
@@ -2708,7 +2837,7 @@ void Searcher::print_solution_varreplace_status() const
         if (varData[var].removed == Removed::replaced
             || varData[var].removed == Removed::elimed
         ) {
-            assert(value(var) == l_Undef || varData[var].level == 0);
+            assert(value(var) == l_Undef || varLevel[var] == 0);
         }
 
         if (conf.verbosity >= 6
@@ -2718,7 +2847,7 @@ void Searcher::print_solution_varreplace_status() const
             cout
             << "var: " << var
             << " value: " << value(var)
-            << " level:" << varData[var].level
+            << " level:" << varLevel[var]
             << " type: " << removed_type_to_string(varData[var].removed)
             << endl;
         }
@@ -2747,8 +2876,8 @@ void Searcher::finish_up_solve(const lbool status) {
         SLOW_DEBUG_DO(assert(fast_backw.fast_backw_on || solver->check_order_heap_sanity()));
         assert(solver->prop_at_head());
         model = assigns;
-        cancelUntil(0);
-        assert(decisionLevel() == 0);
+        cancelUntil(solver->assump_levels_to_keep());
+        assert(decisionLevel() <= assumptions.size());
 
         //due to chrono BT we need to propagate once more
         PropBy confl = propagate<false>();
@@ -2759,7 +2888,7 @@ void Searcher::finish_up_solve(const lbool status) {
         if (conflict.size() == 0) {
             ok = false;
         }
-        cancelUntil(0);
+        cancelUntil(solver->assump_levels_to_keep());
         if (okay()) {
             //due to chrono BT we need to propagate once more
             PropBy confl = propagate<false>();
@@ -3011,7 +3140,7 @@ PropBy Searcher::propagate() {
         if (!ret.isnullptr()) {
             int32_t ID;
             for(size_t i = last_trail; i < trail.size(); i++) {
-                const auto propby = varData[trail[i].lit.var()].reason;
+                const auto propby = varReason[trail[i].lit.var()];
                 if (propby.getType() == PropByType::xor_t) get_xor_reason(propby, ID);
             }
             if (ret.getType() == PropByType::xor_t) get_xor_reason(ret, ID);
@@ -3178,12 +3307,12 @@ void Searcher::cancelUntil(uint32_t blevel)
             assert(value(var) != l_Undef);
 
             //Clear out BNN reason on backtrack
-            if (varData[var].reason.isBNN() &&
-                varData[var].reason.bnn_reason_set())
+            if (varReason[var].isBNN() &&
+                varReason[var].bnn_reason_set())
             {
-                uint32_t reason_idx = varData[var].reason.get_bnn_reason();
+                uint32_t reason_idx = varReason[var].get_bnn_reason();
                 bnn_reasons_empty_slots.push_back(reason_idx);
-                varData[var].reason = PropBy();
+                varReason[var] = PropBy();
             }
             if (!bnns.empty()) reverse_prop(trail[i].lit);
 
@@ -3191,7 +3320,7 @@ void Searcher::cancelUntil(uint32_t blevel)
             if (!inprocess) {
                 varData[var].last_canceled = sumConflicts;
             }
-            if (!inprocess && varData[var].reason == PropBy()) {
+            if (!inprocess && varReason[var] == PropBy()) {
                 //we want to dump & this was a decision var
                 uint64_t sumConflicts_during = sumConflicts - varData[var].sumConflicts_at_picktime;
                 uint64_t sumDecisions_during = sumDecisions - varData[var].sumDecisions_at_picktime;
@@ -3343,17 +3472,17 @@ ConflictData Searcher::find_conflict_level(PropBy& pb) {
     ConflictData data;
 
     if (pb.getType() == PropByType::binary_t) {
-        data.nHighestLevel = varData[failBinLit.var()].level;
+        data.nHighestLevel = varLevel[failBinLit.var()];
 
         if (data.nHighestLevel == decisionLevel()
-            && varData[pb.lit2().var()].level == decisionLevel()
+            && varLevel[pb.lit2().var()] == decisionLevel()
         ) {
             return data;
         }
 
         uint32_t highestId = 0;
         // find the largest decision level in the clause
-        uint32_t nLevel = varData[pb.lit2().var()].level;
+        uint32_t nLevel = varLevel[pb.lit2().var()];
         if (nLevel > data.nHighestLevel) {
             highestId = 1;
             data.nHighestLevel = nLevel;
@@ -3397,9 +3526,9 @@ ConflictData Searcher::find_conflict_level(PropBy& pb) {
                 release_assert(false);
         }
 
-        data.nHighestLevel = varData[lits[0].var()].level;
+        data.nHighestLevel = varLevel[lits[0].var()];
         if (data.nHighestLevel == decisionLevel()
-            && varData[lits[1].var()].level == decisionLevel()
+            && varLevel[lits[1].var()] == decisionLevel()
         ) {
             return data;
         }
@@ -3407,7 +3536,7 @@ ConflictData Searcher::find_conflict_level(PropBy& pb) {
         uint32_t highestId = 0;
         // find the largest decision level in the lits
         for (uint32_t nLitId = 1; nLitId < size; ++nLitId) {
-            uint32_t nLevel = varData[lits[nLitId].var()].level;
+            uint32_t nLevel = varLevel[lits[nLitId].var()];
             if (nLevel > data.nHighestLevel) {
                 highestId = nLitId;
                 data.nHighestLevel = nLevel;
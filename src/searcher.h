@@ -76,6 +76,7 @@ class Searcher : public HyperEngine
         void check_calc_vardist_features(bool force = false);
         #endif
         void dump_search_loop_stats(double my_time);
+        void publish_search_metrics();
         bool must_abort(lbool status);
         PropBy insert_gpu_clause(Lit* lits, uint32_t count);
         uint64_t luby_loop_num = 0;
@@ -297,6 +298,8 @@ class Searcher : public HyperEngine
         template<bool inprocess>
         void add_lit_to_learnt(Lit lit, const uint32_t nDecisionLevel);
         void analyze_final_confl_with_assumptions(const Lit p, vector<Lit>& out_conflict);
+        void seen_to_decisions(vector<Lit>& out);
+        bool block_model_and_continue();
         void update_glue_from_analysis(Clause* cl);
         template<bool inprocess>
         void minimize_learnt_clause();
@@ -398,6 +401,7 @@ class Searcher : public HyperEngine
 
         friend class Gaussian;
         friend class DistillerLong;
+        friend struct BenchAccess; //tests/bench/cms_bench.cpp
         #ifdef CMS_TESTING_ENABLED
         FRIEND_TEST(SearcherTest, pickpolar_rnd);
         FRIEND_TEST(SearcherTest, pickpolar_pos);
@@ -451,7 +455,7 @@ class Searcher : public HyperEngine
 
 inline uint32_t Searcher::abstractLevel(const uint32_t x) const
 {
-    return ((uint32_t)1) << (varData[x].level & 31);
+    return ((uint32_t)1) << (varLevel[x] & 31);
 }
 
 inline const SearchStats& Searcher::get_stats() const
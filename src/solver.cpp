@@ -75,6 +75,7 @@ THE SOFTWARE.
 #include "lucky.h"
 #include "get_clause_query.h"
 #include "community_finder.h"
+#include "trace.h"
 extern "C" {
 #include "mpicosat/mpicosat.h"
 }
@@ -128,6 +129,8 @@ Solver::Solver(const SolverConf *_conf, std::atomic<bool>* _must_interrupt_inter
     datasync = new DataSync(this, nullptr);
     Searcher::solver = this;
     reduceDB = new ReduceDB(this);
+    inprocess_sched = new InprocessSched;
+    metrics = new Metrics;
 
     set_up_sql_writer();
     next_lev1_reduce = conf.every_lev1_reduce;
@@ -154,10 +157,13 @@ Solver::~Solver()
     delete subsumeImplicit;
     delete datasync;
     delete reduceDB;
+    delete inprocess_sched;
+    delete metrics;
 #ifdef USE_BREAKID
     delete breakid;
 #endif
     delete card_finder;
+    for(BNN* bnn: bnns) free(bnn);
 }
 
 void Solver::set_sqlite(
@@ -416,24 +422,55 @@ Clause* Solver::add_clause_int(
 // return TRUE if needs to be removed
 void Solver::sort_and_clean_bnn(BNN& bnn)
 {
-    std::sort(bnn.begin(), bnn.end());
+    if (bnn.weighted) {
+        //sort literals together with their weights
+        vector<std::pair<Lit, int32_t>> tmp;
+        tmp.reserve(bnn.size());
+        for(uint32_t i = 0; i < bnn.size(); i++) tmp.push_back({bnn[i], bnn.weight(i)});
+        std::sort(tmp.begin(), tmp.end());
+        for(uint32_t i = 0; i < bnn.size(); i++) {
+            bnn[i] = tmp[i].first;
+            bnn.weights()[i] = tmp[i].second;
+        }
+    } else {
+        std::sort(bnn.begin(), bnn.end());
+    }
     Lit p = lit_Undef;
     uint32_t i, j;
     for (i = j = 0; i < bnn.size(); i++) {
+        const int32_t w = bnn.weight(i);
         if (value(bnn[i]) == l_True) {
-            bnn.cutoff --;
+            bnn.cutoff -= w;
             continue;
         } else if (value(bnn[i]) == l_False) {
             continue;
+        } else if (bnn.weighted && bnn[i] == p) {
+            //duplicate, merge weights
+            bnn.weights()[j-1] += w;
+            continue;
         } else if (bnn[i].var() == p.var()
             && bnn[i].sign() == !p.sign()
         ) {
-            p = lit_Undef;
-            bnn.cutoff--; //either way it's a +1 on the LHS
-            j--;
+            if (!bnn.weighted || bnn.weights()[j-1] == w) {
+                p = lit_Undef;
+                bnn.cutoff -= w; //either way it's a +w on the LHS
+                j--;
+                continue;
+            }
+
+            //w1*p + w2*~p == min(w1,w2) + |w1-w2|*(heavier of the two)
+            const int32_t w1 = bnn.weights()[j-1];
+            bnn.cutoff -= std::min(w1, w);
+            if (w > w1) {
+                bnn[j-1] = p = bnn[i];
+                bnn.weights()[j-1] = w - w1;
+            } else {
+                bnn.weights()[j-1] = w1 - w;
+            }
             continue;
         } else {
-            bnn[j++] = p = bnn[i];
+            bnn.move_lit(j++, i);
+            p = bnn[i];
 
             if (varData[p.var()].removed != Removed::none) {
                 cout << "ERROR: BNN " << bnn << " contains literal "
@@ -457,11 +494,23 @@ void Solver::sort_and_clean_bnn(BNN& bnn)
             for(auto& l: bnn) {
                 l = ~l;
             }
-            bnn.cutoff = (int)bnn.size()+1-bnn.cutoff;
+            bnn.cutoff = bnn.total_weight()+1-bnn.cutoff;
         }
         bnn.set = true;
         bnn.out = lit_Undef;
     }
+
+    if (bnn.weighted) {
+        //Fall back to the counting version if no weights are left
+        bnn.max_weight = 0;
+        for(uint32_t k = 0; k < bnn.size(); k++) {
+            bnn.max_weight = std::max(bnn.max_weight, bnn.weight(k));
+        }
+        if (bnn.max_weight <= 1) {
+            bnn.weighted = false;
+            bnn.max_weight = 1;
+        }
+    }
 }
 
 void Solver::attach_bnn(const uint32_t bnn_idx)
@@ -470,10 +519,11 @@ void Solver::attach_bnn(const uint32_t bnn_idx)
 
 //     cout << "Attaching BNN: " << *bnn << endl;
 
-    for(const auto& l: *bnn) {
-        watches[l].push(Watched(bnn_idx, WatchType::watch_bnn_t, bnn_pos_t));
-        watches[~l].push(Watched(bnn_idx, WatchType::watch_bnn_t, bnn_neg_t));
-
+    for(uint32_t i = 0; i < bnn->size(); i++) {
+        const Lit l = (*bnn)[i];
+        const int32_t w = bnn->weight(i);
+        watches[l].push(Watched(bnn_idx, WatchType::watch_bnn_t, bnn_pos_t, w));
+        watches[~l].push(Watched(bnn_idx, WatchType::watch_bnn_t, bnn_neg_t, w));
     }
     if (!bnn->set)  {
         watches[bnn->out].push(Watched(bnn_idx, WatchType::watch_bnn_t, bnn_out_t));
@@ -486,6 +536,7 @@ bool Solver::bnn_to_cnf(BNN& bnn)
 {
     // It must have already been evaluated
     assert(bnn.set || value(bnn.out) == l_Undef);
+    if (bnn.weighted) return false;
 
     vector<Lit> lits;
     if (bnn.set && bnn.cutoff == 1) {
@@ -582,17 +633,46 @@ bool Solver::bnn_to_cnf(BNN& bnn)
 void Solver::add_bnn_clause_inter(
     vector<Lit>& lits,
     const int32_t cutoff,
-    Lit out)
+    Lit out,
+    const vector<int32_t>* weights)
 {
     assert(ok);
-    uint32_t num_req = sizeof(BNN) + lits.size()*sizeof(Lit);
-    void* mem = malloc(num_req);
-    BNN* bnn = new (mem) BNN(lits, cutoff, out);
-
-    sort_and_clean_bnn(*bnn);
-    bnn->undefs = bnn->size();
-    bnn->ts = 0;
-    lbool ret = bnn_eval(*bnn);
+
+    //Repeated variables can only be merged when there are weights
+    vector<int32_t> unit_weights;
+    if (weights == nullptr) {
+        bool dup = false;
+        for(const Lit l: lits) {
+            dup |= seen[l.var()];
+            seen[l.var()] = 1;
+        }
+        for(const Lit l: lits) seen[l.var()] = 0;
+        if (dup) {
+            unit_weights.resize(lits.size(), 1);
+            weights = &unit_weights;
+        }
+    }
+
+    void* mem = malloc(BNN::mem_needed(lits.size(), weights != nullptr));
+    BNN* bnn = weights ?
+        new (mem) BNN(lits, *weights, cutoff, out) : new (mem) BNN(lits, cutoff, out);
+
+    lbool ret;
+    while (true) {
+        sort_and_clean_bnn(*bnn);
+        bnn->undefs = bnn->total_weight();
+        bnn->ts = 0;
+        const size_t trail_at = trail.size();
+        ret = bnn_eval(*bnn);
+        if (ret != l_Undef || trail.size() == trail_at) break;
+
+        //A weighted BNN fixed some of its literals, clean it again
+        if (!propagate<true>().isnullptr()) {
+            ok = false;
+            free(bnn);
+            return;
+        }
+    }
     if (ret != l_Undef) {
         if (ret == l_False) {
             ok = false;
@@ -609,6 +689,11 @@ void Solver::add_bnn_clause_inter(
             free(bnn);
             bnn = nullptr;
         } else {
+            //cancelUntil() only clears the propagated flags while there are
+            //BNNs, so flags left over from search so far must be cleared
+            if (bnns.empty()) {
+                for(auto& vd: varData) vd.propagated = false;
+            }
             bnns.push_back(bnn);
             attach_bnn(bnns.size()-1);
         }
@@ -672,6 +757,7 @@ bool Solver::add_clause_helper(vector<Lit>& ps) {
     if (!ok) return false;
 
     //Sanity checks
+    drop_kept_assumps();
     assert(decisionLevel() == 0);
     assert(qhead == trail.size());
 
@@ -979,6 +1065,7 @@ void Solver::new_vars(size_t n)
     if (n == 0) {
         return;
     }
+    drop_kept_assumps();
 
     Searcher::new_vars(n);
     varReplacer->new_vars(n);
@@ -995,6 +1082,7 @@ void Solver::new_var(
     const uint32_t orig_outer,
     const bool insert_varorder)
 {
+    drop_kept_assumps();
     Searcher::new_var(bva, orig_outer, insert_varorder);
 
     varReplacer->new_var(orig_outer);
@@ -1040,13 +1128,92 @@ void Solver::set_assumptions() {
     SLOW_DEBUG_DO(for(const auto& x: varData) assert(x.assumption == l_Undef));
     conflict.clear();
 
-    vector<Lit> tmp;
-    tmp = assumptions;
-    add_clause_helper(tmp); // unelimininates, sanity checks
+    //With a kept trail, reuse_assump_prefix() checked there is nothing to add
+    if (decisionLevel() == 0) {
+        vector<Lit> tmp;
+        tmp = assumptions;
+        add_clause_helper(tmp); // unelimininates, sanity checks
+    }
     fill_assumptions_set();
     SLOW_DEBUG_DO(check_assumptions_sanity());
 }
 
+//Trail of the previous solve() call can only be kept if nothing else will
+//need to backtrack to level 0 before search starts
+bool Solver::assump_trail_reusable() const
+{
+    return conf.reuse_assump_trail
+        && ok
+        && !frat->enabled()
+        && !fast_backw.fast_backw_on
+        && !enum_state
+        && !conf.sampling_vars_set
+        && !conf.doBreakid
+        && gmatrices.empty()
+        && !xorclauses_updated;
+}
+
+//Level i+1 is always the decision (or dummy) level of assumptions[i], so the
+//levels up to the current one are all propagated assumptions
+uint32_t Solver::assump_levels_to_keep() const
+{
+    if (!assump_trail_reusable()) return 0;
+    return std::min<uint32_t>(decisionLevel(), assumptions.size());
+}
+
+//No assumption needs to be re-added or uneliminated by add_clause_helper()
+bool Solver::assumps_all_inside() const
+{
+    for(Lit p: assumptions) {
+        p = varReplacer->get_lit_replaced_with_outer(p);
+        p = map_outer_to_inter(p);
+        if (p.var() >= nVars() || varData[p.var()].removed != Removed::none) return false;
+    }
+    return true;
+}
+
+//Backtracks to the longest common prefix of the kept and the new assumptions,
+//so those need not be decided and propagated again
+void Solver::reuse_assump_prefix()
+{
+    solveStats.num_assumps += assumptions.size();
+    if (kept_assumps.empty()) return;
+
+    uint32_t k = 0;
+    if (assump_trail_reusable()
+        && !simplify_at_this_startup()
+        && assumps_all_inside()
+    ) {
+        while (k < kept_assumps.size()
+            && k < assumptions.size()
+            && kept_assumps[k] == assumptions[k]
+        ) k++;
+    }
+    if (k == 0) {
+        drop_kept_assumps();
+        return;
+    }
+
+    kept_assumps.clear();
+    cancelUntil(k);
+    //due to chrono BT we need to propagate once more
+    PropBy confl = propagate<false>();
+    assert(confl.isnullptr());
+    solveStats.num_assump_levels_reused += k;
+    metrics->set(Metrics::assump_levels_reused, solveStats.num_assump_levels_reused);
+    verb_print(6, "[assump-reuse] kept " << k << " assumption levels");
+}
+
+//Everything except solve() needs decision level 0
+void Solver::drop_kept_assumps()
+{
+    if (kept_assumps.empty()) return;
+    kept_assumps.clear();
+    cancelUntil(0);
+    PropBy confl = propagate<false>();
+    assert(confl.isnullptr());
+}
+
 void Solver::uneliminate_sampling_set() {
     if (!conf.sampling_vars_set) return;
 
@@ -1302,6 +1469,7 @@ void Solver::check_and_upd_config_parameters()
 
 lbool Solver::simplify_problem_outside(const string* strategy)
 {
+    drop_kept_assumps();
     #ifdef SLOW_DEBUG
     if (ok) {
         assert(check_order_heap_sanity());
@@ -1375,7 +1543,22 @@ lbool Solver::solve_with_assumptions(
     const bool only_sampling_solution
 ) {
     if (frat->enabled()) frat->set_sqlstats_ptr(sqlStats);
+
+    //When enumerating without a projection set, project on all variables,
+    //so none of them get eliminated and the blocking clauses are valid
+    const bool enum_all_vars = enum_state && !conf.sampling_vars_set;
+    if (enum_all_vars) {
+        assert(conf.sampling_vars.empty());
+        for(uint32_t v = 0; v < nVarsOuter(); v++) {
+            if (varData[map_outer_to_inter(v)].is_bva) continue;
+            conf.sampling_vars.push_back(v);
+        }
+        conf.sampling_vars_set = true;
+    }
+    if (enum_state) enum_state->only_sampling_solution = only_sampling_solution;
+
     copy_assumptions(_assumptions);
+    reuse_assump_prefix();
     reset_for_solving();
 
     //Check if adding the clauses caused UNSAT
@@ -1394,12 +1577,7 @@ lbool Solver::solve_with_assumptions(
     USE_BREAKID_DO(if (breakid) breakid->start_new_solving());
 
     //Simplify in case simplify_at_startup is set
-    if (status == l_Undef
-        && nVars() > 0
-        && conf.do_simplify_problem
-        && conf.simplify_at_startup
-        && (solveStats.num_simplify == 0 || conf.simplify_at_every_startup)
-    ) {
+    if (status == l_Undef && simplify_at_this_startup()) {
         status = simplify_problem(
             !conf.full_simplify_at_startup,
             !conf.full_simplify_at_startup ? conf.simplify_schedule_startup : conf.simplify_schedule_nonstartup);
@@ -1418,13 +1596,14 @@ lbool Solver::solve_with_assumptions(
     if (sqlStats) sqlStats->finishup(status);
     handle_found_solution(status, only_sampling_solution);
     unfill_assumptions_set();
+    kept_assumps.assign(assumptions.begin(), assumptions.begin() + decisionLevel());
     assumptions.clear();
     conf.max_confl = numeric_limits<uint64_t>::max();
     conf.maxTime = numeric_limits<double>::max();
     datasync->finish_up_mpi();
     conf.conf_needed = true;
     set_must_interrupt_asap();
-    assert(decisionLevel()== 0);
+    assert(decisionLevel() == kept_assumps.size());
     assert(!ok || prop_at_head());
     if (_assumptions == nullptr || _assumptions->empty()) {
         #ifdef USE_BREAKID
@@ -1439,9 +1618,33 @@ lbool Solver::solve_with_assumptions(
 
     write_final_frat_clauses();
 
+    if (enum_all_vars) {
+        conf.sampling_vars.clear();
+        conf.sampling_vars_set = false;
+    }
+
     return status;
 }
 
+bool Solver::simplify_at_this_startup() const
+{
+    return nVars() > 0
+        && conf.do_simplify_problem
+        && conf.simplify_at_startup
+        && (solveStats.num_simplify == 0 || conf.simplify_at_every_startup);
+}
+
+bool Solver::enum_report_model()
+{
+    assert(enum_state);
+    model = assigns;
+    extend_solution(enum_state->only_sampling_solution);
+    enum_state->num_found++;
+
+    const bool go_on = (*enum_state->callback)(model);
+    return go_on && enum_state->num_found < enum_state->max_sols;
+}
+
 void Solver::write_final_frat_clauses() {
     if (!frat->enabled()) return;
     if (frat->incremental()) return;
@@ -1587,6 +1790,22 @@ void Solver::dump_memory_stats_to_sql()
     );
 }
 
+//Same breakdown as print_mem_stats(), for the live metrics
+void Solver::publish_mem_metrics()
+{
+    metrics->set_mem(Metrics::mem_longclauses, mem_used_longclauses());
+    metrics->set_mem(Metrics::mem_watches, watches.mem_used_alloc() + watches.mem_used_array());
+    metrics->set_mem(Metrics::mem_vardata, mem_used_vardata());
+    metrics->set_mem(Metrics::mem_search, mem_used());
+    metrics->set_mem(Metrics::mem_renumberer, CNF::mem_used_renumberer());
+    metrics->set_mem(Metrics::mem_occsimp, occsimplifier ? occsimplifier->mem_used() : 0);
+    metrics->set_mem(Metrics::mem_varreplacer, varReplacer->mem_used());
+    metrics->set_mem(Metrics::mem_subsimp, subsumeImplicit ? subsumeImplicit->mem_used() : 0);
+    metrics->set_mem(Metrics::mem_distill, distill_long_cls->mem_used()
+        + dist_long_with_impl->mem_used()
+        + dist_impl_with_impl->mem_used());
+}
+
 uint64_t Solver::calc_num_confl_to_do_this_iter(const size_t iteration_num) const
 {
     double iter_num = std::min<size_t>(iteration_num, 100ULL);
@@ -1621,6 +1840,7 @@ lbool Solver::iterate_until_solved() {
         iteration_num++;
         if (conf.verbosity >= 2) print_clause_size_distrib();
         dump_memory_stats_to_sql();
+        publish_mem_metrics();
 
         const uint64_t num_confl = calc_num_confl_to_do_this_iter(iteration_num);
         if (num_confl == 0) break;
@@ -1701,13 +1921,13 @@ void Solver::handle_found_solution(const lbool status, const bool only_sampling_
     double mytime = cpuTime();
     if (status == l_True) {
         extend_solution(only_sampling_solution);
-        cancelUntil(0);
+        cancelUntil(assump_levels_to_keep());
         assert(prop_at_head());
 
         DEBUG_ATTACH_MORE_DO(find_all_attached());
         DEBUG_ATTACH_MORE_DO(check_all_clause_attached());
     } else if (status == l_False) {
-        cancelUntil(0);
+        cancelUntil(assump_levels_to_keep());
         for(const Lit lit: conflict) {
             if (value(lit) == l_Undef) assert(var_inside_assumptions(lit.var()) != l_Undef);
         }
@@ -1723,11 +1943,18 @@ lbool Solver::execute_inprocess_strategy(
     const bool startup
     , const string& strategy
 ) {
+    vector<string> tokens;
     std::istringstream ss(strategy + ", ");
-    std::string token;
-    std::string occ_strategy_tokens;
+    std::string tok;
+    while(std::getline(ss, tok, ',')) {
+        tok = trim(tok);
+        std::transform(tok.begin(), tok.end(), tok.begin(), ::tolower);
+        tokens.push_back(tok);
+    }
+    if (conf.do_adaptive_inprocess) inprocess_sched->reorder(tokens);
 
-    while(std::getline(ss, token, ',')) {
+    std::string occ_strategy_tokens;
+    for(const string& token: tokens) {
         if (sumConflicts >= conf.max_confl
             || cpuTime() > conf.maxTime
             || must_interrupt_asap()
@@ -1747,13 +1974,17 @@ lbool Solver::execute_inprocess_strategy(
         check_assumptions_sanity();
         #endif
 
-        token = trim(token);
-        std::transform(token.begin(), token.end(), token.begin(), ::tolower);
         if (!occ_strategy_tokens.empty() && token.substr(0,3) != "occ") {
             if (conf.perform_occur_based_simp && bnns.empty() && occsimplifier) {
                 occ_strategy_tokens = trim(occ_strategy_tokens);
                 verb_print(1, "Executing OCC strategy token(s): '" << occ_strategy_tokens);
+                TRACE_SCOPE("occ");
+                const auto before = inprocess_snapshot();
+                const double my_time = cpuTime();
+                const double my_wall_time = real_time_sec();
                 occsimplifier->simplify(startup, occ_strategy_tokens);
+                inprocess_sched->record("occ", before, inprocess_snapshot(), cpuTime() - my_time);
+                metrics->record(Metrics::inprocess_pass, real_time_sec() - my_wall_time);
             }
             occ_strategy_tokens.clear();
             if (sumConflicts >= conf.max_confl || cpuTime() > conf.maxTime
@@ -1765,8 +1996,21 @@ lbool Solver::execute_inprocess_strategy(
         }
         if (okay()) SLOW_DEBUG_DO(check_wrong_attach());
 
-        if (token.substr(0,3) != "occ" && !token.empty())
-            verb_print(1, "--> Executing strategy token: " << token);
+        const bool accounted = token.substr(0,3) != "occ" && !token.empty();
+        const bool adapt = conf.do_adaptive_inprocess && InprocessSched::adaptable(token);
+        if (adapt && inprocess_sched->should_skip(token)) {
+            verb_print(1, "--> Skipping strategy token: " << token << " (found nothing recently)");
+            continue;
+        }
+        if (accounted) verb_print(1, "--> Executing strategy token: " << token);
+        TRACE_SCOPE(accounted ? token.c_str() : nullptr);
+
+        InprocessSched::Snapshot before;
+        const double my_time = cpuTime();
+        const double my_wall_time = real_time_sec();
+        const double orig_timeout_mult = conf.global_timeout_multiplier;
+        if (accounted) before = inprocess_snapshot();
+        if (adapt) conf.global_timeout_multiplier *= inprocess_sched->budget_mult(token);
 
         if (token == "scc-vrepl") {
             if (conf.doFindAndReplaceEqLits) {
@@ -1794,11 +2038,17 @@ lbool Solver::execute_inprocess_strategy(
                 varReplacer->replace_if_enough_is_found();
             }
         } else if (token == "full-probe") {
-            if (!full_probe(false)) return l_False;
+            if (!full_probe(false)) {
+                conf.global_timeout_multiplier = orig_timeout_mult;
+                return l_False;
+            }
         } else if (token == "card-find") {
             if (conf.doFindCard) {
                 card_finder->find_cards();
-                exit(0);
+                if (conf.doFindCard >= 2 && !card_finder->atmost1_to_bnns()) {
+                    conf.global_timeout_multiplier = orig_timeout_mult;
+                    return l_False;
+                }
             }
         } else if (token == "sub-impl") {
             //subsume BIN with BIN
@@ -1916,6 +2166,11 @@ lbool Solver::execute_inprocess_strategy(
             cout << "ERROR: strategy '" << token << "' not recognised!" << endl;
             exit(-1);
         }
+        conf.global_timeout_multiplier = orig_timeout_mult;
+        if (accounted) {
+            inprocess_sched->record(token, before, inprocess_snapshot(), cpuTime() - my_time);
+            metrics->record(Metrics::inprocess_pass, real_time_sec() - my_wall_time);
+        }
 
         SLOW_DEBUG_DO(check_stats());
         if (!okay()) return l_False;
@@ -1927,6 +2182,17 @@ lbool Solver::execute_inprocess_strategy(
     return okay() ? l_Undef : l_False;
 }
 
+InprocessSched::Snapshot Solver::inprocess_snapshot() const
+{
+    InprocessSched::Snapshot snap;
+    snap.cls = longIrredCls.size() + binTri.irredBins;
+    snap.lits = litStats.irredLits + 2*binTri.irredBins;
+    snap.assigned = trail.size();
+    snap.replaced = varReplacer->get_num_replaced_vars();
+    if (occsimplifier) snap.elimed = occsimplifier->get_num_elimed_vars();
+    return snap;
+}
+
 /**
 @brief The function that brings together almost all CNF-simplifications
 */
@@ -1965,6 +2231,8 @@ lbool Solver::simplify_problem(const bool startup, const string& strategy) {
 
     solveStats.num_simplify++;
     solveStats.num_simplify_this_solve_call++;
+    metrics->set(Metrics::simplifications, solveStats.num_simplify);
+    publish_mem_metrics();
     verb_print(6, __func__ << " finished");
 
     assert(!(ok == false && ret != l_False));
@@ -2046,6 +2314,13 @@ void Solver::print_norm_stats(
         , stats_line_percent(zeroLevAssignsByCNF, nVars())
         , "% vars"
     );
+    if (solveStats.num_assumps > 0) {
+        print_stats_line("c assump levels reused"
+            , solveStats.num_assump_levels_reused
+            , stats_line_percent(solveStats.num_assump_levels_reused, solveStats.num_assumps)
+            , "% assumps"
+        );
+    }
 
     print_stats_line("c reduceDB time"
         , reduceDB->get_total_time()
@@ -2094,6 +2369,7 @@ void Solver::print_norm_stats(
                     , stats_line_percent(dist_long_with_impl->get_stats().redWatchBased.cpu_time, cpu_time)
                     , "% time"
     );
+    if (conf.do_print_times) inprocess_sched->print_stats(cpu_time);
 
     if (sumConflicts > 0) {
         for(uint32_t i = 0; i < longRedCls.size(); i ++) {
@@ -2214,6 +2490,8 @@ uint64_t Solver::mem_used_vardata() const
     uint64_t mem = 0;
     mem += assigns.capacity()*sizeof(lbool);
     mem += varData.capacity()*sizeof(VarData);
+    mem += varLevel.capacity()*sizeof(uint32_t);
+    mem += varReason.capacity()*sizeof(PropBy);
 
     return mem;
 }
@@ -2354,7 +2632,6 @@ vector<Lit> Solver::get_zero_assigned_lits(const bool backnumber,
                                            const bool only_nvars) const
 {
     vector<Lit> lits;
-    assert(decisionLevel() == 0);
     size_t until;
     if (only_nvars) {
         until = nVars();
@@ -2362,7 +2639,8 @@ vector<Lit> Solver::get_zero_assigned_lits(const bool backnumber,
         until = assigns.size();
     }
     for(size_t i = 0; i < until; i++) {
-        if (assigns[i] != l_Undef) {
+        //Skip the assumption levels kept from the last solve() call
+        if (assigns[i] != l_Undef && varLevel[i] == 0) {
             Lit lit(i, assigns[i] == l_False);
 
             //Update to higher-up
@@ -2616,8 +2894,8 @@ void Solver::check_implicit_propagated() const
         const Lit lit = Lit::toLit(wsLit);
         watch_subarray_const ws = *it;
         for(const auto& w : ws) {
-            //Satisfied, or not implicit, skip
-            if (value(lit) == l_True || w.isClause()) continue;
+            //Satisfied, or not binary, skip
+            if (value(lit) == l_True || !w.isBin()) continue;
 
             const lbool val1 = value(lit);
             const lbool val2 = value(w.lit2());
@@ -2747,6 +3025,32 @@ bool Solver::add_clause_outside(const vector<Lit>& lits, bool red, bool restore)
     return add_clause_outer(tmp, lits, red, restore);
 }
 
+//Clause i is lits[offsets[i]] .. lits[offsets[i+1]-1]
+bool Solver::add_clauses_outside(const Lit* lits, const uint64_t* offsets, const size_t num_cls)
+{
+    uint64_t num_long = 0;
+    uint64_t num_long_lits = 0;
+    for(size_t i = 0; i < num_cls; i++) {
+        const uint64_t sz = offsets[i+1] - offsets[i];
+        if (sz > 2) {
+            num_long++;
+            num_long_lits += sz;
+        }
+    }
+    cl_alloc.reserve(num_long, num_long_lits);
+    longIrredCls.reserve(longIrredCls.size() + num_long);
+
+    vector<Lit> outer;
+    vector<Lit> tmp;
+    for(size_t i = 0; i < num_cls && ok; i++) {
+        outer.assign(lits + offsets[i], lits + offsets[i+1]);
+        SLOW_DEBUG_DO(check_too_large_variable_number(outer));
+        tmp = outer;
+        add_clause_outer(tmp, outer, false, false);
+    }
+    return ok;
+}
+
 bool Solver::add_xor_clause_outside(const vector<Lit>& lits_out, bool rhs) {
     frat_func_start();
     if (!okay()) return false;
@@ -2783,15 +3087,20 @@ bool Solver::add_xor_clause_outside(const vector<uint32_t>& vars, const bool rhs
     return okay();
 }
 
-bool Solver::add_bnn_clause_outside( const vector<Lit>& lits, const int32_t cutoff, Lit out) {
+bool Solver::add_bnn_clause_outside(
+    const vector<Lit>& lits, const int32_t cutoff, Lit out, const vector<int32_t>* weights)
+{
     if (!ok) return false;
     SLOW_DEBUG_DO(check_too_large_variable_number(lits));
+    assert(weights == nullptr || weights->size() == lits.size());
 
     vector<Lit> lits2(lits);
     add_clause_helper(lits2);
-    out = map_outer_to_inter(out);
-    out = varReplacer->get_lit_replaced_with(out);
-    add_bnn_clause_inter(lits2, cutoff, out);
+    if (out != lit_Undef) {
+        out = map_outer_to_inter(out);
+        out = varReplacer->get_lit_replaced_with(out);
+    }
+    add_bnn_clause_inter(lits2, cutoff, out, weights);
 
     return ok;
 }
@@ -3069,6 +3378,7 @@ vector<Lit> Solver::get_toplevel_units_internal(bool outer_numbering) const
 vector<Xor> Solver::get_recovered_xors() {
     vector<Xor> xors_ret;
     if (!okay()) return xors_ret;
+    drop_kept_assumps();
 
     lbool ret = execute_inprocess_strategy(false, "occ-xor");
     if (ret == l_False) return xors_ret;
@@ -3101,6 +3411,7 @@ void Solver::renumber_xors_to_outside(const vector<Xor>& xors, vector<Xor>& xors
 // and the matrices are created and initialized
 bool Solver::find_and_init_all_matrices() {
     frat_func_start();
+    TRACE_SCOPE("gauss-init");
     if (!xorclauses_updated) {
         if (conf.verbosity >= 2) {
             cout << "c [find&init matx] XORs not updated-> not performing matrix init. Matrices: "
@@ -3187,6 +3498,7 @@ bool Solver::init_all_matrices() {
 void Solver::start_getting_constraints(bool red, bool simplified,
         uint32_t max_len, uint32_t max_glue) {
     assert(get_clause_query == nullptr);
+    drop_kept_assumps();
     get_clause_query = new GetClauseQuery(this);
     get_clause_query->start_getting_constraints(red, simplified, max_len, max_glue);
 }
@@ -3196,6 +3508,13 @@ bool Solver::get_next_constraint(std::vector<Lit>& ret, bool& is_xor, bool& rhs)
     return get_clause_query->get_next_constraint(ret, is_xor, rhs);
 }
 
+size_t Solver::get_next_constraints(Lit* lits, size_t lits_cap,
+    size_t* offsets, size_t max_constraints, uint8_t* flags)
+{
+    assert(get_clause_query);
+    return get_clause_query->get_next_constraints(lits, lits_cap, offsets, max_constraints, flags);
+}
+
 void Solver::end_getting_constraints()
 {
     assert(get_clause_query);
@@ -3268,6 +3587,7 @@ bool Solver::implied_by(const std::vector<Lit>& lits,
 
     out_implied.clear();
     if (!okay()) return false;
+    drop_kept_assumps();
 
     implied_by_tmp_lits = lits;
     if (!add_clause_helper(implied_by_tmp_lits)) return false;
@@ -3338,6 +3658,7 @@ vector<OrGate> Solver::get_recovered_or_gates()
     if (!okay()) {
         return vector<OrGate>();
     }
+    drop_kept_assumps();
 
     vector<OrGate> or_gates = occsimplifier->recover_or_gates();
 
@@ -3355,6 +3676,7 @@ vector<ITEGate> Solver::get_recovered_ite_gates()
     if (!okay()) {
         return vector<ITEGate>();
     }
+    drop_kept_assumps();
 
     vector<ITEGate> or_gates = occsimplifier->recover_ite_gates();
 
@@ -3371,6 +3693,7 @@ vector<ITEGate> Solver::get_recovered_ite_gates()
 vector<uint32_t> Solver::remove_definable_by_irreg_gate(const vector<uint32_t>& vars)
 {
     if (!okay()) return vector<uint32_t>{};
+    drop_kept_assumps();
     return occsimplifier->remove_definable_by_irreg_gate(vars);
 }
 
@@ -3378,11 +3701,13 @@ void Solver::get_empties(vector<uint32_t>& sampl_vars, vector<uint32_t>& empty_v
 {
     if (!okay()) return;
     assert(get_num_bva_vars() == 0);
+    drop_kept_assumps();
 
     occsimplifier->get_empties(sampl_vars, empty_vars);
 }
 
 bool Solver::remove_and_clean_all() {
+    drop_kept_assumps();
     return clauseCleaner->remove_and_clean_all();
 }
 
@@ -3414,6 +3739,27 @@ lbool Solver::bnn_eval(BNN& bnn)
         return l_True;
     }
 
+    if (bnn.weighted) {
+        const int32_t total = bnn.total_weight();
+        if (total < bnn.cutoff) {
+            if (bnn.set) return l_False;
+            enqueue<false>(~bnn.out, decisionLevel());
+            return l_True;
+        }
+
+        //it's set, and literals heavier than the slack must ALL be TRUE
+        const int32_t slack = total - bnn.cutoff;
+        if (bnn.set && bnn.max_weight > slack) {
+            bool all = true;
+            for(uint32_t i = 0; i < bnn.size(); i++) {
+                if (bnn.weight(i) > slack) enqueue<false>(bnn[i], decisionLevel());
+                else all = false;
+            }
+            if (all) return l_True;
+        }
+        return l_Undef;
+    }
+
     // we are under the cutoff no matter what undef is
     if ((int)bnn.size() < bnn.cutoff) {
         if (bnn.set) {
@@ -3488,6 +3834,8 @@ string Solver::serialize_solution_reconstruction_data() const
         ar << inter_to_outerMain;
         ar << outer_to_interMain;
         ar << varData;
+        ar << varLevel;
+        ar << varReason;
         ar << minNumVars;
         CNF::serialize(ar);
         occsimplifier->serialize_elimed_cls(ar);
@@ -3509,6 +3857,8 @@ void Solver::create_from_solution_reconstruction_data(const string& data)
         ar >> inter_to_outerMain;
         ar >> outer_to_interMain;
         ar >> varData;
+        ar >> varLevel;
+        ar >> varReason;
         ar >> minNumVars;
         CNF::unserialize(ar);
         occsimplifier->unserialize_elimed_cls(ar);
@@ -30,11 +30,14 @@ THE SOFTWARE.
 #include <utility>
 #include <string>
 #include <algorithm>
+#include <functional>
 
 #include "solvertypes.h"
 #include "propengine.h"
 #include "searcher.h"
 #include "searchstats.h"
+#include "inprocess_sched.h"
+#include "metrics.h"
 #ifdef CMS_TESTING_ENABLED
 #include "gtest/gtest_prod.h"
 #endif
@@ -80,6 +83,8 @@ struct SolveStats
     uint32_t num_simplify = 0;
     uint32_t num_simplify_this_solve_call = 0;
     uint32_t num_solve_calls = 0;
+    uint64_t num_assumps = 0;
+    uint64_t num_assump_levels_reused = 0;
 };
 
 class Solver : public Searcher
@@ -94,12 +99,14 @@ class Solver : public Searcher
         void new_external_var();
         void new_external_vars(size_t n);
         bool add_clause_outside(const vector<Lit>& lits, bool red = false, bool restore = false);
+        bool add_clauses_outside(const Lit* lits, const uint64_t* offsets, const size_t num_cls);
         bool add_xor_clause_outside(const vector<uint32_t>& vars, const bool rhs);
         bool add_xor_clause_outside(const vector<Lit>& lits_out, bool rhs);
         bool add_bnn_clause_outside(
             const vector<Lit>& lits,
             const int32_t cutoff,
-            Lit out);
+            Lit out,
+            const vector<int32_t>* weights = nullptr);
         void set_lit_weight(Lit lit, double weight);
         void get_weights(map<Lit,double>& weights,
                 const vector<uint32_t>& sampling_vars,
@@ -109,6 +116,16 @@ class Solver : public Searcher
             const vector<Lit>* _assumptions = nullptr,
             bool only_indep_solution = false);
         lbool simplify_with_assumptions(const vector<Lit>* _assumptions = nullptr, const string* strategy = nullptr);
+
+        //Model enumeration, see SATSolver::enumerate_solutions()
+        struct EnumState {
+            const std::function<bool(const vector<lbool>&)>* callback = nullptr;
+            uint64_t max_sols = 0;
+            uint64_t num_found = 0;
+            bool only_sampling_solution = false;
+        };
+        EnumState* enum_state = nullptr;
+        bool enum_report_model();
         void  set_shared_data(SharedData* shared_data);
         vector<Lit> probe_inter_tmp;
         lbool probe_outside(Lit l, uint32_t& min_props);
@@ -138,6 +155,8 @@ class Solver : public Searcher
                uint32_t max_len = std::numeric_limits<uint32_t>::max(),
                uint32_t max_glue = std::numeric_limits<uint32_t>::max());
         bool get_next_constraint(std::vector<Lit>& ret, bool& is_xor, bool& rhs);
+        size_t get_next_constraints(Lit* lits, size_t lits_cap,
+            size_t* offsets, size_t max_constraints, uint8_t* flags);
         void end_getting_constraints();
         vector<uint32_t> translate_sampl_set(const vector<uint32_t>& sampl_set);
 
@@ -196,6 +215,8 @@ class Solver : public Searcher
         StrImplWImpl* dist_impl_with_impl = nullptr;
         CardFinder*            card_finder = nullptr;
         GetClauseQuery*        get_clause_query = nullptr;
+        InprocessSched*        inprocess_sched = nullptr;
+        Metrics*               metrics = nullptr;
 
         SearchStats sumSearchStats;
         PropStats sumPropStats;
@@ -280,7 +301,8 @@ class Solver : public Searcher
         void add_bnn_clause_inter(
             vector<Lit>& lits,
             int32_t cutoff,
-            Lit out
+            Lit out,
+            const vector<int32_t>* weights = nullptr
         );
 
         lbool bnn_eval(BNN& bnn);
@@ -289,6 +311,9 @@ class Solver : public Searcher
         template<class T> vector<uint32_t> xor_outer_numbered(const T& cl) const;
         size_t mem_used() const;
         void dump_memory_stats_to_sql();
+        void publish_mem_metrics();
+        void save_state(const string& fname);
+        void load_state(const string& fname);
         void dump_clauses_at_finishup_as_last();
         void set_sqlite(const string filename);
         //Not Private for testing (maybe could be called from outside)
@@ -338,6 +363,8 @@ class Solver : public Searcher
         void check_assigns_for_assumptions() const;
         bool check_assumptions_contradict_foced_assignment() const;
         void uneliminate_sampling_set();
+        uint32_t assump_levels_to_keep() const;
+        void drop_kept_assumps();
 
         //Deleting clauses
         void free_cl(Clause* cl, bool also_remove_clid = true);
@@ -425,6 +452,13 @@ class Solver : public Searcher
         vector<uint32_t> tmp_xor_clash_vars;
         void check_xor_cut_config_sanity() const;
         void copy_assumptions(const vector<Lit>* assumps);
+        bool assump_trail_reusable() const;
+        bool assumps_all_inside() const;
+        void reuse_assump_prefix();
+        bool simplify_at_this_startup() const;
+        //Assumptions of the previous solve() call, whose decision levels are
+        //still on the trail. See reuse_assump_prefix()
+        vector<Lit> kept_assumps;
         void handle_found_solution(const lbool status, const bool only_indep_solution);
         unsigned num_bits_set(const size_t x, const unsigned max_size) const;
         void check_too_large_variable_number(const vector<Lit>& lits) const;
@@ -442,6 +476,7 @@ class Solver : public Searcher
 
         lbool simplify_problem(const bool startup, const string& strategy);
         lbool execute_inprocess_strategy(const bool startup, const string& strategy);
+        InprocessSched::Snapshot inprocess_snapshot() const;
         SolveStats solveStats;
         void check_minimization_effectiveness(lbool status);
         void check_recursive_minimization_effectiveness(const lbool status);
@@ -192,6 +192,7 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , varelim_sub_str_limitM(600)
         , varElimRatioPerIter(1.60)
         , velim_resolvent_too_large(20)
+        , incremental_extend(true)
         , var_linkin_limit_MB(1000)
         , varelim_gate_find_limit(800)
         , picosat_gate_limitK(70)
@@ -253,18 +254,20 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , maxXorToFindSlow (5)
         , maxXORMatrix     (400ULL)
         , xor_finder_time_limitM(400)
+        , xor_finder_threads(1)
         , allow_elim_xor_vars(1)
 
         //Cardinality
         , doFindCard(0)
+        , card_native_min_size(6)
 
         //Var-replacer
         , doFindAndReplaceEqLits(true)
-        , max_scc_depth (10000)
 
         //Iterative Alo Scheduling
         , simplify_at_startup(false)
         , simplify_at_every_startup(false)
+        , reuse_assump_trail(true)
         , do_simplify_problem(true)
         , full_simplify_at_startup(false)
         , never_stop_search(false)
@@ -296,6 +299,7 @@ DLL_PUBLIC SolverConf::SolverConf() :
             "bosphorus,"
             "louvain-comms,"
         )
+        , do_adaptive_inprocess(false)
 
         //Occur based simplification
         , perform_occur_based_simp(true)
@@ -336,6 +340,7 @@ DLL_PUBLIC SolverConf::SolverConf() :
         #else
         , distill_sort(1)
         #endif
+        , distill_threads(1)
 
         //Memory savings
         , doRenumberVars   (true)
@@ -366,9 +371,16 @@ DLL_PUBLIC SolverConf::SolverConf() :
         , thread_num(0)
         , is_mpi(false)
 
+        //Cube-and-conquer
+        , cube_depth(0)
+        , cube_lookahead_cands(16)
+        , cube_warmup_confl(2000)
+        , cube_confl_budget(5000)
+
         // Oracle
         , oracle_get_learnts(false) // get oracle learnt clauses
         , oracle_removed_is_learnt(false) // clauses removed by Oracle should be learnt
+        , oracle_vivif_threads(1)
 
         //misc
         , origSeed(0)
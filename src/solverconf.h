@@ -347,6 +347,7 @@ class DLL_PUBLIC SolverConf
         long long varelim_sub_str_limitM;
         double    varElimRatioPerIter;
         int velim_resolvent_too_large; //-1 == no limit
+        int incremental_extend; //re-extend only what changed since the previous model
         int var_linkin_limit_MB;
         int varelim_gate_find_limit;
         int picosat_gate_limitK;
@@ -407,10 +408,12 @@ class DLL_PUBLIC SolverConf
         unsigned maxXorToFindSlow;
         uint64_t maxXORMatrix;
         uint64_t xor_finder_time_limitM;
+        uint32_t xor_finder_threads; //look for XORs from this many threads, deduplicated after
         int      allow_elim_xor_vars;
 
         //Cardinality
-        int      doFindCard;
+        int      doFindCard; ///<1 = find and report, 2 = also replace pairwise at-most-one groups with BNNs
+        unsigned card_native_min_size;
 
         #ifdef FINAL_PREDICTOR
         //Predictor system
@@ -422,11 +425,11 @@ class DLL_PUBLIC SolverConf
 
         //Var-replacement
         int doFindAndReplaceEqLits;
-        int max_scc_depth;
 
         //Iterative Alo Scheduling
         int      simplify_at_startup; //simplify at 1st startup (only)
         int      simplify_at_every_startup; //always simplify at startup, not only at 1st startup
+        int      reuse_assump_trail; //keep trail of common assumption prefix between solve() calls
         int      do_simplify_problem;
         int      full_simplify_at_startup;
         int      never_stop_search;
@@ -436,6 +439,7 @@ class DLL_PUBLIC SolverConf
         uint32_t max_num_simplify_per_solve_call;
         string   simplify_schedule_startup;
         string   simplify_schedule_nonstartup;
+        int      do_adaptive_inprocess; //skip/reorder/scale passes by yield per second
 
         //Simplification
         int      perform_occur_based_simp;
@@ -472,6 +476,7 @@ class DLL_PUBLIC SolverConf
         double distill_irred_noremove_ratio;
         int    distill_rand_shuffle_order_every_n;
         int    distill_sort;
+        uint32_t distill_threads; //evaluate long cls on this many threads over a snapshot
 
         //Memory savings
         int       doRenumberVars;
@@ -512,9 +517,16 @@ class DLL_PUBLIC SolverConf
         unsigned thread_num;
         uint32_t is_mpi;
 
+        //Cube-and-conquer
+        uint32_t cube_depth; //split into at most 2^depth cubes, 0 = portfolio mode
+        uint32_t cube_lookahead_cands; //vars looked ahead on at every split
+        uint64_t cube_warmup_confl; //conflicts on thread 0 before splitting
+        uint64_t cube_confl_budget; //conflicts on a cube before it may be split further
+
         // Oracle
         int oracle_get_learnts; // get oracle learnt clauses
         int oracle_removed_is_learnt; // clauses removed by Oracle should be learnt
+        uint32_t oracle_vivif_threads; // shard oracle vivification over this many threads
 
         //Misc
         unsigned origSeed;
@@ -0,0 +1,405 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "solverstate.h"
+#include "solver.h"
+#include "varreplacer.h"
+#include "occsimplifier.h"
+#include "clauseallocator.h"
+
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+using namespace CMSat;
+using std::string;
+using std::vector;
+using std::cerr;
+using std::endl;
+
+static const uint32_t state_magic[2] = {0x53534d43U, 0x31544154U}; //"CMSSTAT1"
+static const uint32_t state_version = 1;
+
+void StateWriter::begin_section(const StateSection tag)
+{
+    u32((uint32_t)tag);
+    section_start = buf.size();
+    u64(0);
+}
+
+void StateWriter::end_section()
+{
+    const uint64_t len = buf.size() - section_start - 2;
+    buf[section_start] = len & 0xffffffffULL;
+    buf[section_start+1] = len >> 32;
+}
+
+void StateWriter::write(const string& fname) const
+{
+    std::ofstream f(fname, std::ios::binary | std::ios::trunc);
+    if (f) {
+        f.write((const char*)state_magic, sizeof(state_magic));
+        f.write((const char*)&state_version, sizeof(state_version));
+        f.write((const char*)buf.data(), buf.size()*sizeof(uint32_t));
+    }
+    if (!f) {
+        const string err = "ERROR: cannot write solver state to file '" + fname + "'";
+        cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+}
+
+StateReader::StateReader(const string& _fname) :
+    fname(_fname)
+{
+    std::ifstream f(fname, std::ios::binary | std::ios::ate);
+    if (!f) {
+        const string err = "ERROR: cannot open solver state file '" + fname + "'";
+        cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    const uint64_t bytes = f.tellg();
+    if (bytes % sizeof(uint32_t) != 0 || bytes < 3*sizeof(uint32_t)) {
+        corrupt("file size is not a whole number of words");
+    }
+    buf.resize(bytes/sizeof(uint32_t));
+    f.seekg(0);
+    f.read((char*)buf.data(), bytes);
+    if (!f) corrupt("read failed");
+
+    if (buf[0] != state_magic[0] || buf[1] != state_magic[1]) {
+        corrupt("not a CryptoMiniSat state file");
+    }
+    if (buf[2] != state_version) {
+        corrupt("unsupported version " + std::to_string(buf[2]));
+    }
+    at = 3;
+    section_end = buf.size();
+}
+
+Lit StateReader::lit(const uint32_t num_vars)
+{
+    const Lit l = Lit::toLit(u32());
+    if (l.var() >= num_vars) corrupt("literal out of range");
+    return l;
+}
+
+void StateReader::begin_section(const StateSection tag)
+{
+    section_end = buf.size();
+    if (u32() != (uint32_t)tag) corrupt("unexpected section");
+    const uint64_t len = u64();
+    if (at + len > buf.size()) corrupt("section is too long");
+    section_end = at + len;
+}
+
+void StateReader::end_section()
+{
+    if (at != section_end) corrupt("trailing data in section");
+    section_end = buf.size();
+}
+
+void StateReader::corrupt(const string& what) const
+{
+    const string err = "ERROR: solver state file '" + fname + "' is corrupt: " + what;
+    cerr << err << endl;
+    throw std::runtime_error(err);
+}
+
+//Everything is written in OUTER numbering so that the state can be loaded into
+//a fresh Solver, where inter and outer numbering are the same
+void Solver::save_state(const string& fname)
+{
+    if (frat->enabled() || get_num_bva_vars() != 0 || !bnns.empty()) {
+        const char err[] = "ERROR: save_state() does not support FRAT, BVA or BNN constraints";
+        cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+    drop_kept_assumps();
+    assert(decisionLevel() == 0);
+    if (okay()) clear_gauss_matrices(false);
+
+    StateWriter w;
+    w.u32(okay());
+    w.u32(nVarsOuter());
+
+    w.begin_section(StateSection::vars);
+    for(uint32_t outer = 0; outer < nVarsOuter(); outer++) {
+        const uint32_t v = map_outer_to_inter(outer);
+        const VarData& vd = varData[v];
+        uint32_t x = (uint32_t)vd.removed;
+        x |= (uint32_t)vd.stable_polarity << 2;
+        x |= (uint32_t)vd.saved_polarity << 3;
+        x |= (uint32_t)vd.best_polarity << 4;
+        x |= (uint32_t)vd.inv_polarity << 5;
+        if (value(v) != l_Undef) {
+            x |= (value(v) == l_True ? 1U : 2U) << 6;
+        }
+        w.u32(x);
+    }
+    w.end_section();
+
+    w.begin_section(StateSection::activities);
+    w.dbl(var_inc_vsids);
+    for(uint32_t outer = 0; outer < nVarsOuter(); outer++) {
+        const uint32_t v = map_outer_to_inter(outer);
+        w.dbl(v < var_act_vsids.size() ? var_act_vsids[v] : 0);
+    }
+    w.end_section();
+
+    w.begin_section(StateSection::varreplacer);
+    varReplacer->save_state(w);
+    w.end_section();
+
+    w.begin_section(StateSection::elimed);
+    if (occsimplifier) occsimplifier->save_state(w);
+    w.end_section();
+
+    for(const bool red: {false, true}) {
+        w.begin_section(red ? StateSection::red : StateSection::irred);
+        for(uint32_t i = 0; i < watches.size(); i++) {
+            const Lit lit = Lit::toLit(i);
+            for(const Watched& ws: watches[lit]) {
+                if (!ws.isBin() || ws.red() != red || lit > ws.lit2()) continue;
+                w.u32(2);
+                w.lit(map_inter_to_outer(lit));
+                w.lit(map_inter_to_outer(ws.lit2()));
+            }
+        }
+        const auto write_long = [&](const ClOffset offs) {
+            const Clause& cl = *cl_alloc.ptr(offs);
+            w.u32(cl.size());
+            if (red) {
+                w.u32(cl.stats.glue);
+                w.u32(cl.stats.which_red_array);
+                float act = cl.stats.activity;
+                uint32_t act_bits;
+                memcpy(&act_bits, &act, sizeof(act_bits));
+                w.u32(act_bits);
+            }
+            for(const Lit l: cl) w.lit(map_inter_to_outer(l));
+        };
+        if (!red) for(const ClOffset offs: longIrredCls) write_long(offs);
+        else for(const auto& lredcls: longRedCls) for(const ClOffset offs: lredcls) write_long(offs);
+        w.end_section();
+    }
+
+    w.begin_section(StateSection::xors);
+    for(const Xor& x: xorclauses) {
+        w.u32(x.rhs);
+        w.u32(x.size());
+        for(const uint32_t v: x) w.u32(map_inter_to_outer(v));
+    }
+    w.end_section();
+
+    w.begin_section(StateSection::end);
+    w.end_section();
+    w.write(fname);
+
+    verb_print(1, "[state] saved " << nVarsOuter() << " vars, "
+        << binTri.irredBins << " irred bins, " << longIrredCls.size() << " irred long, "
+        << binTri.redBins << " red bins, " << xorclauses.size() << " xors to '"
+        << fname << "'");
+}
+
+void Solver::load_state(const string& fname)
+{
+    if (nVarsOuter() != 0 || frat->enabled()) {
+        const char err[] = "ERROR: load_state() needs a fresh solver without FRAT";
+        cerr << err << endl;
+        throw std::runtime_error(err);
+    }
+
+    StateReader r(fname);
+    const bool saved_ok = r.u32();
+    const uint32_t n = r.u32();
+    new_external_vars(n);
+    if (!saved_ok) {
+        ok = false;
+        return;
+    }
+
+    vector<Lit> units;
+    r.begin_section(StateSection::vars);
+    for(uint32_t v = 0; v < n; v++) {
+        const uint32_t x = r.u32();
+        if ((x & 3) > (uint32_t)Removed::replaced || (x >> 6) > 2) r.corrupt("bad variable flags");
+        VarData& vd = varData[v];
+        vd.removed = (Removed)(x & 3);
+        vd.stable_polarity = (x >> 2) & 1;
+        vd.saved_polarity = (x >> 3) & 1;
+        vd.best_polarity = (x >> 4) & 1;
+        vd.inv_polarity = (x >> 5) & 1;
+        if ((x >> 6) != 0) {
+            if (vd.removed != Removed::none) r.corrupt("removed variable is assigned");
+            units.push_back(Lit(v, (x >> 6) == 2));
+        }
+    }
+    r.end_section();
+
+    r.begin_section(StateSection::activities);
+    var_inc_vsids = r.dbl();
+    max_vsids_act = 0;
+    for(uint32_t v = 0; v < n; v++) {
+        var_act_vsids[v] = r.dbl();
+        max_vsids_act = std::max(max_vsids_act, var_act_vsids[v]);
+    }
+    r.end_section();
+
+    r.begin_section(StateSection::varreplacer);
+    varReplacer->load_state(r);
+    r.end_section();
+
+    r.begin_section(StateSection::elimed);
+    if (occsimplifier) occsimplifier->load_state(r);
+    else if (r.left() > 0) r.corrupt("eliminated clauses need occurrence-based simplification");
+    r.end_section();
+
+    for(const Lit l: units) {
+        if (value(l) == l_False) ok = false;
+        else if (value(l) == l_Undef) enqueue<false>(l);
+    }
+    if (ok) ok = propagate<false>().isnullptr();
+
+    vector<Lit> lits;
+    for(const bool red: {false, true}) {
+        r.begin_section(red ? StateSection::red : StateSection::irred);
+        while(r.left() > 0) {
+            const uint32_t sz = r.u32();
+            ClauseStats cl_stats;
+            if (red && sz > 2) {
+                cl_stats.glue = r.u32();
+                cl_stats.which_red_array = r.u32();
+                const uint32_t act_bits = r.u32();
+                memcpy(&cl_stats.activity, &act_bits, sizeof(act_bits));
+                if (cl_stats.which_red_array > 2) r.corrupt("bad clause tier");
+            }
+            cl_stats.last_touched_any = sumConflicts;
+            lits.clear();
+            for(uint32_t i = 0; i < sz; i++) {
+                lits.push_back(r.lit(n));
+                if (varData[lits.back().var()].removed != Removed::none) {
+                    r.corrupt("clause contains a removed variable");
+                }
+            }
+            if (!ok) continue;
+            Clause* cl = add_clause_int(lits, red, &cl_stats);
+            if (cl != nullptr) {
+                const ClOffset offs = cl_alloc.get_offset(cl);
+                if (!red) longIrredCls.push_back(offs);
+                else longRedCls[cl->stats.which_red_array].push_back(offs);
+            }
+        }
+        r.end_section();
+    }
+
+    r.begin_section(StateSection::xors);
+    while(r.left() > 0) {
+        const bool rhs = r.u32();
+        const uint32_t sz = r.u32();
+        lits.clear();
+        for(uint32_t i = 0; i < sz; i++) {
+            const uint32_t v = r.u32();
+            if (v >= n || varData[v].removed != Removed::none) r.corrupt("bad XOR variable");
+            lits.push_back(Lit(v, false));
+        }
+        if (ok) add_xor_clause_inter(lits, rhs, true, 0);
+    }
+    r.end_section();
+
+    r.begin_section(StateSection::end);
+    r.end_section();
+
+    rebuildOrderHeap();
+    verb_print(1, "[state] loaded " << n << " vars, "
+        << binTri.irredBins << " irred bins, " << longIrredCls.size() << " irred long, "
+        << binTri.redBins << " red bins, " << xorclauses.size() << " xors from '"
+        << fname << "' ok: " << ok);
+}
+
+void VarReplacer::save_state(StateWriter& w) const
+{
+    for(const Lit l: table) w.lit(l);
+}
+
+void VarReplacer::load_state(StateReader& r)
+{
+    const uint32_t n = solver->nVarsOuter();
+    assert(table.size() == n);
+    replacedVars = 0;
+    reverseTable.clear();
+    for(uint32_t v = 0; v < n; v++) {
+        const Lit l = r.lit(n);
+        const bool replaced = solver->varData[v].removed == Removed::replaced;
+        if (replaced != (l.var() != v) || (!replaced && l.sign())) {
+            r.corrupt("equivalence table does not match variables");
+        }
+        table[v] = l;
+    }
+    for(uint32_t v = 0; v < n; v++) {
+        const Lit l = table[v];
+        if (l.var() == v) continue;
+        if (table[l.var()] != Lit(l.var(), false)) r.corrupt("equivalence table is not flat");
+        reverseTable[l.var()].push_back(v);
+        replacedVars++;
+    }
+}
+
+void OccSimplifier::save_state(StateWriter& w) const
+{
+    for(const ElimedClauses& e: elimed_cls) {
+        if (e.toRemove) continue;
+        w.u32(e.is_xor);
+        w.u32(e.size());
+        for(uint64_t i = 0; i < e.size(); i++) w.u32(e.at(i, elimed_cls_lits).toInt());
+    }
+}
+
+void OccSimplifier::load_state(StateReader& r)
+{
+    const uint32_t n = solver->nVarsOuter();
+    assert(elimed_cls.empty());
+    while(r.left() > 0) {
+        const bool is_xor = r.u32();
+        const uint32_t sz = r.u32();
+        if (sz == 0) r.corrupt("empty eliminated-clause entry");
+        const uint64_t start = elimed_cls_lits.size();
+        for(uint32_t i = 0; i < sz; i++) {
+            const Lit l = Lit::toLit(r.u32());
+            if (l != lit_Undef && l.var() >= n) r.corrupt("literal out of range");
+            elimed_cls_lits.push_back(l);
+        }
+        const Lit on = elimed_cls_lits[start];
+        if (on == lit_Undef || solver->varData[on.var()].removed != Removed::elimed) {
+            r.corrupt("eliminated clauses are not on an eliminated variable");
+        }
+        elimed_cls.push_back(ElimedClauses(start, elimed_cls_lits.size(), is_xor));
+    }
+    elimed_map_built = false;
+    ext_index_built = false;
+
+    bvestats_global.numVarsElimed = 0;
+    for(uint32_t v = 0; v < n; v++) {
+        if (solver->varData[v].removed == Removed::elimed) bvestats_global.numVarsElimed++;
+    }
+}
@@ -0,0 +1,101 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#ifndef CMS_SOLVERSTATE_H
+#define CMS_SOLVERSTATE_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "solvertypesmini.h"
+
+namespace CMSat {
+
+// Checkpoint file of a Solver, see Solver::save_state().
+//
+// The file is a flat array of native-endian 32-bit words: a magic, a version,
+// then sections in a fixed order. Each section starts with its tag and its
+// length in words, so a reader can check it or skip it. As everything is
+// word-aligned, the file can also be mmap()-ed and read in place.
+enum class StateSection : uint32_t {
+    vars = 1
+    , activities = 2
+    , varreplacer = 3
+    , elimed = 4
+    , irred = 5
+    , red = 6
+    , xors = 7
+    , end = 8
+};
+
+class StateWriter
+{
+public:
+    void u32(const uint32_t x) { buf.push_back(x); }
+    void u64(const uint64_t x) { u32(x & 0xffffffffULL); u32(x >> 32); }
+    void dbl(const double d) { uint64_t x; memcpy(&x, &d, sizeof(x)); u64(x); }
+    void lit(const Lit l) { u32(l.toInt()); }
+
+    void begin_section(const StateSection tag);
+    void end_section();
+
+    //Throws std::runtime_error if the file cannot be written
+    void write(const std::string& fname) const;
+
+private:
+    std::vector<uint32_t> buf;
+    size_t section_start = 0;
+};
+
+class StateReader
+{
+public:
+    //Throws std::runtime_error if the file cannot be read or is not a checkpoint
+    explicit StateReader(const std::string& fname);
+
+    uint32_t u32() { need(1); return buf[at++]; }
+    uint64_t u64() { const uint64_t lo = u32(); return lo | ((uint64_t)u32() << 32); }
+    double dbl() { const uint64_t x = u64(); double d; memcpy(&d, &x, sizeof(d)); return d; }
+    Lit lit(const uint32_t num_vars);
+    uint64_t left() const { return section_end - at; }
+
+    void begin_section(const StateSection tag);
+    void end_section();
+    [[noreturn]] void corrupt(const std::string& what) const;
+
+private:
+    void need(const uint64_t words) const {
+        if (at + words > section_end) corrupt("section is too short");
+    }
+
+    std::string fname;
+    std::vector<uint32_t> buf;
+    uint64_t at = 0;
+    uint64_t section_end = 0;
+};
+
+}
+
+#endif //CMS_SOLVERSTATE_H
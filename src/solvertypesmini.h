@@ -299,11 +299,38 @@ public:
         undefs = _in.size();
         ts = 0;
         sz = _in.size();
+        cap = _in.size();
         for(uint32_t i = 0; i < _in.size(); i++) {
             getData()[i] = _in[i];
         }
     }
 
+    //Weighted (pseudo-Boolean) version: sum of weights[i]*_in[i] >= cutoff.
+    //Weights must be positive, they are stored after the literals.
+    explicit BNN(
+        const std::vector<Lit>& _in,
+        const std::vector<int32_t>& _weights,
+        const int32_t _cutoff,
+        const Lit _out):
+        BNN(_in, _cutoff, _out)
+    {
+        assert(_weights.size() == _in.size());
+        weighted = true;
+        undefs = 0;
+        max_weight = 0;
+        for(uint32_t i = 0; i < _in.size(); i++) {
+            assert(_weights[i] > 0);
+            weights()[i] = _weights[i];
+            undefs += _weights[i];
+            max_weight = std::max(max_weight, _weights[i]);
+        }
+    }
+
+    static size_t mem_needed(const size_t num_lits, const bool _weighted)
+    {
+        return sizeof(BNN) + num_lits*(sizeof(Lit) + (_weighted ? sizeof(int32_t) : 0));
+    }
+
     Lit* getData()
     {
         return (Lit*)((char*)this + sizeof(BNN));
@@ -324,6 +351,37 @@ public:
         return getData()[at];
     }
 
+    int32_t* weights()
+    {
+        return (int32_t*)(getData() + cap);
+    }
+
+    const int32_t* weights() const
+    {
+        return (const int32_t*)(getData() + cap);
+    }
+
+    int32_t weight(const uint32_t at) const
+    {
+        return weighted ? weights()[at] : 1;
+    }
+
+    //Sum of all weights, i.e. the maximum the LHS can reach
+    int32_t total_weight() const
+    {
+        if (!weighted) return sz;
+        int32_t total = 0;
+        for(uint32_t i = 0; i < sz; i++) total += weights()[i];
+        return total;
+    }
+
+    //Moves literal (and its weight) at 'from' to 'to', used when shrinking
+    void move_lit(const uint32_t to, const uint32_t from)
+    {
+        getData()[to] = getData()[from];
+        if (weighted) weights()[to] = weights()[from];
+    }
+
     const Lit& get_out() const
     {
         return out;
@@ -369,11 +427,19 @@ public:
     int32_t ts = 0;
     int32_t undefs = 0;
     uint32_t sz;
+    uint32_t cap;
+
+    //When weighted, ts and undefs are sums of weights, not counts.
+    //max_weight is an upper bound on the weights, used to skip
+    //scanning for propagations when the slack is large enough
+    bool weighted = false;
+    int32_t max_weight = 1;
 };
 
 inline std::ostream& operator<<(std::ostream& os, const BNN& bnn)
 {
     for (uint32_t i = 0; i < bnn.size(); i++) {
+        if (bnn.weighted) os << bnn.weight(i) << "*";
         os << "lit[" << bnn[i] << "]";
 
         if (i+1 < bnn.size())
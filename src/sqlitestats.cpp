@@ -956,7 +956,7 @@ void SQLiteStats::var_data_picktime(
 ) {
     int bindAt = 1;
     sqlite3_bind_int   (stmt_var_data_picktime, bindAt++, var);
-    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, vardata.level);
+    sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->varLevel[var]);
     sqlite3_bind_double(stmt_var_data_picktime, bindAt++, rel_activity);
     sqlite3_bind_int64 (stmt_var_data_picktime, bindAt++, solver->latest_vardist_feature_calc);
 
@@ -50,6 +50,7 @@ bool StrImplWImpl::str_impl_w_impl()
     size_t upI = rnd_uint(solver->mtrand, solver->watches.size()-1);
     size_t numDone = 0;
     for (; numDone < solver->watches.size() && timeAvailable > 0
+            && !solver->must_interrupt_asap()
         ; upI = (upI +1) % solver->watches.size(), numDone++
 
     ) {
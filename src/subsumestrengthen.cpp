@@ -235,6 +235,7 @@ void SubsumeStrengthen::backw_sub_long_with_long()
     ) {
         *simplifier->limit_to_decrease -= 3;
         wenThrough++;
+        if ((wenThrough&0xfff) == 0xfff && solver->must_interrupt_asap()) break;
 
         //Print status
         if (solver->conf.verbosity >= 5
@@ -300,6 +301,7 @@ bool SubsumeStrengthen::backw_str_long_with_long()
     ) {
         *simplifier->limit_to_decrease -= 10;
         wenThrough++;
+        if ((wenThrough&0xfff) == 0xfff && solver->must_interrupt_asap()) break;
 
         //Print status
         if (solver->conf.verbosity >= 5
@@ -944,6 +946,7 @@ bool SubsumeStrengthen::backw_sub_str_long_with_bins()
         if (!backw_sub_str_long_with_bins_watch(lit)) {
             break;
         }
+        if ((numDone&0xfff) == 0xfff && solver->must_interrupt_asap()) break;
     }
 
     const double time_used = cpuTime() - my_time;
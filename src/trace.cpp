@@ -0,0 +1,254 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "trace.h"
+
+#ifdef CMS_TRACE
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CMS_TRACE_TSC
+#endif
+
+using namespace CMSat;
+using std::string;
+using std::vector;
+
+namespace {
+
+struct Event {
+    uint64_t start;
+    uint64_t end; //equal to start for instant events
+    uint64_t arg;
+    bool instant;
+    char name[Tracer::max_name_len+1];
+};
+
+struct ThreadBuf {
+    uint32_t tid;
+    string name;
+    vector<Event> ring;
+    uint64_t written = 0;
+    bool in_use = true; //false once its thread exited, so it can be reused
+    bool named = false; //by Tracer::set_thread_name() when taken
+};
+
+struct Registry {
+    Registry() :
+        tsc0(Tracer::now())
+        , wall0(std::chrono::steady_clock::now())
+    {}
+
+    std::mutex mtx;
+    vector<std::unique_ptr<ThreadBuf>> bufs;
+    const uint64_t tsc0;
+    const std::chrono::steady_clock::time_point wall0;
+};
+
+Registry& registry()
+{
+    static Registry r;
+    return r;
+}
+
+//Start the clock calibration at load time, not at the first event
+[[maybe_unused]] const Registry& registry_at_load = registry();
+
+thread_local ThreadBuf* my_buf = nullptr;
+
+//Hands the buffer back when the thread exits. Solving with many threads
+//starts new threads every call, and they take over these buffers, so their
+//number does not grow with the number of calls
+struct BufReleaser {
+    ~BufReleaser() {
+        if (!my_buf) return;
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mtx);
+        my_buf->in_use = false;
+        my_buf = nullptr;
+    }
+};
+thread_local BufReleaser releaser;
+
+//Takes the free buffer of the same name, so each solver thread index keeps
+//its own timeline over many calls. The registry lock must be held
+ThreadBuf* acquire_buf(Registry& r, const string* name)
+{
+    ThreadBuf* free_buf = nullptr;
+    for(auto& buf: r.bufs) {
+        if (!buf->in_use && buf->named == (name != nullptr)
+            && (!name || buf->name == *name)
+        ) {
+            free_buf = buf.get();
+            break;
+        }
+    }
+    if (!free_buf) {
+        r.bufs.emplace_back(new ThreadBuf);
+        free_buf = r.bufs.back().get();
+        free_buf->tid = r.bufs.size()-1;
+        free_buf->name = "thread " + std::to_string(free_buf->tid);
+        free_buf->ring.resize(Tracer::trace_ring_size);
+    }
+    free_buf->in_use = true;
+    if (name) {
+        free_buf->name = *name;
+        free_buf->named = true;
+    }
+    (void)releaser; //make sure the releaser exists for this thread
+    return free_buf;
+}
+
+ThreadBuf& this_thread_buf()
+{
+    if (my_buf) return *my_buf;
+
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mtx);
+    my_buf = acquire_buf(r, nullptr);
+    return *my_buf;
+}
+
+void record(const char* name, const uint64_t start, const uint64_t end, const uint64_t arg, const bool instant)
+{
+    ThreadBuf& buf = this_thread_buf();
+    Event& ev = buf.ring[buf.written % Tracer::trace_ring_size];
+    buf.written++;
+    ev.start = start;
+    ev.end = end;
+    ev.arg = arg;
+    ev.instant = instant;
+    strncpy(ev.name, name, Tracer::max_name_len);
+    ev.name[Tracer::max_name_len] = 0;
+}
+
+void print_json_str(std::ostream& os, const char* str)
+{
+    os << '"';
+    for(const char* c = str; *c; c++) {
+        if (*c == '"' || *c == '\\') os << '\\';
+        os << *c;
+    }
+    os << '"';
+}
+
+}
+
+uint64_t Tracer::now()
+{
+    #ifdef CMS_TRACE_TSC
+    return __rdtsc();
+    #else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    #endif
+}
+
+void Tracer::complete(const char* name, const uint64_t start)
+{
+    record(name, start, now(), 0, false);
+}
+
+void Tracer::instant(const char* name, const uint64_t arg)
+{
+    const uint64_t t = now();
+    record(name, t, t, arg, true);
+}
+
+void Tracer::set_thread_name(const string& name)
+{
+    if (my_buf) {
+        my_buf->name = name;
+        my_buf->named = true;
+        return;
+    }
+
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mtx);
+    my_buf = acquire_buf(r, &name);
+}
+
+void Tracer::clear()
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mtx);
+    for(auto& buf: r.bufs) buf->written = 0;
+}
+
+void Tracer::dump(const string& fname)
+{
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mtx);
+
+    //Ticks of now() per microsecond, measured over the whole run so far
+    const double wall_us = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - r.wall0).count();
+    const double ticks_per_us = wall_us > 0 ? (double)(now() - r.tsc0)/wall_us : 1.0;
+    const auto to_us = [&](const uint64_t t) {
+        return (double)(int64_t)(t - r.tsc0)/ticks_per_us;
+    };
+
+    std::ofstream f(fname.c_str());
+    if (!f) {
+        const string err = "ERROR: Cannot open trace file '" + fname + "' for writing";
+        std::cerr << err << std::endl;
+        throw std::runtime_error(err);
+    }
+    f << std::fixed << std::setprecision(3);
+    f << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for(const auto& buf: r.bufs) {
+        f << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+        << buf->tid << ",\"args\":{\"name\":";
+        print_json_str(f, buf->name.c_str());
+        f << "}}";
+        first = false;
+
+        const uint64_t num = std::min<uint64_t>(buf->written, trace_ring_size);
+        for(uint64_t i = buf->written - num; i < buf->written; i++) {
+            const Event& ev = buf->ring[i % trace_ring_size];
+            f << ",\n{\"name\":";
+            print_json_str(f, ev.name);
+            f << ",\"pid\":1,\"tid\":" << buf->tid << ",\"ts\":" << to_us(ev.start);
+            if (ev.instant) {
+                f << ",\"ph\":\"i\",\"s\":\"t\",\"args\":{\"n\":" << ev.arg << "}}";
+            } else {
+                f << ",\"ph\":\"X\",\"dur\":" << (double)(ev.end - ev.start)/ticks_per_us << "}";
+            }
+        }
+    }
+    f << "\n]}" << std::endl;
+}
+
+#endif //CMS_TRACE
@@ -0,0 +1,96 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#ifndef CMS_TRACE_H
+#define CMS_TRACE_H
+
+// Hot-path event tracer, compiled in only with cmake -DTRACE_EVENTS=ON (CMS_TRACE).
+//
+// Every thread records into its own fixed-size ring buffer, without locking,
+// timestamped with the TSC where available. Only the last trace_ring_size
+// events of each thread are kept. Recording costs two timestamp reads and a
+// copy of ~48 bytes per event, so the search is not perturbed the way
+// verbose printing is. Names longer than max_name_len are cut. The buffer of
+// a thread that exited is reused by the next thread of the same name, so
+// respawned solver threads do not add buffers. After solving,
+// Tracer::dump() writes the events in Chrome trace-event JSON, which
+// chrome://tracing and Perfetto can open.
+//
+// TRACE_SCOPE(name) records how long the rest of the enclosing block takes,
+// nothing if name is null. The name is copied when the block is left.
+//
+// Without CMS_TRACE the macros expand to nothing.
+
+#ifdef CMS_TRACE
+
+#include <cstdint>
+#include <string>
+
+namespace CMSat {
+
+class Tracer
+{
+public:
+    static constexpr uint32_t trace_ring_size = 1U << 16;
+    static constexpr uint32_t max_name_len = 23;
+
+    static uint64_t now();
+    static void complete(const char* name, const uint64_t start);
+    static void instant(const char* name, const uint64_t arg);
+    static void set_thread_name(const std::string& name);
+
+    //Must not run concurrently with recording threads
+    static void dump(const std::string& fname);
+    static void clear();
+};
+
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* _name) : name(_name), start(Tracer::now()) {}
+    ~TraceScope() { if (name) Tracer::complete(name, start); }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    const uint64_t start;
+};
+
+}
+
+#define TRACE_CAT2(a, b) a##b
+#define TRACE_CAT(a, b) TRACE_CAT2(a, b)
+#define TRACE_SCOPE(name) CMSat::TraceScope TRACE_CAT(trace_scope_, __LINE__)(name)
+#define TRACE_INSTANT(name, arg) CMSat::Tracer::instant(name, arg)
+#define TRACE_THREAD_NAME(name) CMSat::Tracer::set_thread_name(name)
+
+#else
+
+#define TRACE_SCOPE(name) do { } while (0)
+#define TRACE_INSTANT(name, arg) do { } while (0)
+#define TRACE_THREAD_NAME(name) do { } while (0)
+
+#endif //CMS_TRACE
+
+#endif //CMS_TRACE_H
@@ -45,8 +45,7 @@ struct VarData
 #endif
     }
 
-    ///contains the decision level at which the assignment was made.
-    uint32_t level = numeric_limits<uint32_t>::max();
+    //NOTE: decision level and reason are in CNF::varLevel and CNF::varReason
     uint32_t sublevel = numeric_limits<uint32_t>::max();
 
     #ifdef WEIGHTED
@@ -56,9 +55,6 @@ struct VarData
     mpz_class neg_weight = 1.0;
     #endif
 
-    //Reason this got propagated. nullptr means decision/toplevel
-    PropBy reason = PropBy();
-
     lbool assumption = l_Undef;
 
     ///Whether var has been eliminated (var-elim, different component, etc.)
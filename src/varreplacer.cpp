@@ -557,11 +557,13 @@ bool VarReplacer::replace_bnns() {
 
         bool changed = false;
 
-        for (Lit& l: *bnn) {
+        for (uint32_t i = 0; i < bnn->size(); i++) {
+            Lit& l = (*bnn)[i];
             if (isReplaced_fast(l)) {
                 replace_bnn_lit(l, idx, changed);
-                solver->watches[l].push(Watched(idx, WatchType::watch_bnn_t, bnn_pos_t));
-                solver->watches[~l].push(Watched(idx, WatchType::watch_bnn_t, bnn_neg_t));
+                const int32_t w = bnn->weight(i);
+                solver->watches[l].push(Watched(idx, WatchType::watch_bnn_t, bnn_pos_t, w));
+                solver->watches[~l].push(Watched(idx, WatchType::watch_bnn_t, bnn_neg_t, w));
             }
         }
         if (!bnn->set) {
@@ -777,6 +779,14 @@ void VarReplacer::extend_model(const uint32_t var)
         set_sub_var_during_solution_extension(var, sub_var);
 }
 
+//Undoes extend_model(). NOTE: 'var' is OUTER
+void VarReplacer::unextend_model(const uint32_t var)
+{
+    auto it = reverseTable.find(var);
+    if (it == reverseTable.end()) return;
+    for(const uint32_t sub_var: it->second) solver->model[sub_var] = l_Undef;
+}
+
 void VarReplacer::extend_pop_queue(vector<Lit>& pop)
 {
     vector<Lit> extra;
@@ -1275,8 +1285,3 @@ vector<pair<Lit, Lit> > VarReplacer::get_all_binary_xors_outer() const
 
     return ret;
 }
-
-bool VarReplacer::get_scc_depth_warning_triggered() const
-{
-    return scc_finder->depth_warning_triggered();
-}
@@ -41,6 +41,8 @@ using std::vector;
 using std::tuple;
 class Solver;
 class SCCFinder;
+class StateWriter;
+class StateReader;
 
 /**
 @brief Replaces variables with their anti/equivalents
@@ -62,6 +64,7 @@ class VarReplacer
         void extend_model_already_set();
         void extend_model_all();
         void extend_model(const uint32_t var);
+        void unextend_model(const uint32_t var);
         void extend_pop_queue(vector<Lit>& pop);
 
         uint32_t get_var_replaced_with(const uint32_t var) const;
@@ -75,6 +78,8 @@ class VarReplacer
         template<class T> void unserialize_tables(T& ar);
         template<class T> void serialize_tables  (T& ar) const;
 #endif
+        void save_state(StateWriter& w) const;
+        void load_state(StateReader& r);
 
         vector<uint32_t> get_vars_replacing(uint32_t var) const;
         void updateVars(
@@ -110,7 +115,6 @@ class VarReplacer
         size_t mem_used() const;
         vector<std::pair<Lit, Lit> > get_all_binary_xors_outer() const;
         vector<uint32_t> get_vars_replacing_others() const;
-        bool get_scc_depth_warning_triggered() const;
         void delete_frat_cls();
 
     private:
@@ -81,12 +81,14 @@ class Watched {
             assert(t == WatchType::watch_idx_t);
         }
 
-        Watched(const uint32_t idx, WatchType t, BNNPropType bnn_p_t):
+        //For weighted BNNs the literal's weight is stored above the prop type
+        Watched(const uint32_t idx, WatchType t, BNNPropType bnn_p_t, const int32_t weight = 1):
             data1(idx)
             , type(static_cast<int>(t))
-            , data2(bnn_p_t)
+            , data2(((ClOffset)weight << 2) | bnn_p_t)
         {
             DEBUG_WATCHED_DO(assert(t == WatchType::watch_bnn_t));
+            assert(weight > 0 && (uint64_t)weight < 1ULL << (EFFECTIVELY_USEABLE_BITS-2));
         }
 
         Watched() :
@@ -156,7 +158,13 @@ class Watched {
         BNNPropType get_bnn_prop_t() const
         {
             DEBUG_WATCHED_DO(assert(type == static_cast<int>(WatchType::watch_bnn_t)));
-            return (BNNPropType)data2;
+            return (BNNPropType)(data2 & 3);
+        }
+
+        int32_t get_bnn_weight() const
+        {
+            DEBUG_WATCHED_DO(assert(type == static_cast<int>(WatchType::watch_bnn_t)));
+            return data2 >> 2;
         }
 
         /**
@@ -32,6 +32,7 @@ THE SOFTWARE.
 
 #include <limits>
 #include <iostream>
+#include <thread>
 //#define XOR_DEBUG
 
 using namespace CMSat;
@@ -48,16 +49,29 @@ XorFinder::XorFinder(OccSimplifier* _occsimplifier, Solver* _solver) :
     tmp_vars_xor_two.reserve(2000);
 }
 
+bool XorFinder::enough_occs_for_xor(const Clause& cl) const
+{
+    size_t needed_per_ws = 1ULL << (cl.size()-2);
+    //let's allow shortened clauses
+    needed_per_ws >>= 1;
+
+    for(const Lit lit: cl) {
+        if (solver->watches[lit].size() < needed_per_ws) return false;
+        if (solver->watches[~lit].size() < needed_per_ws) return false;
+    }
+    return true;
+}
+
 // Adds found XOR clauses to solver->xorclauses
 void XorFinder::find_xors_based_on_long_clauses() {
     DEBUG_MARKED_CLAUSE_DO(assert(solver->no_marked_clauses()));
 
     vector<Lit> lits;
     for (const auto & offset: occsimplifier->clauses) {
-        if (xor_find_time_limit <= 0) break;
+        if (st.time_limit <= 0 || solver->must_interrupt_asap()) break;
 
         Clause* cl = solver->cl_alloc.ptr(offset);
-        xor_find_time_limit -= 1;
+        st.time_limit -= 1;
 
         //Already freed
         if (cl->freed() || cl->get_removed() || cl->red()) continue;
@@ -69,24 +83,110 @@ void XorFinder::find_xors_based_on_long_clauses() {
         if (!cl->stats.marked_clause ) {
             cl->stats.marked_clause = 1;
             assert(!cl->get_removed());
-
-            size_t needed_per_ws = 1ULL << (cl->size()-2);
-            //let's allow shortened clauses
-            needed_per_ws >>= 1;
-
-            for(const Lit lit: *cl) {
-                if (solver->watches[lit].size() < needed_per_ws) goto next;
-                if (solver->watches[~lit].size() < needed_per_ws) goto next;
-            }
+            if (!enough_occs_for_xor(*cl)) continue;
 
             lits.resize(cl->size());
             std::copy(cl->begin(), cl->end(), lits.begin());
-            findXor(lits, offset, cl->abst);
-            next:;
+            if (findXor(st, lits, offset, cl->abst)) {
+                add_found_xor(Xor(lits, st.poss_xor.getRHS()));
+            }
         }
     }
 }
 
+// Every thread takes chunks of consecutive clauses and looks for XORs on its
+// own search state. All threads spend from the one time limit the serial
+// finder has. The occurrence lists and clauses are only read. Clauses that are part of an XOR found are marked in
+// the shared `ParMarks`, but two threads may still start from two clauses of
+// the same XOR at once, so the XORs found are deduplicated before adding.
+void XorFinder::find_xors_based_on_long_clauses_par(const uint32_t num_threads)
+{
+    const vector<ClOffset>& cls = occsimplifier->clauses;
+    const size_t chunk = 256;
+    ParMarks marks(cls);
+    vector<vector<Xor>> found(num_threads);
+    //Each thread counts what it spends locally and takes it off the shared
+    //budget after every chunk
+    std::atomic<int64_t> budget(st.time_limit);
+    std::atomic<size_t> next_chunk(0);
+
+    auto work = [&](const uint32_t t) {
+        FindState fs;
+        fs.occ_cnt.resize(solver->nVars(), 0);
+        fs.marks = &marks;
+        vector<Lit> lits;
+        for(size_t start = next_chunk.fetch_add(chunk)
+            ; start < cls.size() && budget.load(std::memory_order_relaxed) > 0
+            ; start = next_chunk.fetch_add(chunk)
+        ) {
+            const size_t end = std::min(start+chunk, cls.size());
+            const int64_t left = budget.load(std::memory_order_relaxed);
+            fs.time_limit = left;
+            for(size_t i = start; i < end; i++) {
+                if (fs.time_limit <= 0 || solver->must_interrupt_asap()) break;
+
+                const Clause* cl = solver->cl_alloc.ptr(cls[i]);
+                fs.time_limit -= 1;
+                if (cl->freed() || cl->get_removed() || cl->red()) continue;
+                if (cl->size() > solver->conf.maxXorToFind) continue;
+                if (marks.test_and_set(cls[i])) continue;
+                if (!enough_occs_for_xor(*cl)) continue;
+
+                lits.resize(cl->size());
+                std::copy(cl->begin(), cl->end(), lits.begin());
+                if (findXor(fs, lits, cls[i], cl->abst)) {
+                    found[t].push_back(Xor(lits, fs.poss_xor.getRHS()));
+                }
+            }
+            budget.fetch_sub(left - fs.time_limit, std::memory_order_relaxed);
+        }
+    };
+    vector<std::thread> threads;
+    for(uint32_t t = 0; t < num_threads; t++) threads.push_back(std::thread(work, t));
+    for(auto& th: threads) th.join();
+    st.time_limit = budget.load();
+
+    vector<Xor> xors;
+    for(auto& f: found) for(auto& x: f) xors.push_back(std::move(x));
+    const size_t num_found = xors.size();
+    clean_equivalent_xors(xors);
+    for(const Xor& x: xors) add_found_xor(x);
+
+    verb_print(2, "[occ-xor-par] threads: " << num_threads
+        << " found: " << num_found << " duplicates: " << (num_found - xors.size()));
+}
+
+XorFinder::ParMarks::ParMarks(const vector<ClOffset>& cls) :
+    offsets(cls)
+    , marked(new std::atomic<uint8_t>[cls.size()])
+{
+    std::sort(offsets.begin(), offsets.end());
+    for(size_t i = 0; i < offsets.size(); i++) {
+        marked[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+//Returns offsets.size() if the clause is not in the list
+size_t XorFinder::ParMarks::index_of(const ClOffset offset) const
+{
+    const auto it = std::lower_bound(offsets.begin(), offsets.end(), offset);
+    if (it == offsets.end() || *it != offset) return offsets.size();
+    return it - offsets.begin();
+}
+
+bool XorFinder::ParMarks::test_and_set(const ClOffset offset)
+{
+    const size_t at = index_of(offset);
+    assert(at < offsets.size());
+    return marked[at].exchange(1, std::memory_order_relaxed);
+}
+
+void XorFinder::ParMarks::set(const ClOffset offset)
+{
+    const size_t at = index_of(offset);
+    if (at < offsets.size()) marked[at].store(1, std::memory_order_relaxed);
+}
+
 // NOTE: all in `xorclauses` must be detached at this point
 void XorFinder::clean_equivalent_xors(vector<Xor>& txors) {
     if (!txors.empty()) {
@@ -137,13 +237,16 @@ bool XorFinder::find_xors() {
         1000LL*1000LL*solver->conf.xor_finder_time_limitM
         *solver->conf.global_timeout_multiplier;
 
-    xor_find_time_limit = orig_xor_find_time_limit;
+    st.time_limit = orig_xor_find_time_limit;
 
     occsimplifier->sort_occurs_and_set_abst();
     verb_print(1, "[occ-xor] sort occur list T: " << (cpuTime()-my_time));
     DEBUG_MARKED_CLAUSE_DO(assert(solver->no_marked_clauses()));
 
-    find_xors_based_on_long_clauses();
+    //FRAT needs the clauses behind each XOR, which the threads don't keep
+    const uint32_t num_threads = solver->frat->enabled() ? 1 : solver->conf.xor_finder_threads;
+    if (num_threads > 1) find_xors_based_on_long_clauses_par(num_threads);
+    else find_xors_based_on_long_clauses();
     assert(orig_num_xors + runStats.foundXors == solver->xorclauses.size());
     // TODO FRAT
     /* clean_equivalent_xors(solver->xorclauses); */
@@ -155,8 +258,8 @@ bool XorFinder::find_xors() {
     }
 
     //Print stats
-    const bool time_out = (xor_find_time_limit < 0);
-    const double time_remain = float_div(xor_find_time_limit, orig_xor_find_time_limit);
+    const bool time_out = (st.time_limit < 0);
+    const double time_remain = float_div(st.time_limit, orig_xor_find_time_limit);
     runStats.findTime = cpuTime() - my_time;
     runStats.time_outs += time_out;
     solver->print_xors(solver->xorclauses);
@@ -177,11 +280,13 @@ bool XorFinder::find_xors() {
 }
 
 
-void XorFinder::findXor(vector<Lit>& lits, const ClOffset offset, cl_abst_type abst)
+bool XorFinder::findXor(FindState& fs, vector<Lit>& lits, const ClOffset offset, cl_abst_type abst) const
 {
+    PossibleXor& poss_xor = fs.poss_xor;
+
     //Set this clause as the base for the XOR, fill 'seen'
-    xor_find_time_limit -= lits.size()/4+1;
-    poss_xor.setup(lits, offset, abst, occ_cnt);
+    fs.time_limit -= lits.size()/4+1;
+    poss_xor.setup(lits, offset, abst, fs.occ_cnt);
 
     //Run findXorMatch for the 2 smallest watchlists
     Lit slit = lit_Undef;
@@ -203,21 +308,20 @@ void XorFinder::findXor(vector<Lit>& lits, const ClOffset offset, cl_abst_type a
             smallest2 = num;
         }
     }
-    findXorMatch(solver->watches[slit], slit);
-    findXorMatch(solver->watches[~slit], ~slit);
+    findXorMatch(fs, solver->watches[slit], slit);
+    findXorMatch(fs, solver->watches[~slit], ~slit);
 
     if (!solver->frat->enabled() && lits.size() <= solver->conf.maxXorToFindSlow) {
-        findXorMatch(solver->watches[slit2], slit2);
-        findXorMatch(solver->watches[~slit2], ~slit2);
+        findXorMatch(fs, solver->watches[slit2], slit2);
+        findXorMatch(fs, solver->watches[~slit2], ~slit2);
     }
 
-    if (poss_xor.foundAll()) {
+    const bool found = poss_xor.foundAll();
+    if (found) {
         std::sort(lits.begin(), lits.end());
         for(auto& l: lits) l = l.unsign();
-        Xor found_xor(lits, poss_xor.getRHS());
         SLOW_DEBUG_DO(for(Lit lit: lits) assert(solver->varData[lit.var()].removed == Removed::none));
 
-        add_found_xor(found_xor);
         assert(poss_xor.get_fully_used().size() == poss_xor.get_offsets().size());
         for(uint32_t i = 0; i < poss_xor.get_offsets().size() ; i++) {
             ClOffset offs = poss_xor.get_offsets()[i];
@@ -225,7 +329,8 @@ void XorFinder::findXor(vector<Lit>& lits, const ClOffset offset, cl_abst_type a
             assert(!cl->get_removed());
         }
     }
-    poss_xor.clear_seen(occ_cnt);
+    poss_xor.clear_seen(fs.occ_cnt);
+    return found;
 }
 
 void XorFinder::add_found_xor(const Xor& found_xor)
@@ -241,7 +346,7 @@ void XorFinder::add_found_xor(const Xor& found_xor)
     if (solver->frat->enabled()) {
         solver->chain.clear();
         INC_XID(added);
-        for(const auto& off: poss_xor.get_offsets()) {
+        for(const auto& off: st.poss_xor.get_offsets()) {
             auto cl = *solver->cl_alloc.ptr(off);
             assert(!cl.freed());
             assert(!cl.get_removed());
@@ -252,9 +357,11 @@ void XorFinder::add_found_xor(const Xor& found_xor)
     frat_func_end();
 }
 
-void XorFinder::findXorMatch(watch_subarray_const occ, const Lit wlit)
+void XorFinder::findXorMatch(FindState& fs, watch_subarray_const occ, const Lit wlit) const
 {
-    xor_find_time_limit -= (int64_t)occ.size()/8+1;
+    PossibleXor& poss_xor = fs.poss_xor;
+    vector<uint32_t>& occ_cnt = fs.occ_cnt;
+    fs.time_limit -= (int64_t)occ.size()/8+1;
     for (const Watched& w: occ) {
         if (w.isIdx()) continue;
         assert(poss_xor.getSize() > 2);
@@ -267,16 +374,16 @@ void XorFinder::findXorMatch(watch_subarray_const occ, const Lit wlit)
             if (w.red()) continue;
             if (!occ_cnt[w.lit2().var()]) goto end;
 
-            binvec.clear();
-            binvec.resize(2);
-            binvec[0] = w.lit2();
-            binvec[1] = wlit;
-            if (binvec[0] > binvec[1]) {
-                std::swap(binvec[0], binvec[1]);
+            fs.binvec.clear();
+            fs.binvec.resize(2);
+            fs.binvec[0] = w.lit2();
+            fs.binvec[1] = wlit;
+            if (fs.binvec[0] > fs.binvec[1]) {
+                std::swap(fs.binvec[0], fs.binvec[1]);
             }
 
-            xor_find_time_limit -= 1;
-            poss_xor.add(binvec, numeric_limits<ClOffset>::max(), varsMissing);
+            fs.time_limit -= 1;
+            poss_xor.add(fs.binvec, numeric_limits<ClOffset>::max(), fs.varsMissing);
             if (poss_xor.foundAll())
                 break;
         } else {
@@ -291,7 +398,7 @@ void XorFinder::findXorMatch(watch_subarray_const occ, const Lit wlit)
             if ((w.getBlockedLit().toInt() | poss_xor.getAbst()) != poss_xor.getAbst())
                 continue;
 
-            xor_find_time_limit -= 3;
+            fs.time_limit -= 3;
             const ClOffset offset = w.get_offset();
             Clause& cl = *solver->cl_alloc.ptr(offset);
             if (cl.freed() || cl.get_removed() || cl.red()) {
@@ -341,11 +448,12 @@ void XorFinder::findXorMatch(watch_subarray_const occ, const Lit wlit)
             //there is no point in using this clause as a base for another XOR
             //because exactly the same things will be found.
             if (cl.size() == poss_xor.getSize()) {
-                cl.stats.marked_clause = 1;
+                if (fs.marks) fs.marks->set(offset);
+                else cl.stats.marked_clause = 1;
             }
 
-            xor_find_time_limit -= cl.size()/4+1;
-            poss_xor.add(cl, offset, varsMissing);
+            fs.time_limit -= cl.size()/4+1;
+            poss_xor.add(cl, offset, fs.varsMissing);
             if (poss_xor.foundAll())
                 break;
         }
@@ -402,15 +510,15 @@ size_t XorFinder::mem_used() const
 
     //Temporary
     mem += tmpClause.capacity()*sizeof(Lit);
-    mem += varsMissing.capacity()*sizeof(uint32_t);
+    mem += st.varsMissing.capacity()*sizeof(uint32_t);
 
     return mem;
 }
 
 void XorFinder::grab_mem()
 {
-    occ_cnt.clear();
-    occ_cnt.resize(solver->nVars(), 0);
+    st.occ_cnt.clear();
+    st.occ_cnt.resize(solver->nVars(), 0);
 }
 
 void XorFinder::Stats::print_short(const Solver* solver, double time_remain) const
@@ -31,6 +31,8 @@ THE SOFTWARE.
 #include <algorithm>
 #include <set>
 #include <limits>
+#include <atomic>
+#include <memory>
 #include "constants.h"
 #include "xor.h"
 #include "cset.h"
@@ -42,6 +44,7 @@ using std::set;
 namespace CMSat {
 class Solver;
 class OccSimplifier;
+class Clause;
 
 class PossibleXor {
     public:
@@ -170,9 +173,36 @@ public:
     void clean_equivalent_xors(vector<Xor>& txors);
 
 private:
-    PossibleXor poss_xor;
+    //Clauses whose XOR has already been looked for, shared between the
+    //threads of the parallel search in place of Clause::stats.marked_clause
+    class ParMarks {
+    public:
+        explicit ParMarks(const vector<ClOffset>& cls);
+        bool test_and_set(const ClOffset offset);
+        void set(const ClOffset offset);
+
+    private:
+        size_t index_of(const ClOffset offset) const;
+        vector<ClOffset> offsets; //sorted
+        std::unique_ptr<std::atomic<uint8_t>[]> marked;
+    };
+
+    //State of one XOR search. The serial search uses `st`, each thread of
+    //the parallel one has its own
+    struct FindState {
+        PossibleXor poss_xor;
+        vector<uint32_t> occ_cnt;
+        vector<uint32_t> varsMissing;
+        vector<Lit> binvec;
+        int64_t time_limit = 0;
+        ParMarks* marks = nullptr;
+    };
+    FindState st;
+
     void add_found_xor(const Xor& found_xor);
     void find_xors_based_on_long_clauses();
+    void find_xors_based_on_long_clauses_par(const uint32_t num_threads);
+    bool enough_occs_for_xor(const Clause& cl) const;
     bool xor_has_interesting_var(const Xor& x);
 
     ///xor two -- don't re-allocate memory all the time
@@ -180,13 +210,11 @@ private:
     uint32_t xor_two(Xor const* x1, Xor const* x2, uint32_t& clash_var);
     vector<uint32_t> tmp_vars_xor_two;
 
-    int64_t xor_find_time_limit;
-
-    //Find XORs
-    void findXor(vector<Lit>& lits, const ClOffset offset, cl_abst_type abst);
+    //Find XORs. Returns true if found, `lits` is then the XOR's variables
+    bool findXor(FindState& fs, vector<Lit>& lits, const ClOffset offset, cl_abst_type abst) const;
 
     ///Normal finding of matching clause for XOR
-    void findXorMatch(watch_subarray_const occ, const Lit wlit);
+    void findXorMatch(FindState& fs, watch_subarray_const occ, const Lit wlit) const;
 
     OccSimplifier* occsimplifier;
     Solver *solver;
@@ -197,11 +225,8 @@ private:
 
     //Temporary
     vector<Lit> tmpClause;
-    vector<uint32_t> varsMissing;
-    vector<Lit> binvec;
 
     //Other temporaries
-    vector<uint32_t> occ_cnt;
     vector<Lit>& toClear;
     vector<uint32_t>& seen;
     vector<uint8_t>& seen2;
@@ -27,7 +27,10 @@ THE SOFTWARE.
 #include "test_helper.h"
 #include <vector>
 #include <algorithm>
+#include <random>
+#include <string>
 using std::vector;
+using std::string;
 using namespace CMSat;
 
 struct assump_interf : public ::testing::Test {
@@ -210,6 +213,72 @@ TEST_F(assump_interf, only_assump)
     EXPECT_EQ( ret, l_False);
 }
 
+TEST_F(assump_interf, reuse_prefix)
+{
+    s->new_vars(5);
+    s->add_clause(str_to_cl("-1, 2"));
+    s->add_clause(str_to_cl("-2, 3"));
+    s->add_clause(str_to_cl("-3, -5"));
+
+    assumps = str_to_cl("1, 4");
+    EXPECT_EQ(s->solve(&assumps), l_True);
+    EXPECT_EQ(s->get_model()[2], l_True);
+
+    assumps = str_to_cl("1, 5");
+    EXPECT_EQ(s->solve(&assumps), l_False);
+    EXPECT_EQ(s->okay(), true);
+    vector<Lit> confl = s->get_conflict();
+    std::sort(confl.begin(), confl.end());
+    EXPECT_EQ(confl, str_to_cl("-1, -5"));
+
+    assumps = str_to_cl("1");
+    EXPECT_EQ(s->solve(&assumps), l_True);
+    const string json = s->get_metrics_json();
+    EXPECT_GT(json_field(json, "assump_levels_reused"), 0U);
+
+    //Adding a clause cancels the kept levels
+    s->add_clause(str_to_cl("-1, -4"));
+    assumps = str_to_cl("1, 4");
+    EXPECT_EQ(s->solve(&assumps), l_False);
+    EXPECT_EQ(s->solve(NULL), l_True);
+}
+
+TEST(assump_reuse, same_as_without)
+{
+    std::mt19937 rnd(7);
+    SolverConf conf;
+    SATSolver with(&conf);
+    conf.reuse_assump_trail = 0;
+    SATSolver without(&conf);
+
+    const uint32_t nvars = 40;
+    with.new_vars(nvars);
+    without.new_vars(nvars);
+    auto rnd_lit = [&]() { return Lit(rnd() % nvars, rnd() % 2); };
+    auto add_cl = [&]() {
+        const vector<Lit> cl {rnd_lit(), rnd_lit(), rnd_lit()};
+        with.add_clause(cl);
+        without.add_clause(cl);
+    };
+    for(uint32_t i = 0; i < 150; i++) add_cl();
+
+    vector<Lit> assumps;
+    for(uint32_t i = 0; i < 300; i++) {
+        //Mostly change the tail of the assumptions only
+        assumps.resize(std::min<size_t>(assumps.size(), rnd() % 8));
+        while (assumps.size() < 6) assumps.push_back(rnd_lit());
+        if (rnd() % 50 == 0) add_cl();
+
+        const lbool ret = with.solve(&assumps);
+        ASSERT_EQ(ret, without.solve(&assumps));
+        if (ret == l_True) {
+            for(const Lit l: assumps) EXPECT_EQ(with.get_model()[l.var()], l_True ^ l.sign());
+        } else if (!with.okay()) {
+            break;
+        }
+    }
+}
+
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,416 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+// Microbenchmarks of the solver's hot paths, using Google Benchmark.
+// Build with -DENABLE_BENCHMARKS=ON, then e.g.:
+//
+//   ./cms_bench --benchmark_format=json --benchmark_out=bench.json
+//
+// and compare two such files with Google Benchmark's tools/compare.py.
+// All inputs are generated from a fixed seed, so runs are repeatable.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "src/solver.h"
+#include "src/solverconf.h"
+#include "src/clauseallocator.h"
+#include "src/occsimplifier.h"
+#include "src/subsumestrengthen.h"
+#include "src/reducedb.h"
+#include "src/streambuffer.h"
+#include "src/dimacsparser.h"
+#include "cryptominisat5/cryptominisat.h"
+
+using std::vector;
+using std::string;
+
+namespace CMSat {
+
+//Reaches into the parts of the solver that the benchmarks call directly
+struct BenchAccess {
+    //Returns the size of the learnt clause
+    static size_t analyze_conflict(Solver* s, PropBy confl, uint32_t& btlevel) {
+        uint32_t glue, glue_before, size_before;
+        s->analyze_conflict<false>(confl, btlevel, glue, glue_before, size_before);
+        return s->learnt_clause.size();
+    }
+    static void find_conflict_level(Solver* s, PropBy& confl) {
+        s->find_conflict_level(confl);
+    }
+    static SubsumeStrengthen* sub_str(OccSimplifier* occ) { return occ->sub_str; }
+    static void sort_red_cls(ReduceDB* rdb, ClauseClean t) { rdb->sort_red_cls(t); }
+};
+
+}
+using namespace CMSat;
+
+namespace {
+
+struct BenchSolver {
+    explicit BenchSolver(uint32_t num_vars) {
+        must_inter.store(false, std::memory_order_relaxed);
+        conf.verbosity = 0;
+        s = new Solver(&conf, &must_inter);
+        s->new_vars(num_vars);
+    }
+    ~BenchSolver() { delete s; }
+
+    //Random k-CNF, same clauses every time for the same arguments
+    void add_random_cls(uint32_t num_cls, uint32_t k, uint64_t seed) {
+        std::mt19937_64 rnd(seed);
+        vector<Lit> cl;
+        for(uint32_t i = 0; i < num_cls; i++) {
+            cl.clear();
+            for(uint32_t j = 0; j < k; j++) {
+                cl.push_back(Lit(rnd() % s->nVars(), rnd() & 1));
+            }
+            s->add_clause_outside(cl);
+        }
+    }
+
+    //Decides on random unassigned variables until a conflict, or until
+    //everything is assigned. Returns the conflict, or PropBy() if none.
+    PropBy descend(std::mt19937_64& rnd, uint64_t& props) {
+        while(true) {
+            uint32_t var = rnd() % s->nVars();
+            uint32_t tries = 0;
+            while(s->value(var) != l_Undef && tries++ < s->nVars()) {
+                var = (var+1) % s->nVars();
+            }
+            if (s->value(var) != l_Undef) return PropBy();
+
+            const uint32_t before = s->trail_size();
+            s->new_decision_level();
+            s->enqueue<false>(Lit(var, rnd() & 1));
+            PropBy confl = s->propagate<false>();
+            props += s->trail_size() - before;
+            if (!confl.isnullptr()) return confl;
+        }
+    }
+
+    SolverConf conf;
+    std::atomic<bool> must_inter;
+    Solver* s;
+};
+
+string random_dimacs(uint32_t num_vars, uint32_t num_cls, uint64_t seed) {
+    std::mt19937_64 rnd(seed);
+    string out = "p cnf " + std::to_string(num_vars) + " " + std::to_string(num_cls) + "\n";
+    for(uint32_t i = 0; i < num_cls; i++) {
+        for(uint32_t j = 0; j < 3; j++) {
+            const int64_t v = (rnd() % num_vars) + 1;
+            out += std::to_string((rnd() & 1) ? -v : v);
+            out += ' ';
+        }
+        out += "0\n";
+    }
+    return out;
+}
+
+//Two-watched-literal propagation (PropEngine::propagate_any_order)
+//over a random 3-CNF below the threshold, so most descents are long
+void BM_propagate(benchmark::State& state)
+{
+    const uint32_t n = state.range(0);
+    BenchSolver b(n);
+    b.add_random_cls(n*3, 3, 1);
+    b.add_random_cls(n/2, 2, 2);
+    std::mt19937_64 rnd(3);
+
+    uint64_t props = 0;
+    for (auto _ : state) {
+        b.descend(rnd, props);
+        b.s->cancelUntil(0);
+    }
+    state.counters["props/s"] = benchmark::Counter(props, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_propagate)->Arg(10000)->Arg(200000);
+
+//1UIP conflict analysis and minimisation (Searcher::analyze_conflict).
+//Only the analysis is timed, not the descent that leads to the conflict.
+void BM_analyze_conflict(benchmark::State& state)
+{
+    const uint32_t n = state.range(0);
+    BenchSolver b(n);
+    b.add_random_cls(n*426/100, 3, 4);
+    std::mt19937_64 rnd(5);
+
+    uint64_t props = 0;
+    uint64_t lits = 0;
+    for (auto _ : state) {
+        PropBy confl;
+        while((confl = b.descend(rnd, props)).isnullptr()) b.s->cancelUntil(0);
+        BenchAccess::find_conflict_level(b.s, confl);
+
+        uint32_t btlevel;
+        const auto start = std::chrono::steady_clock::now();
+        lits += BenchAccess::analyze_conflict(b.s, confl, btlevel);
+        const auto end = std::chrono::steady_clock::now();
+        state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+
+        b.s->cancelUntil(0);
+    }
+    state.counters["learnt_size"] = benchmark::Counter(lits, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_analyze_conflict)->Arg(5000)->Arg(100000)->UseManualTime();
+
+//Moving every clause to a fresh arena and fixing up watches and offsets
+//(ClauseAllocator::consolidate)
+void BM_consolidate(benchmark::State& state)
+{
+    const uint32_t n = state.range(0);
+    BenchSolver b(n);
+    b.add_random_cls(n*4, 4, 6);
+
+    for (auto _ : state) {
+        b.s->cl_alloc.consolidate(b.s, true);
+    }
+    state.counters["cls"] = b.s->longIrredCls.size();
+}
+BENCHMARK(BM_consolidate)->Arg(10000)->Arg(200000);
+
+//Gauss-Jordan propagation over a random XOR system. Most of the time
+//is spent in EGaussian::eliminate_col, called from propagation.
+void BM_gauss_eliminate(benchmark::State& state)
+{
+    const uint32_t n = state.range(0);
+    BenchSolver b(n);
+    b.s->conf.gaussconf.autodisable = false;
+    std::mt19937_64 rnd(7);
+    vector<uint32_t> vars;
+    for(uint32_t i = 0; i < n/2; i++) {
+        vars.clear();
+        for(uint32_t j = 0; j < 4; j++) vars.push_back(rnd() % n);
+        b.s->add_xor_clause_outside(vars, rnd() & 1);
+    }
+    if (!b.s->okay() || !b.s->find_and_init_all_matrices() || b.s->gmatrices.empty()) {
+        state.SkipWithError("could not set up Gauss-Jordan matrix");
+        return;
+    }
+
+    uint64_t props = 0;
+    for (auto _ : state) {
+        b.descend(rnd, props);
+        b.s->cancelUntil(0);
+    }
+    state.counters["props/s"] = benchmark::Counter(props, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_gauss_eliminate)->Arg(300)->Arg(900);
+
+//Backward subsumption of every clause through the occurrence lists
+//(SubsumeStrengthen::find_subsumed). Half of the 3-long clauses
+//subsume a 5-long one.
+void BM_find_subsumed(benchmark::State& state)
+{
+    const uint32_t n = state.range(0);
+    BenchSolver b(n);
+    b.add_random_cls(n, 5, 9);
+    std::mt19937_64 rnd(8);
+    vector<Lit> cl;
+    for(uint32_t i = 0; i < n*2; i++) {
+        cl.clear();
+        for(uint32_t j = 0; j < 3; j++) cl.push_back(Lit(rnd() % n, rnd() & 1));
+        b.s->add_clause_outside(cl);
+        if (i % 2 == 0) {
+            for(uint32_t j = 0; j < 2; j++) cl.push_back(Lit(rnd() % n, rnd() & 1));
+            b.s->add_clause_outside(cl);
+        }
+    }
+    OccSimplifier* occ = b.s->occsimplifier;
+    if (!occ->setup()) {
+        state.SkipWithError("could not set up occurrence lists");
+        return;
+    }
+    SubsumeStrengthen* sub = BenchAccess::sub_str(occ);
+
+    vector<Lit> lits;
+    vector<OccurClause> subsumed;
+    uint64_t found = 0;
+    for (auto _ : state) {
+        for(const ClOffset offs: occ->clauses) {
+            const Clause* cl = b.s->cl_alloc.ptr(offs);
+            if (cl->freed() || cl->get_removed()) continue;
+            lits.assign(cl->begin(), cl->end());
+            subsumed.clear();
+            sub->find_subsumed(offs, lits, cl->abst, subsumed);
+            found += subsumed.size();
+        }
+    }
+    state.counters["cls"] = occ->clauses.size();
+    state.counters["subsumed"] = benchmark::Counter(found, benchmark::Counter::kAvgIterations);
+    occ->finish_up(b.s->trail_size());
+}
+BENCHMARK(BM_find_subsumed)->Arg(10000)->Arg(100000);
+
+//DIMACS parsing into the public API from memory (DimacsParser)
+void BM_parse_dimacs(benchmark::State& state)
+{
+    const string text = random_dimacs(state.range(0), state.range(0)*4, 10);
+    for (auto _ : state) {
+        SATSolver solver;
+        DimacsParser<StreamBuffer<const char*, CH>, SATSolver> parser(&solver, nullptr, 0);
+        if (!parser.parse_DIMACS(text.c_str(), true)) {
+            state.SkipWithError("parse error");
+            break;
+        }
+    }
+    state.SetBytesProcessed(state.iterations()*text.size());
+}
+BENCHMARK(BM_parse_dimacs)->Arg(10000)->Arg(200000)->Unit(benchmark::kMillisecond);
+
+//Sorting the level-2 redundant clauses for cleaning (ReduceDB::sort_red_cls)
+void BM_reducedb_sort(benchmark::State& state)
+{
+    const uint32_t num = state.range(0);
+    const ClauseClean clean = (ClauseClean)state.range(1);
+    BenchSolver b(10000);
+    std::mt19937_64 rnd(11);
+    vector<Lit> cl;
+    for(uint32_t i = 0; i < num; i++) {
+        cl.clear();
+        const uint32_t sz = 3 + rnd() % 20;
+        for(uint32_t j = 0; j < sz; j++) cl.push_back(Lit(rnd() % b.s->nVars(), rnd() & 1));
+        std::sort(cl.begin(), cl.end());
+        cl.erase(std::unique(cl.begin(), cl.end()), cl.end());
+
+        ClauseStats stats;
+        stats.glue = 2 + rnd() % (cl.size() - 1);
+        stats.activity = (double)(rnd() % 1000000);
+        stats.which_red_array = 2;
+        Clause* c = b.s->add_clause_int(cl, true, &stats, false);
+        if (c) b.s->longRedCls[2].push_back(b.s->cl_alloc.get_offset(c));
+    }
+
+    const vector<ClOffset> orig = b.s->longRedCls[2];
+    for (auto _ : state) {
+        state.PauseTiming();
+        b.s->longRedCls[2] = orig;
+        state.ResumeTiming();
+        BenchAccess::sort_red_cls(b.s->reduceDB, clean);
+    }
+    state.counters["cls"] = orig.size();
+}
+BENCHMARK(BM_reducedb_sort)
+    ->Args({100000, (int)ClauseClean::glue})
+    ->Args({100000, (int)ClauseClean::activity});
+
+//sum w[i]*lits[i] <= cap as CNF, via a sequential weight counter:
+//s[i][j] is TRUE when the sum over lits[0..i] is at least j+1
+void add_pb_leq_as_cnf(
+    SATSolver& solver, const vector<Lit>& lits, const vector<signed>& w, const signed cap)
+{
+    vector<Lit> prev;
+    vector<Lit> cur;
+    for(size_t i = 0; i < lits.size(); i++) {
+        const Lit x = lits[i];
+        if (w[i] > cap) {
+            solver.add_clause({~x});
+            continue;
+        }
+        if (!prev.empty()) {
+            //overflow
+            if (cap-w[i] < (signed)prev.size()) solver.add_clause({~x, ~prev[cap-w[i]]});
+        }
+        if (i+1 == lits.size()) break;
+
+        const uint32_t first = solver.nVars();
+        solver.new_vars(cap);
+        cur.clear();
+        for(signed j = 0; j < cap; j++) cur.push_back(Lit(first+j, false));
+        for(signed j = 0; j < cap; j++) {
+            if (j < w[i]) solver.add_clause({~x, cur[j]});
+            if (!prev.empty()) {
+                solver.add_clause({~prev[j], cur[j]});
+                if (j+w[i] < cap) solver.add_clause({~x, ~prev[j], cur[j+w[i]]});
+            }
+        }
+        std::swap(prev, cur);
+    }
+}
+
+//Bin packing: every item goes to some bin, and bin capacities are
+//weighted constraints. Either native (SATSolver::add_pb_clause) or the
+//CNF encoding above, range(1) selects which. Compares solving time and
+//the size of the two encodings.
+void BM_pb_bin_packing(benchmark::State& state)
+{
+    const uint32_t bins = state.range(0);
+    const bool native = state.range(1);
+    const signed cap = 100;
+    std::mt19937_64 rnd(12);
+    vector<signed> weights;
+    signed total = 0;
+    while (total < (signed)bins*cap*98/100) {
+        weights.push_back(1 + rnd() % 20);
+        total += weights.back();
+    }
+    const uint32_t items = weights.size();
+
+    uint64_t vars = 0;
+    uint64_t confls = 0;
+    for (auto _ : state) {
+        SATSolver solver;
+        solver.set_max_confl(100000);
+        solver.new_vars(items*bins);
+        vector<Lit> cl;
+        for(uint32_t i = 0; i < items; i++) {
+            cl.clear();
+            for(uint32_t b = 0; b < bins; b++) cl.push_back(Lit(i*bins+b, false));
+            solver.add_clause(cl);
+        }
+        for(uint32_t b = 0; b < bins; b++) {
+            cl.clear();
+            for(uint32_t i = 0; i < items; i++) cl.push_back(Lit(i*bins+b, false));
+            if (native) {
+                vector<signed> neg;
+                for(const signed x: weights) neg.push_back(-x);
+                solver.add_pb_clause(cl, neg, -cap);
+            } else {
+                add_pb_leq_as_cnf(solver, cl, weights, cap);
+            }
+        }
+        if (solver.solve() == l_Undef) {
+            state.SkipWithError("conflict limit reached");
+            break;
+        }
+        vars = solver.nVars();
+        confls += solver.get_sum_conflicts();
+    }
+    state.counters["vars"] = vars;
+    state.counters["conflicts"] = benchmark::Counter(confls, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_pb_bin_packing)
+    ->Args({4, 1})->Args({4, 0})
+    ->Args({8, 1})->Args({8, 0})
+    ->Unit(benchmark::kMillisecond);
+
+}
+
+BENCHMARK_MAIN();
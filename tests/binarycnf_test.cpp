@@ -0,0 +1,183 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+
+#include "gtest/gtest.h"
+
+#include "cryptominisat5/cryptominisat.h"
+#include "src/binarycnf.h"
+#include "test_helper.h"
+using namespace CMSat;
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdio>
+using std::vector;
+using std::string;
+
+TEST(binarycnf, add_clauses)
+{
+    SATSolver s;
+    s.new_vars(3);
+    const vector<Lit> lits = str_to_cl("1, 2, 3, -1, -2, -3, 1, -2", false);
+    const vector<uint64_t> offsets = {0, 3, 5, 6, 8};
+    EXPECT_TRUE(s.add_clauses(lits.data(), offsets.data(), 4));
+    EXPECT_EQ(s.solve(), l_True);
+    EXPECT_EQ(s.get_model()[2], l_False);
+    EXPECT_EQ(s.get_model()[0], l_True);
+
+    s.add_clause(str_to_cl("3"));
+    EXPECT_EQ(s.solve(), l_False);
+}
+
+TEST(binarycnf, add_clauses_threads)
+{
+    SATSolver s;
+    s.set_num_threads(2);
+    s.new_vars(2);
+    const vector<Lit> lits = str_to_cl("1, 2, -1, 2, 1, -2, -1, -2", false);
+    const vector<uint64_t> offsets = {0, 2, 4, 6, 8};
+    s.add_clauses(lits.data(), offsets.data(), 4);
+    EXPECT_EQ(s.solve(), l_False);
+}
+
+TEST(binarycnf, write_and_parse)
+{
+    const string fname = "binarycnf_test.bcnf";
+    {
+        BinaryCnfWriter w;
+        w.new_vars(5);
+        w.add_clause(str_to_cl("1, 2"));
+        w.add_clause(str_to_cl("-1, 3, 4"));
+        w.add_clause(str_to_cl("-5"));
+        w.add_xor_clause(str_to_cl("2, 3, 4"), false);
+        w.add_red_clause(str_to_cl("1, 3"));
+        w.set_sampl_vars({0, 1, 2});
+        w.write(fname);
+    }
+    EXPECT_TRUE(BinaryCnfParser<SATSolver>::is_binary_cnf(fname));
+
+    SATSolver s;
+    BinaryCnfParser<SATSolver> p(&s, 0);
+    ASSERT_TRUE(p.parse(fname));
+    EXPECT_EQ(s.nVars(), 5U);
+    EXPECT_EQ(s.get_sampl_vars(), (vector<uint32_t>{0, 1, 2}));
+
+    s.add_clause(str_to_cl("-2"));
+    s.add_clause(str_to_cl("4"));
+    ASSERT_EQ(s.solve(), l_True);
+    EXPECT_EQ(s.get_model()[0], l_True);
+    EXPECT_EQ(s.get_model()[2], l_True); //-1 V 3 V 4, and 2^3^4 = false
+    EXPECT_EQ(s.get_model()[4], l_False);
+    std::remove(fname.c_str());
+}
+
+TEST(binarycnf, dump_irred_roundtrip)
+{
+    const string fname = "binarycnf_test.bcnf";
+    SATSolver s;
+    s.new_vars(20);
+    for(uint32_t i = 0; i < 19; i++) {
+        s.add_clause(vector<Lit>{Lit(i, true), Lit(i+1, false)});
+    }
+    s.add_xor_clause(vector<uint32_t>{3, 7, 12}, false);
+    s.open_file_and_dump_irred_clauses_binary(fname.c_str());
+
+    SATSolver s2;
+    BinaryCnfParser<SATSolver> p(&s2, 0);
+    ASSERT_TRUE(p.parse(fname));
+    s2.add_clause(str_to_cl("1"));
+    EXPECT_EQ(s2.solve(), l_False);
+
+    SATSolver s3;
+    BinaryCnfParser<SATSolver> p3(&s3, 0);
+    ASSERT_TRUE(p3.parse(fname));
+    s3.add_clause(str_to_cl("-20"));
+    EXPECT_EQ(s3.solve(), l_True);
+    std::remove(fname.c_str());
+}
+
+TEST(binarycnf, bad_input)
+{
+    const string fname = "binarycnf_test.bcnf";
+    {
+        SATSolver s;
+        BinaryCnfParser<SATSolver> p(&s, 0);
+        EXPECT_FALSE(p.parse("no-such-binarycnf-file"));
+    }
+    {
+        BinaryCnfWriter w;
+        w.new_vars(2);
+        w.add_clause(str_to_cl("1, -2"));
+        w.write(fname);
+    }
+    {
+        //Literal out of range: first word of the literal array
+        std::fstream f(fname, std::ios::binary | std::ios::in | std::ios::out);
+        f.seekp(16 + 16 + 8*3);
+        const uint32_t bad = Lit(7, false).toInt();
+        f.write((const char*)&bad, sizeof(bad));
+    }
+    {
+        SATSolver s;
+        BinaryCnfParser<SATSolver> p(&s, 0);
+        EXPECT_FALSE(p.parse(fname));
+    }
+    {
+        //Section too short to even hold its count
+        BinaryCnfWriter w;
+        w.new_vars(2);
+        w.write(fname);
+        std::ofstream f(fname, std::ios::binary | std::ios::app);
+        const uint64_t hdr[2] = {(uint64_t)BinCnfSection::sampl_vars, 0};
+        f.write((const char*)hdr, sizeof(hdr));
+    }
+    {
+        SATSolver s;
+        BinaryCnfParser<SATSolver> p(&s, 0);
+        EXPECT_FALSE(p.parse(fname));
+    }
+    {
+        //Sampling variable out of range
+        BinaryCnfWriter w;
+        w.new_vars(2);
+        w.set_sampl_vars(vector<uint32_t>{0, 5});
+        w.write(fname);
+    }
+    {
+        SATSolver s;
+        BinaryCnfParser<SATSolver> p(&s, 0);
+        EXPECT_FALSE(p.parse(fname));
+    }
+    {
+        std::ofstream f(fname, std::ios::binary | std::ios::trunc);
+        f << "p cnf 1 1\n1 0\n";
+    }
+    EXPECT_FALSE(BinaryCnfParser<SATSolver>::is_binary_cnf(fname));
+    std::remove(fname.c_str());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
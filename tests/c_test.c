@@ -57,6 +57,75 @@ int main(void) {
     assert(model.vals[1].x == L_FALSE);
     assert(model.vals[2].x == L_TRUE);
 
+    cmsat_free(solver);
+
+    // Export in chunks of one constraint
+    solver = cmsat_new();
+    cmsat_new_vars(solver, 4);
+    clause[0] = new_lit(0, false);
+    clause[1] = new_lit(1, false);
+    clause[2] = new_lit(2, false);
+    cmsat_add_clause(solver, clause, 3);
+    clause[0] = new_lit(0, true);
+    clause[1] = new_lit(3, true);
+    cmsat_add_clause(solver, clause, 2);
+
+    c_Lit lits[4];
+    size_t offsets[2];
+    uint8_t flags[1];
+    size_t num_cls = 0;
+    size_t num_lits = 0;
+    size_t n;
+    cmsat_start_getting_constraints(solver, false, false);
+    // A buffer too small for any constraint is an error, not the end
+    n = cmsat_get_next_constraints(solver, lits, 1, offsets, 1, flags);
+    assert(n == (size_t)-1);
+    while ((n = cmsat_get_next_constraints(solver, lits, 4, offsets, 1, flags)) > 0) {
+        assert(n == 1);
+        assert(flags[0] == 0);
+        num_cls += n;
+        num_lits += offsets[n];
+    }
+    cmsat_end_getting_constraints(solver);
+    assert(num_cls == 2);
+    assert(num_lits == 5);
+
+    cmsat_free(solver);
+
+    // Bulk add, variables are created as needed
+    solver = cmsat_new();
+    const int32_t cls[] = {1, 2, 0, -1, 0, 3, 4, 5, 0};
+    bool ok = cmsat_add_clauses(solver, cls, sizeof(cls)/sizeof(cls[0]));
+    assert(ok);
+    assert(cmsat_nvars(solver) == 5);
+    const int32_t xors[] = {3, 4, 0, -4, 5, 0};
+    ok = cmsat_add_xor_clauses(solver, xors, sizeof(xors)/sizeof(xors[0]));
+    assert(ok);
+
+    // Malformed buffers are rejected without adding anything
+    const int32_t unterminated[] = {1, 2};
+    ok = cmsat_add_clauses(solver, unterminated, 2);
+    assert(!ok);
+    const int32_t too_large[] = {INT32_MIN, 0};
+    ok = cmsat_add_clauses(solver, too_large, 2);
+    assert(!ok);
+    assert(cmsat_nvars(solver) == 5);
+
+    const int32_t assumps[] = {3, 0, -3, -5, 0, -3, 0};
+    c_lbool results[3];
+    cmsat_solve_with_assumptions_batch(solver, assumps, sizeof(assumps)/sizeof(assumps[0]), results);
+    assert(results[0].x == L_TRUE);
+    assert(results[1].x == L_FALSE);
+    assert(results[2].x == L_TRUE);
+
+    // Model of the last set: -3 forces 4 by the first XOR, and 5 by the second
+    model = cmsat_get_model(solver);
+    assert(model.num_vals == 5);
+    assert(model.vals[0].x == L_FALSE);
+    assert(model.vals[1].x == L_TRUE);
+    assert(model.vals[2].x == L_FALSE);
+    assert(model.vals[3].x == L_TRUE);
+    assert(model.vals[4].x == L_TRUE);
     cmsat_free(solver);
     return 0;
 }
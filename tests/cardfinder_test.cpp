@@ -193,6 +193,63 @@ TEST_F(card_finder, find_two_product)
     EXPECT_EQ(lits, str_to_cl("1, 2, 3, 4, 5, 6, 7, 8, 9"));
 }
 
+static void add_pairwise_atmost1(Solver* s, uint32_t from, uint32_t to, bool red_last = false)
+{
+    for(uint32_t a = from; a <= to; a++) {
+        for(uint32_t b = a+1; b <= to; b++) {
+            const bool red = red_last && a == to-1;
+            s->add_clause_outside({Lit(a-1, true), Lit(b-1, true)}, red);
+        }
+    }
+}
+
+TEST_F(card_finder, atmost1_to_bnn)
+{
+    add_pairwise_atmost1(s, 1, 6);
+
+    finder->find_cards();
+    ASSERT_EQ(finder->get_cards().size(), 1U);
+    EXPECT_TRUE(finder->atmost1_to_bnns());
+    EXPECT_EQ(s->bnns.size(), 1U);
+    EXPECT_EQ(s->binTri.irredBins, 0U);
+
+    s->new_decision_level();
+    s->enqueue<false>(Lit(2, false));
+    EXPECT_TRUE(s->propagate<false>().isnullptr());
+    for(uint32_t v = 0; v < 6; v++) {
+        EXPECT_EQ(s->value(v), v == 2 ? l_True : l_False);
+    }
+    s->cancelUntil(0);
+
+    s->new_decision_level();
+    s->enqueue<false>(Lit(0, false));
+    s->enqueue<false>(Lit(5, false));
+    EXPECT_FALSE(s->propagate<false>().isnullptr());
+    s->cancelUntil(0);
+}
+
+TEST_F(card_finder, atmost1_to_bnn_not_irred)
+{
+    add_pairwise_atmost1(s, 1, 6, true);
+
+    finder->find_cards();
+    ASSERT_EQ(finder->get_cards().size(), 1U);
+    EXPECT_TRUE(finder->atmost1_to_bnns());
+    EXPECT_EQ(s->bnns.size(), 0U);
+    EXPECT_EQ(s->binTri.irredBins, 14U);
+}
+
+TEST_F(card_finder, atmost1_to_bnn_too_small)
+{
+    add_pairwise_atmost1(s, 1, 4);
+
+    finder->find_cards();
+    ASSERT_EQ(finder->get_cards().size(), 1U);
+    EXPECT_TRUE(finder->atmost1_to_bnns());
+    EXPECT_EQ(s->bnns.size(), 0U);
+    EXPECT_EQ(s->binTri.irredBins, 6U);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,268 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <random>
+#include <thread>
+
+#include "cryptominisat5/cryptominisat.h"
+#include "src/solver.h"
+#include "src/cubefinder.h"
+#include "src/solverconf.h"
+using namespace CMSat;
+#include "test_helper.h"
+
+static vector<vector<Lit>> random_3sat(uint32_t num_vars, uint32_t num_cls, uint32_t seed)
+{
+    std::mt19937 mtrand(seed);
+    vector<vector<Lit>> cls;
+    for(uint32_t i = 0; i < num_cls; i++) {
+        vector<Lit> cl;
+        while(cl.size() < 3) {
+            const Lit l(mtrand() % num_vars, mtrand() % 2);
+            bool dup = false;
+            for(const Lit l2: cl) dup |= (l2.var() == l.var());
+            if (!dup) cl.push_back(l);
+        }
+        cls.push_back(cl);
+    }
+    return cls;
+}
+
+//Pigeons in holes. Every clause gets ~sel, so it is UNSAT only when sel is assumed
+static vector<vector<Lit>> pigeonhole(uint32_t holes, uint32_t& num_vars, Lit sel)
+{
+    const uint32_t pigeons = holes+1;
+    num_vars = pigeons*holes + 1;
+    vector<vector<Lit>> cls;
+    for(uint32_t p = 0; p < pigeons; p++) {
+        vector<Lit> cl;
+        for(uint32_t h = 0; h < holes; h++) cl.push_back(Lit(1+p*holes+h, false));
+        cls.push_back(cl);
+    }
+    for(uint32_t h = 0; h < holes; h++) {
+        for(uint32_t p1 = 0; p1 < pigeons; p1++) {
+            for(uint32_t p2 = p1+1; p2 < pigeons; p2++) {
+                cls.push_back({Lit(1+p1*holes+h, true), Lit(1+p2*holes+h, true)});
+            }
+        }
+    }
+    if (sel != lit_Undef) for(auto& cl: cls) cl.push_back(~sel);
+    return cls;
+}
+
+struct cube_finder : public ::testing::Test {
+    cube_finder()
+    {
+        must_inter.store(false, std::memory_order_relaxed);
+        SolverConf conf;
+        //conf.verbosity = 1;
+        s = new Solver(&conf, &must_inter);
+        s->new_vars(12);
+        finder = new CubeFinder(s);
+    }
+    ~cube_finder()
+    {
+        delete finder;
+        delete s;
+    }
+    Solver* s = NULL;
+    CubeFinder* finder = NULL;
+    std::atomic<bool> must_inter;
+};
+
+TEST_F(cube_finder, no_clauses)
+{
+    vector<vector<Lit>> cubes;
+    EXPECT_TRUE(finder->find({}, 3, cubes));
+    EXPECT_EQ(cubes.size(), 8U);
+    for(const auto& cube: cubes) EXPECT_EQ(cube.size(), 3U);
+}
+
+TEST_F(cube_finder, depth_zero)
+{
+    s->add_clause_outside(str_to_cl("1, 2"));
+    vector<vector<Lit>> cubes;
+    EXPECT_TRUE(finder->find({}, 0, cubes));
+    ASSERT_EQ(cubes.size(), 1U);
+    EXPECT_TRUE(cubes[0].empty());
+}
+
+TEST_F(cube_finder, conflicting_assumps)
+{
+    s->add_clause_outside(str_to_cl("-1"));
+    vector<vector<Lit>> cubes;
+    EXPECT_FALSE(finder->find(str_to_cl("1"), 3, cubes));
+}
+
+//Every solution must be in exactly one cube
+TEST_F(cube_finder, cover_solutions)
+{
+    const auto cls = random_3sat(12, 40, 3);
+    for(const auto& cl: cls) ASSERT_TRUE(s->add_clause_outside(cl));
+    const vector<Lit> assumps = str_to_cl("-12");
+
+    vector<vector<Lit>> cubes;
+    ASSERT_TRUE(finder->find(assumps, 4, cubes));
+    EXPECT_LE(cubes.size(), 16U);
+    EXPECT_EQ(s->decisionLevel(), 0U);
+
+    uint32_t num_sols = 0;
+    for(uint32_t x = 0; x < (1U << 12); x++) {
+        const auto val = [&](const Lit l) { return (bool)((x >> l.var()) & 1) ^ l.sign(); };
+        bool sat = val(assumps[0]);
+        for(const auto& cl: cls) {
+            bool cl_sat = false;
+            for(const Lit l: cl) cl_sat |= val(l);
+            sat &= cl_sat;
+        }
+        if (!sat) continue;
+        num_sols++;
+
+        uint32_t in_cubes = 0;
+        for(const auto& cube: cubes) {
+            bool in = true;
+            for(const Lit l: cube) in &= val(l);
+            in_cubes += in;
+        }
+        EXPECT_EQ(in_cubes, 1U);
+    }
+    EXPECT_GT(num_sols, 0U);
+}
+
+static SATSolver* new_cube_solver(uint32_t threads, uint32_t depth)
+{
+    SolverConf conf;
+    conf.cube_confl_budget = 50;
+    conf.cube_warmup_confl = 50;
+    SATSolver* s = new SATSolver(&conf);
+    s->set_num_threads(threads);
+    s->set_cube_and_conquer(depth);
+    return s;
+}
+
+TEST(cube_and_conquer, same_as_single_thread)
+{
+    for(uint32_t seed = 0; seed < 10; seed++) {
+        const auto cls = random_3sat(80, 340, seed);
+        SATSolver single;
+        single.new_vars(80);
+        for(const auto& cl: cls) single.add_clause(cl);
+        const lbool expected = single.solve();
+
+        SATSolver* s = new_cube_solver(4, 4);
+        s->new_vars(80);
+        for(const auto& cl: cls) s->add_clause(cl);
+        const lbool ret = s->solve();
+        EXPECT_EQ(ret, expected);
+        if (ret == l_True) {
+            const auto& model = s->get_model();
+            for(const auto& cl: cls) {
+                bool sat = false;
+                for(const Lit l: cl) sat |= (model[l.var()] == (l.sign() ? l_False : l_True));
+                EXPECT_TRUE(sat);
+            }
+        }
+        delete s;
+    }
+}
+
+TEST(cube_and_conquer, unsat)
+{
+    uint32_t num_vars;
+    const auto cls = pigeonhole(7, num_vars, lit_Undef);
+    SATSolver* s = new_cube_solver(4, 5);
+    s->new_vars(num_vars);
+    for(const auto& cl: cls) s->add_clause(cl);
+    EXPECT_EQ(s->solve(), l_False);
+    EXPECT_FALSE(s->okay());
+    delete s;
+}
+
+TEST(cube_and_conquer, unsat_under_assumptions)
+{
+    uint32_t num_vars;
+    const Lit sel(0, false);
+    const auto cls = pigeonhole(7, num_vars, sel);
+    SATSolver* s = new_cube_solver(3, 5);
+    s->new_vars(num_vars + 1);
+    for(const auto& cl: cls) s->add_clause(cl);
+
+    //The extra assumption plays no part in the conflict
+    const Lit extra(num_vars, true);
+    vector<Lit> assumps = {extra, sel};
+    EXPECT_EQ(s->solve(&assumps), l_False);
+    EXPECT_TRUE(s->okay());
+    const auto conflict = s->get_conflict();
+    EXPECT_NE(std::find(conflict.begin(), conflict.end(), ~sel), conflict.end());
+    for(const Lit l: conflict) {
+        EXPECT_NE(std::find(assumps.begin(), assumps.end(), ~l), assumps.end());
+    }
+
+    //And without the selector it is SAT
+    assumps = {extra};
+    EXPECT_EQ(s->solve(&assumps), l_True);
+    EXPECT_EQ(s->get_model()[sel.var()], l_False);
+    delete s;
+}
+
+//A deep lookahead over many candidates takes long, the limits must stop it
+static SATSolver* new_slow_split_solver()
+{
+    SolverConf conf;
+    conf.cube_warmup_confl = 10;
+    conf.cube_lookahead_cands = 1000;
+    SATSolver* s = new SATSolver(&conf);
+    s->set_num_threads(2);
+    s->set_cube_and_conquer(20);
+    uint32_t num_vars;
+    const auto cls = pigeonhole(11, num_vars, lit_Undef);
+    s->new_vars(num_vars);
+    for(const auto& cl: cls) s->add_clause(cl);
+    return s;
+}
+
+TEST(cube_and_conquer, max_time_during_split)
+{
+    SATSolver* s = new_slow_split_solver();
+    s->set_max_time(0.2);
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(s->solve(), l_Undef);
+    EXPECT_LT(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), 5.0);
+    delete s;
+}
+
+TEST(cube_and_conquer, interrupt_during_split)
+{
+    SATSolver* s = new_slow_split_solver();
+    std::thread stopper([s]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        s->interrupt_asap();
+    });
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(s->solve(), l_Undef);
+    EXPECT_LT(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), 5.0);
+    stopper.join();
+    delete s;
+}
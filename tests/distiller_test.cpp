@@ -185,6 +185,49 @@ TEST_F(distill_test, litrem_3)
     check_irred_cls_contains(s, "1, 2, 7");
 }
 
+//Parallel distillation only kicks in with enough clauses, these 1500 are
+//over their own variables and cannot be distilled
+static void add_par_filler(Solver* s)
+{
+    const uint32_t start = s->nVars();
+    s->new_vars(1500*3);
+    for(uint32_t i = 0; i < 1500; i++) {
+        vector<Lit> cl;
+        for(uint32_t j = 0; j < 3; j++) cl.push_back(Lit(start+i*3+j, j == 1));
+        s->add_clause_outside(cl);
+    }
+}
+
+TEST_F(distill_test, par_long_by1)
+{
+    s->conf.distill_threads = 2;
+    s->new_vars(5);
+    s->add_clause_outside(str_to_cl("1, -5"));
+    s->add_clause_outside(str_to_cl("5, -2"));
+    s->add_clause_outside(str_to_cl("1, 2, 3, 4"));
+    add_par_filler(s);
+
+    distill_long_cls->distill(false);
+    check_irred_cls_contains(s, "1, 3, 4");
+    EXPECT_EQ(s->longIrredCls.size(), 1501U);
+}
+
+TEST_F(distill_test, par_remove_only_one_of_two)
+{
+    //Each one is redundant given the other, only one may go
+    s->conf.distill_threads = 3;
+    s->new_vars(10);
+    s->add_clause_outside(str_to_cl("-3, 5"));
+    s->add_clause_outside(str_to_cl("-3, -5"));
+    s->add_clause_outside(str_to_cl("-4, 5"));
+    s->add_clause_outside(str_to_cl("-4, -5"));
+    s->add_clause_outside(str_to_cl("1, 2, 3"));
+    s->add_clause_outside(str_to_cl("1, 2, 4"));
+    add_par_filler(s);
+
+    distill_long_cls->distill(false, true);
+    EXPECT_EQ(s->longIrredCls.size(), 1501U);
+}
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,124 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+
+
+#include "gtest/gtest.h"
+
+#include "src/inprocess_sched.h"
+using namespace CMSat;
+#include <vector>
+#include <string>
+using std::vector;
+using std::string;
+
+static InprocessSched::Snapshot snap(uint64_t cls, uint64_t lits, uint64_t assigned = 0)
+{
+    InprocessSched::Snapshot s;
+    s.cls = cls;
+    s.lits = lits;
+    s.assigned = assigned;
+    return s;
+}
+
+TEST(inprocess_sched, record_yield)
+{
+    InprocessSched sched;
+    EXPECT_EQ(sched.get_stats("sub-impl"), nullptr);
+
+    sched.record("sub-impl", snap(100, 400, 3), snap(90, 370, 5), 0.5);
+    //Added clauses are not negative yield
+    sched.record("sub-impl", snap(90, 370, 5), snap(95, 390, 5), 0.5);
+
+    const auto* p = sched.get_stats("sub-impl");
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(p->calls, 2U);
+    EXPECT_EQ(p->cls_removed, 10U);
+    EXPECT_EQ(p->lits_removed, 30U);
+    EXPECT_EQ(p->units, 2U);
+    EXPECT_EQ(p->yield(), 42U);
+    EXPECT_DOUBLE_EQ(p->yield_per_sec(), 42.0);
+}
+
+TEST(inprocess_sched, backoff)
+{
+    InprocessSched sched;
+    const auto s = snap(10, 30);
+    EXPECT_FALSE(sched.should_skip("distill-cls"));
+
+    //1st useless run: not skipped, 2nd: skip 1, 3rd: skip 3
+    sched.record("distill-cls", s, s, 0.1);
+    EXPECT_FALSE(sched.should_skip("distill-cls"));
+    sched.record("distill-cls", s, s, 0.1);
+    EXPECT_TRUE(sched.should_skip("distill-cls"));
+    EXPECT_FALSE(sched.should_skip("distill-cls"));
+    sched.record("distill-cls", s, s, 0.1);
+    for(int i = 0; i < 3; i++) EXPECT_TRUE(sched.should_skip("distill-cls"));
+    EXPECT_FALSE(sched.should_skip("distill-cls"));
+    EXPECT_EQ(sched.get_stats("distill-cls")->skipped, 4U);
+
+    //Finding something resets it
+    sched.record("distill-cls", snap(10, 30), snap(9, 27), 0.1);
+    EXPECT_FALSE(sched.should_skip("distill-cls"));
+    EXPECT_EQ(sched.get_stats("distill-cls")->useless_streak, 0U);
+}
+
+TEST(inprocess_sched, reorder)
+{
+    InprocessSched sched;
+    sched.record("sub-impl", snap(10, 30), snap(9, 28), 1.0);
+    sched.record("distill-cls", snap(100, 300), snap(50, 150), 1.0);
+
+    vector<string> tokens = {"sub-impl", "distill-cls", "occ-bve",
+        "sub-impl", "str-impl", "distill-cls", "renumber", ""};
+    sched.reorder(tokens);
+
+    //Not yet run passes first, non-adaptable tokens stay put
+    const vector<string> expected = {"distill-cls", "sub-impl", "occ-bve",
+        "str-impl", "distill-cls", "sub-impl", "renumber", ""};
+    EXPECT_EQ(tokens, expected);
+}
+
+TEST(inprocess_sched, budget_mult)
+{
+    InprocessSched sched;
+    EXPECT_DOUBLE_EQ(sched.budget_mult("sub-impl"), 1.0);
+
+    sched.record("sub-impl", snap(10, 10), snap(10, 10), 1.0);
+    sched.record("distill-cls", snap(100, 100), snap(50, 50), 1.0);
+    sched.record("str-impl", snap(100, 100), snap(75, 75), 1.0);
+
+    //avg yield/s is 50
+    EXPECT_DOUBLE_EQ(sched.budget_mult("sub-impl"), 0.25);
+    EXPECT_DOUBLE_EQ(sched.budget_mult("distill-cls"), 2.0);
+    EXPECT_DOUBLE_EQ(sched.budget_mult("str-impl"), 1.0);
+
+    //Non-adaptable passes do not count towards the average
+    sched.record("occ", snap(1000, 1000), snap(0, 0), 1.0);
+    EXPECT_DOUBLE_EQ(sched.budget_mult("str-impl"), 1.0);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
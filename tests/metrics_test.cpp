@@ -0,0 +1,111 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+
+
+#include "gtest/gtest.h"
+
+#include "cryptominisat5/cryptominisat.h"
+#include "src/metrics.h"
+#include "test_helper.h"
+using namespace CMSat;
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdio>
+using std::vector;
+using std::string;
+
+TEST(metrics, buckets)
+{
+    EXPECT_EQ(Metrics::bucket_of(0), 0U);
+    EXPECT_EQ(Metrics::bucket_of(1), 1U);
+    EXPECT_EQ(Metrics::bucket_of(2), 2U);
+    EXPECT_EQ(Metrics::bucket_of(3), 2U);
+    EXPECT_EQ(Metrics::bucket_of(4), 3U);
+    EXPECT_EQ(Metrics::bucket_of(~0ULL), Metrics::hist_buckets-1);
+}
+
+TEST(metrics, record_and_sum)
+{
+    Metrics a;
+    Metrics b;
+    a.set(Metrics::conflicts, 10);
+    b.set(Metrics::conflicts, 5);
+    a.set_mem(Metrics::mem_watches, 100);
+    a.record(Metrics::reducedb_pause, 0.000003);
+    b.record(Metrics::reducedb_pause, 0.002);
+    EXPECT_EQ(a.get_hist_count(Metrics::reducedb_pause), 1U);
+    EXPECT_EQ(a.get_hist_bucket(Metrics::reducedb_pause, 2), 1U);
+    EXPECT_EQ(b.get_hist_sum_us(Metrics::reducedb_pause), 2000U);
+
+    const string json = Metrics::to_json({&a, &b}, 1.5);
+    EXPECT_EQ(json_field(json, "conflicts"), 15U);
+    EXPECT_EQ(json_field(json, "threads"), 2U);
+    EXPECT_EQ(json_field(json, "watches"), 100U);
+    EXPECT_NE(json.find("\"thread_conflicts\":[10,5]"), string::npos);
+    EXPECT_NE(json.find("\"reducedb_pause_us\":{\"count\":2,\"sum\":2003"), string::npos);
+}
+
+TEST(metrics, after_solve)
+{
+    SATSolver s;
+    add_php(s, 7);
+    EXPECT_EQ(s.solve(), l_False);
+    const string json = s.get_metrics_json();
+    EXPECT_EQ(json_field(json, "conflicts"), s.get_sum_conflicts());
+    EXPECT_GT(json_field(json, "propagations"), 0U);
+    EXPECT_GT(json_field(json, "decisions"), 0U);
+    EXPECT_GT(json_field(json, "longclauses"), 0U);
+}
+
+TEST(metrics, dump_file)
+{
+    const string fname = "metrics_test.jsonl";
+    SATSolver s;
+    s.set_num_threads(2);
+    EXPECT_THROW(s.set_metrics_file(fname, 0), std::runtime_error);
+    s.set_metrics_file(fname, 0.01);
+    add_php(s, 7);
+    EXPECT_EQ(s.solve(), l_False);
+
+    std::ifstream in(fname);
+    string line;
+    string last;
+    uint32_t lines = 0;
+    while (std::getline(in, line)) {
+        EXPECT_EQ(line.front(), '{');
+        EXPECT_EQ(line.back(), '}');
+        last = line;
+        lines++;
+    }
+    EXPECT_GE(lines, 1U);
+    EXPECT_EQ(json_field(last, "threads"), 2U);
+    EXPECT_EQ(json_field(last, "conflicts"), s.get_sum_conflicts());
+    std::remove(fname.c_str());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
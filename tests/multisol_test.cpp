@@ -28,11 +28,166 @@ THE SOFTWARE.
 // 5) run: ./readme_test
 
 #include <cryptominisat5/cryptominisat.h>
+#include "src/solverconf.h"
 #include <cassert>
 #include <vector>
+#include <chrono>
+#include <random>
+#include <iostream>
 using std::vector;
 using namespace CMSat;
 
+// Some random 3-CNF with a few thousand solutions
+static void add_problem(SATSolver& solver, const uint32_t num_vars, const uint32_t num_cls)
+{
+    std::mt19937 mtrand(7);
+    solver.new_vars(num_vars);
+    vector<Lit> cl;
+    for(uint32_t i = 0; i < num_cls; i++) {
+        cl.clear();
+        for(uint32_t j = 0; j < 3; j++) {
+            cl.push_back(Lit(mtrand() % num_vars, mtrand() % 2));
+        }
+        solver.add_clause(cl);
+    }
+}
+
+static double seconds_since(const std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Counts the solutions, projected on the first "num_proj" variables, both by
+// banning them one-by-one via solve() and by enumerate_solutions()
+static void compare_enumeration(const uint32_t num_vars, const uint32_t num_cls, const uint32_t num_proj)
+{
+    vector<uint32_t> proj;
+    for(uint32_t i = 0; i < num_proj; i++) proj.push_back(i);
+
+    SATSolver s1;
+    add_problem(s1, num_vars, num_cls);
+    if (num_proj < num_vars) s1.set_sampl_vars(proj);
+    auto start = std::chrono::steady_clock::now();
+    uint64_t num_ban = 0;
+    vector<Lit> clause;
+    while(s1.solve() == l_True) {
+        num_ban++;
+        clause.clear();
+        for(const uint32_t v: proj) {
+            clause.push_back(Lit(v, s1.get_model()[v] == l_True));
+        }
+        s1.add_clause(clause);
+    }
+    const double time_ban = seconds_since(start);
+
+    SATSolver s2;
+    add_problem(s2, num_vars, num_cls);
+    if (num_proj < num_vars) s2.set_sampl_vars(proj);
+    start = std::chrono::steady_clock::now();
+    uint64_t num_enum = 0;
+    const lbool ret = s2.enumerate_solutions([&](const vector<lbool>& model) {
+        for(const uint32_t v: proj) assert(model[v] != l_Undef);
+        num_enum++;
+        return true;
+    });
+    const double time_enum = seconds_since(start);
+    assert(ret == l_False);
+
+    std::cout
+    << "Vars: " << num_vars << " projected on: " << num_proj
+    << " solutions: " << num_enum
+    << " models/s with banning: " << (double)num_ban/time_ban
+    << " with enumerate_solutions(): " << (double)num_enum/time_enum
+    << std::endl;
+    assert(num_ban == num_enum);
+
+    //Stopping early
+    SATSolver s3;
+    add_problem(s3, num_vars, num_cls);
+    if (num_proj < num_vars) s3.set_sampl_vars(proj);
+    uint64_t num_stopped = 0;
+    const lbool ret_stopped = s3.enumerate_solutions([&](const vector<lbool>&) {
+        return ++num_stopped < 10;
+    });
+    assert(ret_stopped == (num_enum < 10 ? l_False : l_True));
+    assert(num_stopped == std::min<uint64_t>(10, num_enum));
+}
+
+// Few free variables, and many variables defined as the AND of two of them.
+// Variable elimination removes the defined ones, so every model has to be
+// extended to them
+struct AndDef {
+    Lit y;
+    Lit a;
+    Lit b;
+};
+
+static vector<AndDef> defined_problem(const uint32_t num_free, const uint32_t num_defined)
+{
+    std::mt19937 mtrand(11);
+    vector<AndDef> defs;
+    for(uint32_t i = 0; i < num_defined; i++) {
+        const uint32_t a_var = mtrand() % num_free;
+        const uint32_t b_var = (a_var + 1 + mtrand() % (num_free-1)) % num_free;
+        defs.push_back(AndDef{Lit(num_free + i, false), Lit(a_var, mtrand() % 2), Lit(b_var, mtrand() % 2)});
+    }
+    return defs;
+}
+
+static bool lit_true(const vector<lbool>& model, const Lit l)
+{
+    return model[l.var()] == (l.sign() ? l_False : l_True);
+}
+
+// Enumerates solutions projected on the free variables, extending each model
+// over the whole eliminated-clause stack, or only over what changed since the
+// previous model
+static void compare_extension(const uint32_t num_free, const uint32_t num_defined, const uint64_t max_sols)
+{
+    const vector<AndDef> defs = defined_problem(num_free, num_defined);
+    vector<uint32_t> proj;
+    for(uint32_t i = 0; i < num_free; i++) proj.push_back(i);
+
+    double time[2];
+    for(int incremental = 0; incremental < 2; incremental++) {
+        SolverConf conf;
+        conf.incremental_extend = incremental;
+        conf.simplify_at_startup = 1; //eliminate before the first model
+        SATSolver s(&conf);
+        s.new_vars(num_free + num_defined);
+        for(const auto& d: defs) {
+            s.add_clause(vector<Lit>{~d.y, d.a});
+            s.add_clause(vector<Lit>{~d.y, d.b});
+            s.add_clause(vector<Lit>{d.y, ~d.a, ~d.b});
+        }
+        s.set_sampl_vars(proj);
+
+        //Check some of the models after, so checking is not timed
+        uint64_t num = 0;
+        vector<vector<lbool>> to_check;
+        const auto start = std::chrono::steady_clock::now();
+        const lbool ret = s.enumerate_solutions([&](const vector<lbool>& model) {
+            if (num++ % 64 == 0) to_check.push_back(model);
+            return true;
+        }, max_sols);
+        time[incremental] = seconds_since(start);
+        assert(ret == l_True);
+        assert(num == max_sols);
+        for(const auto& model: to_check) {
+            for(const auto& d: defs) {
+                assert(lit_true(model, d.y) == (lit_true(model, d.a) && lit_true(model, d.b)));
+            }
+        }
+    }
+
+    std::cout
+    << "Vars: " << num_free + num_defined << " projected on: " << num_free
+    << " models: " << max_sols
+    << " models/s with full extension: " << (double)max_sols/time[0]
+    << " with incremental extension: " << (double)max_sols/time[1]
+    << std::endl;
+}
+
 int main()
 {
     SATSolver solver;
@@ -80,5 +235,9 @@ int main()
         }
     }
 
+    compare_enumeration(40, 150, 40);
+    compare_enumeration(60, 230, 20);
+    compare_extension(200, 20000, 3000);
+
     return 0;
 }
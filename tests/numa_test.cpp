@@ -0,0 +1,78 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+
+#include "gtest/gtest.h"
+
+#include "cryptominisat5/cryptominisat.h"
+#include "src/numa.h"
+#include "test_helper.h"
+using namespace CMSat;
+#include <vector>
+#include <set>
+using std::vector;
+
+TEST(numa, from_string)
+{
+    EXPECT_EQ(thread_pinning_from_string("none"), ThreadPinning::none);
+    EXPECT_EQ(thread_pinning_from_string("core"), ThreadPinning::core);
+    EXPECT_EQ(thread_pinning_from_string("node"), ThreadPinning::node);
+    EXPECT_THROW(thread_pinning_from_string("socket"), std::runtime_error);
+}
+
+TEST(numa, cpus_for_thread)
+{
+    NumaTopology numa;
+    ASSERT_GE(numa.num_nodes(), 1U);
+    EXPECT_TRUE(numa.cpus_for_thread(ThreadPinning::none, 0).empty());
+
+    for(unsigned t = 0; t < 2*numa.num_nodes(); t++) {
+        const auto& node_cpus = numa.cpus_of_node(t % numa.num_nodes());
+        const std::set<int> allowed(node_cpus.begin(), node_cpus.end());
+
+        const auto node = numa.cpus_for_thread(ThreadPinning::node, t);
+        EXPECT_EQ(node, node_cpus);
+
+        const auto core = numa.cpus_for_thread(ThreadPinning::core, t);
+        ASSERT_EQ(core.size(), 1U);
+        EXPECT_TRUE(allowed.count(core[0]));
+    }
+}
+
+TEST(numa, pinned_solve)
+{
+    SATSolver s;
+    s.set_num_threads(3);
+    s.set_thread_pinning("core");
+    s.new_vars(3);
+    s.add_clause(str_to_cl("1, 2"));
+    s.add_clause(str_to_cl("-1"));
+    EXPECT_EQ(s.solve(), l_True);
+    EXPECT_EQ(s.get_model()[1], l_True);
+    EXPECT_THROW(s.set_thread_pinning("all"), std::runtime_error);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,260 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+#include "gtest/gtest.h"
+
+#include "cryptominisat5/cryptominisat.h"
+#include "src/opbparser.h"
+#include "src/solverconf.h"
+#include "test_helper.h"
+using namespace CMSat;
+#include <vector>
+#include <random>
+#include <stdexcept>
+using std::vector;
+
+struct PB {
+    vector<Lit> lits;
+    vector<signed> weights;
+    signed cutoff;
+    Lit out;
+
+    bool eval(const vector<lbool>& model) const {
+        int64_t lhs = 0;
+        for(size_t i = 0; i < lits.size(); i++) {
+            if ((model[lits[i].var()] == l_True) ^ lits[i].sign()) lhs += weights[i];
+        }
+        const bool ret = lhs >= cutoff;
+        if (out == lit_Undef) return ret;
+        return ret == ((model[out.var()] == l_True) ^ out.sign());
+    }
+};
+
+static uint64_t count_brute(const vector<PB>& pbs, const uint32_t num_vars)
+{
+    uint64_t num = 0;
+    vector<lbool> model(num_vars);
+    for(uint64_t a = 0; a < (1ULL << num_vars); a++) {
+        for(uint32_t i = 0; i < num_vars; i++) model[i] = boolToLBool((a >> i) & 1);
+        bool ok = true;
+        for(const auto& pb: pbs) ok &= pb.eval(model);
+        num += ok;
+    }
+    return num;
+}
+
+//Counts models with blocking clauses, checking each one
+static uint64_t count_solver(SATSolver& s, const vector<PB>& pbs, const uint32_t num_vars)
+{
+    uint64_t num = 0;
+    while (s.solve() == l_True) {
+        const auto& model = s.get_model();
+        for(const auto& pb: pbs) EXPECT_TRUE(pb.eval(model));
+        vector<Lit> block;
+        for(uint32_t i = 0; i < num_vars; i++) block.push_back(Lit(i, model[i] == l_True));
+        s.add_clause(block);
+        num++;
+    }
+    return num;
+}
+
+TEST(pb_test, propagates_heavy_lit)
+{
+    SATSolver s;
+    s.new_vars(4);
+    // 5*x1 + x2 + x3 + x4 >= 6, so x1 must be TRUE
+    s.add_pb_clause(str_to_cl("1, 2, 3, 4"), {5, 1, 1, 1}, 6);
+    EXPECT_EQ(s.solve(), l_True);
+    EXPECT_EQ(s.get_model()[0], l_True);
+
+    vector<Lit> assumps = str_to_cl("-1");
+    EXPECT_EQ(s.solve(&assumps), l_False);
+}
+
+TEST(pb_test, negative_weights)
+{
+    SATSolver s;
+    s.new_vars(2);
+    // 2*x1 + 3*x2 <= 3, i.e. not both
+    s.add_pb_clause(str_to_cl("1, 2"), {-2, -3}, -3);
+    vector<Lit> assumps = str_to_cl("1, 2");
+    EXPECT_EQ(s.solve(&assumps), l_False);
+    assumps = str_to_cl("2");
+    EXPECT_EQ(s.solve(&assumps), l_True);
+    EXPECT_EQ(s.get_model()[0], l_False);
+}
+
+TEST(pb_test, reified)
+{
+    SATSolver s;
+    s.new_vars(4);
+    // 2*x1 + 2*x2 + 3*x3 >= 4 <-> x4
+    PB pb {str_to_cl("1, 2, 3"), {2, 2, 3}, 4, Lit(3, false)};
+    s.add_pb_clause(pb.lits, pb.weights, pb.cutoff, pb.out);
+    EXPECT_EQ(count_solver(s, {pb}, 4), count_brute({pb}, 4));
+}
+
+TEST(pb_test, unsat_needs_search)
+{
+    // 6 items of weight 3 into 2 bins of capacity 8: at most 2 per bin
+    SATSolver s;
+    const uint32_t items = 6;
+    s.new_vars(items*2);
+    for(uint32_t i = 0; i < items; i++) {
+        s.add_pb_clause({Lit(i*2, false), Lit(i*2+1, false)}, {1, 1}, 1);
+    }
+    for(uint32_t b = 0; b < 2; b++) {
+        vector<Lit> lits;
+        for(uint32_t i = 0; i < items; i++) lits.push_back(Lit(i*2+b, false));
+        s.add_pb_clause(lits, vector<signed>(items, -3), -8);
+    }
+    EXPECT_EQ(s.solve(), l_False);
+}
+
+TEST(pb_test, random_count_models)
+{
+    std::mt19937 mtrand(7);
+    for(uint32_t it = 0; it < 60; it++) {
+        const uint32_t num_vars = 4 + mtrand() % 6;
+        SATSolver s;
+        s.new_vars(num_vars);
+        vector<PB> pbs;
+        const uint32_t num_pbs = 1 + mtrand() % 5;
+        for(uint32_t i = 0; i < num_pbs; i++) {
+            PB pb;
+            int64_t total = 0;
+            const uint32_t sz = 1 + mtrand() % num_vars;
+            for(uint32_t j = 0; j < sz; j++) {
+                pb.lits.push_back(Lit(mtrand() % num_vars, mtrand() % 2));
+                pb.weights.push_back((int)(mtrand() % 9) - 4);
+                total += std::abs(pb.weights.back());
+            }
+            pb.cutoff = (int)(mtrand() % (total+1)) - (int)total/2;
+            pb.out = lit_Undef;
+            if (mtrand() % 3 == 0) pb.out = Lit(mtrand() % num_vars, mtrand() % 2);
+            s.add_pb_clause(pb.lits, pb.weights, pb.cutoff, pb.out);
+            pbs.push_back(pb);
+        }
+        EXPECT_EQ(count_solver(s, pbs, num_vars), count_brute(pbs, num_vars));
+    }
+}
+
+TEST(pb_test, threads_count_models)
+{
+    //Sync after every conflict, so imported units keep meeting BNN reasons
+    SolverConf conf;
+    conf.sync_every_confl = 1;
+    std::mt19937 mtrand(11);
+    for(uint32_t it = 0; it < 30; it++) {
+        const uint32_t num_vars = 4 + mtrand() % 6;
+        SATSolver s(&conf);
+        s.set_num_threads(3);
+        s.new_vars(num_vars);
+        vector<PB> pbs;
+        const uint32_t num_pbs = 1 + mtrand() % 5;
+        for(uint32_t i = 0; i < num_pbs; i++) {
+            PB pb;
+            int64_t total = 0;
+            const uint32_t sz = 1 + mtrand() % num_vars;
+            for(uint32_t j = 0; j < sz; j++) {
+                pb.lits.push_back(Lit(mtrand() % num_vars, mtrand() % 2));
+                pb.weights.push_back(1 + (mtrand() % 2) * (mtrand() % 4));
+                total += pb.weights.back();
+            }
+            pb.cutoff = mtrand() % (total+1);
+            pb.out = lit_Undef;
+            if (mtrand() % 3 == 0) pb.out = Lit(mtrand() % num_vars, mtrand() % 2);
+            s.add_pb_clause(pb.lits, pb.weights, pb.cutoff, pb.out);
+            pbs.push_back(pb);
+        }
+        EXPECT_EQ(count_solver(s, pbs, num_vars), count_brute(pbs, num_vars));
+    }
+}
+
+TEST(pb_test, threads_pigeonhole)
+{
+    //7 pigeons into 6 holes, at-most-one per hole as BNNs
+    SolverConf conf;
+    conf.sync_every_confl = 1;
+    SATSolver s(&conf);
+    s.set_num_threads(4);
+    const uint32_t holes = 6;
+    const uint32_t pigeons = holes+1;
+    s.new_vars(pigeons*holes);
+    for(uint32_t p = 0; p < pigeons; p++) {
+        vector<Lit> lits;
+        for(uint32_t h = 0; h < holes; h++) lits.push_back(Lit(p*holes+h, false));
+        s.add_bnn_clause(lits, 1);
+    }
+    for(uint32_t h = 0; h < holes; h++) {
+        vector<Lit> lits;
+        for(uint32_t p = 0; p < pigeons; p++) lits.push_back(Lit(p*holes+h, true));
+        s.add_bnn_clause(lits, pigeons-1);
+    }
+    EXPECT_EQ(s.solve(), l_False);
+}
+
+TEST(pb_test, bad_input)
+{
+    SATSolver s;
+    s.new_vars(2);
+    EXPECT_THROW(s.add_pb_clause(str_to_cl("1, 2"), {1}, 1), std::runtime_error);
+    EXPECT_THROW(s.add_pb_clause(str_to_cl("1, 2"), {1 << 27, 1 << 27}, 1), std::runtime_error);
+}
+
+TEST(pb_test, parse_opb)
+{
+    const char* opb =
+        "* #variable= 4 #constraint= 3\n"
+        "min: +1 x1 ;\n"
+        "+3 x1 +2 ~x2 -1 x3 >= 4 ;\n"
+        "+1 x1 +1 x2 +1 x3 = 1 ;\n"
+        "+1 x2 +1 x3 <= 0 <-> x4 ;\n";
+    SATSolver s;
+    OpbParser<StreamBuffer<const char*, CH>, SATSolver> parser(&s, 0);
+    EXPECT_TRUE(parser.parse_opb(opb));
+    EXPECT_EQ(s.nVars(), 4u);
+
+    // 3*x1 + 2*~x2 - x3 >= 4 forces x1, then x2=x3=FALSE, so x4
+    EXPECT_EQ(s.solve(), l_True);
+    const auto& model = s.get_model();
+    EXPECT_EQ(model[0], l_True);
+    EXPECT_EQ(model[1], l_False);
+    EXPECT_EQ(model[2], l_False);
+    EXPECT_EQ(model[3], l_True);
+
+    vector<Lit> assumps = str_to_cl("-4");
+    EXPECT_EQ(s.solve(&assumps), l_False);
+}
+
+TEST(pb_test, parse_opb_nonlinear)
+{
+    const char* opb = "+1 x1 x2 >= 1 ;\n";
+    SATSolver s;
+    OpbParser<StreamBuffer<const char*, CH>, SATSolver> parser(&s, 0);
+    EXPECT_FALSE(parser.parse_opb(opb));
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,111 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+
+#include "cryptominisat5/cryptominisat.h"
+#include "src/solverconf.h"
+#include "src/portfolio.h"
+#include "test_helper.h"
+using namespace CMSat;
+#include <vector>
+using std::vector;
+
+TEST(portfolio, parse)
+{
+    std::istringstream in(
+        "# a comment\n"
+        "name=first builtin=1 restartType=luby\n"
+        "\n"
+        "branch_strategy_setup=vmtf varElimRatioPerIter=0.4 # trailing comment\n");
+    Portfolio p;
+    p.parse(in);
+    EXPECT_EQ(p.size(), 2U);
+    EXPECT_EQ(p.profile_name(0), "first");
+    EXPECT_EQ(p.profile_name(1), "line4");
+    EXPECT_EQ(p.profile_name(2), "first");
+    EXPECT_EQ(p.profile_for_thread(0).builtin, 1);
+    EXPECT_EQ(p.profile_for_thread(1).builtin, -1);
+}
+
+TEST(portfolio, apply)
+{
+    std::istringstream in("branch_strategy_setup=vmtf varElimRatioPerIter=0.4 do_bva=0 polarity_mode=false\n");
+    Portfolio p;
+    p.parse(in);
+
+    SolverConf conf;
+    conf.do_bva = 1;
+    p.apply_overrides(conf, 5);
+    EXPECT_EQ(conf.branch_strategy_setup, "vmtf");
+    EXPECT_EQ(conf.varElimRatioPerIter, 0.4);
+    EXPECT_EQ(conf.do_bva, 0);
+    EXPECT_TRUE(conf.polarity_mode == PolarityMode::polarmode_neg);
+}
+
+TEST(portfolio, errors)
+{
+    Portfolio p;
+    std::istringstream in1("no_such_field=1\n");
+    EXPECT_THROW(p.parse(in1), std::runtime_error);
+    std::istringstream in2("do_bva\n");
+    EXPECT_THROW(p.parse(in2), std::runtime_error);
+    std::istringstream in3("restart_first=abc\n");
+    EXPECT_THROW(p.parse(in3), std::runtime_error);
+    std::istringstream in4("# only a comment\n");
+    EXPECT_THROW(p.parse(in4), std::runtime_error);
+}
+
+TEST(portfolio, thread_wins)
+{
+    SATSolver s;
+    s.set_portfolio("name=a\nname=b builtin=8\n");
+    s.set_num_threads(3);
+    EXPECT_EQ(s.get_portfolio_size(), 2U);
+    s.new_vars(3);
+    s.add_clause(str_to_cl("1, 2"));
+    s.add_clause(str_to_cl("-1, 3"));
+    EXPECT_EQ(s.solve(), l_True);
+    vector<Lit> assumps = str_to_cl("-2, -3");
+    EXPECT_EQ(s.solve(&assumps), l_False);
+
+    uint64_t total = 0;
+    EXPECT_EQ(s.get_thread_wins().size(), 3U);
+    for(const auto w: s.get_thread_wins()) total += w;
+    EXPECT_EQ(total, 2U);
+    EXPECT_TRUE(s.get_last_answer_to_return_time() >= 0);
+}
+
+TEST(portfolio, set_after_threads)
+{
+    SATSolver s;
+    s.set_num_threads(2);
+    EXPECT_THROW(s.set_portfolio("name=a\n"), std::runtime_error);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
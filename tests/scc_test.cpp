@@ -133,10 +133,9 @@ TEST(scc_test, find_0)
 }
 
 
-TEST(scc_test, limit_test4)
+TEST(scc_test, find_circle_3_other)
 {
     SolverConf conf;
-    conf.max_scc_depth = 4;
 
     std::unique_ptr<std::atomic<bool>> tmp(new std::atomic<bool>(false));
     Solver s(&conf, tmp.get());
@@ -150,38 +149,28 @@ TEST(scc_test, limit_test4)
     EXPECT_EQ(scc.get_binxors().size(), 3U);
 }
 
-TEST(scc_test, limit_test3)
+TEST(scc_test, deep_circle)
 {
     SolverConf conf;
-    conf.max_scc_depth = 3;
 
     std::unique_ptr<std::atomic<bool>> tmp(new std::atomic<bool>(false));
     Solver s(&conf, tmp.get());
-    s.new_vars(4);
-    s.add_clause_outside(str_to_cl("1, 2"));
-    s.add_clause_outside(str_to_cl("-2, 3"));
-    s.add_clause_outside(str_to_cl("-3, -1"));
-
-    SCCFinder scc(&s);
-    scc.performSCC();
-    EXPECT_EQ(scc.get_binxors().size(), 0U);
-}
-
-TEST(scc_test, limit_test2)
-{
-    SolverConf conf;
-    conf.max_scc_depth = 2;
-
-    std::unique_ptr<std::atomic<bool>> tmp(new std::atomic<bool>(false));
-    Solver s(&conf, tmp.get());
-    s.new_vars(4);
-    s.add_clause_outside(str_to_cl("1, 2"));
-    s.add_clause_outside(str_to_cl("-2, 3"));
-    s.add_clause_outside(str_to_cl("-3, -1"));
+    const uint32_t n = 300000;
+    s.new_vars(n);
+    for(uint32_t i = 0; i < n; i++) {
+        s.add_clause_outside({Lit(i, false), Lit((i+1)%n, true)});
+    }
 
+    //DFS depth is n here, way beyond what recursion would handle
     SCCFinder scc(&s);
     scc.performSCC();
-    EXPECT_EQ(scc.get_binxors().size(), 0U);
+    vector<char> seen(n, 0);
+    for(const auto& x: scc.get_binxors()) {
+        EXPECT_FALSE(x.rhs);
+        seen[x.vars[0]] = 1;
+        seen[x.vars[1]] = 1;
+    }
+    for(uint32_t i = 0; i < n; i++) EXPECT_TRUE(seen[i]);
 }
 
 int main(int argc, char **argv) {
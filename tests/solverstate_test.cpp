@@ -0,0 +1,158 @@
+/******************************************
+Copyright (C) 2009-2020 Authors of CryptoMiniSat, see AUTHORS file
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+***********************************************/
+
+
+
+#include "gtest/gtest.h"
+
+#include "cryptominisat5/cryptominisat.h"
+#include "test_helper.h"
+using namespace CMSat;
+#include <vector>
+#include <string>
+#include <fstream>
+#include <random>
+#include <cstdio>
+using std::vector;
+using std::string;
+
+//Satisfiable random 3-CNF with some equivalent variables, so that
+//simplification both replaces and eliminates variables
+static vector<vector<Lit>> sat_cnf(const uint32_t num_vars)
+{
+    std::mt19937 rnd(7);
+    vector<bool> sol(num_vars);
+    for(uint32_t i = 0; i < num_vars; i++) sol[i] = rnd() & 1;
+    vector<vector<Lit>> cls;
+    for(uint32_t i = 0; i+1 < num_vars; i += 10) {
+        const Lit a(i, !sol[i]);
+        const Lit b(i+1, !sol[i+1]);
+        cls.push_back({~a, b});
+        cls.push_back({a, ~b});
+    }
+    while(cls.size() < num_vars*4) {
+        vector<Lit> cl;
+        for(uint32_t i = 0; i < 3; i++) cl.push_back(Lit(rnd() % num_vars, rnd() & 1));
+        bool sat = false;
+        for(const Lit l: cl) sat |= (sol[l.var()] ^ l.sign());
+        if (sat) cls.push_back(cl);
+    }
+    return cls;
+}
+
+TEST(solverstate, unsat_resume)
+{
+    const string fname = "solverstate_test.bin";
+    {
+        SATSolver s;
+        add_php(s, 8);
+        s.set_max_confl(300);
+        EXPECT_EQ(s.solve(), l_Undef);
+        s.save_state(fname);
+    }
+    SATSolver s2;
+    s2.load_state(fname);
+    EXPECT_EQ(s2.nVars(), 72U);
+    EXPECT_EQ(s2.solve(), l_False);
+    std::remove(fname.c_str());
+}
+
+TEST(solverstate, sat_model_extends)
+{
+    const string fname = "solverstate_test.bin";
+    const uint32_t num_vars = 200;
+    const auto cls = sat_cnf(num_vars);
+    {
+        SATSolver s;
+        s.new_vars(num_vars);
+        for(const auto& cl: cls) s.add_clause(cl);
+        EXPECT_NE(s.simplify(), l_False);
+        s.save_state(fname);
+    }
+    SATSolver s2;
+    s2.load_state(fname);
+    ASSERT_EQ(s2.solve(), l_True);
+    ASSERT_EQ(s2.get_model().size(), num_vars);
+    for(const auto& cl: cls) {
+        bool sat = false;
+        for(const Lit l: cl) sat |= (s2.get_model()[l.var()] == boolToLBool(!l.sign()));
+        EXPECT_TRUE(sat);
+    }
+
+    //Clauses can be added on top of the loaded state
+    s2.new_var();
+    s2.add_clause(str_to_cl("-201"));
+    EXPECT_EQ(s2.solve(), l_True);
+    std::remove(fname.c_str());
+}
+
+TEST(solverstate, unsat_saved)
+{
+    const string fname = "solverstate_test.bin";
+    {
+        SATSolver s;
+        s.new_vars(2);
+        s.add_clause(str_to_cl("1"));
+        s.add_clause(str_to_cl("-1"));
+        s.save_state(fname);
+    }
+    SATSolver s2;
+    s2.load_state(fname);
+    EXPECT_FALSE(s2.okay());
+    EXPECT_EQ(s2.solve(), l_False);
+    std::remove(fname.c_str());
+}
+
+TEST(solverstate, bad_input)
+{
+    const string fname = "solverstate_test.bin";
+    {
+        SATSolver s;
+        EXPECT_THROW(s.load_state("no-such-solverstate-file"), std::runtime_error);
+    }
+    {
+        SATSolver s;
+        s.new_vars(3);
+        s.add_clause(str_to_cl("1, 2, 3"));
+        s.save_state(fname);
+
+        SATSolver s2;
+        s2.new_var();
+        EXPECT_THROW(s2.load_state(fname), std::runtime_error);
+    }
+    {
+        std::ifstream in(fname, std::ios::binary);
+        string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::ofstream out(fname, std::ios::binary | std::ios::trunc);
+        out.write(data.data(), data.size()-8);
+    }
+    {
+        SATSolver s;
+        EXPECT_THROW(s.load_state(fname), std::runtime_error);
+    }
+    std::remove(fname.c_str());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -657,6 +657,35 @@ inline void get_all_irred_clauses(SATSolver&s, std::vector<Lit>& lits) {
     }
 }
 
+//Value of a numeric field in the output of SATSolver::get_metrics_json(),
+//0 if it is missing
+inline uint64_t json_field(const string& json, const string& name)
+{
+    const string key = "\"" + name + "\":";
+    const size_t at = json.find(key);
+    if (at == string::npos) return 0;
+    return std::stoull(json.substr(at + key.size()));
+}
+
+//Pigeons into one less holes, needs conflicts to refute
+inline void add_php(SATSolver& s, const uint32_t holes)
+{
+    const uint32_t pigeons = holes+1;
+    s.new_vars(pigeons*holes);
+    for(uint32_t p = 0; p < pigeons; p++) {
+        vector<Lit> cl;
+        for(uint32_t h = 0; h < holes; h++) cl.push_back(Lit(p*holes+h, false));
+        s.add_clause(cl);
+    }
+    for(uint32_t h = 0; h < holes; h++) {
+        for(uint32_t p1 = 0; p1 < pigeons; p1++) {
+            for(uint32_t p2 = p1+1; p2 < pigeons; p2++) {
+                s.add_clause(vector<Lit>{Lit(p1*holes+h, true), Lit(p2*holes+h, true)});
+            }
+        }
+    }
+}
+
 // string print(const vector<Lit>& dat) {
 //     std::stringstream m;
 //     for(size_t i = 0; i < dat.size();) {
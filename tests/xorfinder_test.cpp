@@ -277,6 +277,58 @@ TEST_F(xor_finder, find_5_1)
     check_xors_eq(s->xorclauses, "1, 2, 3, 4, 5 = 1;");
 }
 
+//Disjoint 3-long XORs, alternating RHS, enough for every thread to get some
+static void add_disjoint_xors(Solver* solver, const uint32_t num)
+{
+    solver->new_vars(num*3);
+    for(uint32_t x = 0; x < num; x++) {
+        for(uint32_t negs = 0; negs < 8; negs++) {
+            if (__builtin_popcount(negs) % 2 != (int)(x % 2)) continue;
+            vector<Lit> cl;
+            for(uint32_t i = 0; i < 3; i++) cl.push_back(Lit(x*3+i, (negs>>i)&1));
+            solver->add_clause_outside(cl);
+        }
+    }
+}
+
+TEST_F(xor_finder, find_par)
+{
+    add_disjoint_xors(s, 200);
+    s->conf.xor_finder_threads = 4;
+
+    occsimp->setup();
+    XorFinder finder(occsimp, s);
+    finder.find_xors();
+    EXPECT_EQ(s->xorclauses.size(), 200U);
+    check_xors_contains(s->xorclauses, "1, 2, 3 = 1");
+    check_xors_contains(s->xorclauses, "4, 5, 6 = 0");
+    check_xors_contains(s->xorclauses, "598, 599, 600 = 0");
+}
+
+//The threads share the time limit of the serial finder, they do not each get it
+TEST(xor_finder_par, shared_time_limit)
+{
+    size_t found[2];
+    for(const uint32_t threads: {1U, 4U}) {
+        std::atomic<bool> must_inter(false);
+        SolverConf conf;
+        conf.xor_finder_time_limitM = 1;
+        conf.global_timeout_multiplier = 0.04;
+        conf.xor_finder_threads = threads;
+        Solver solver(&conf, &must_inter);
+        add_disjoint_xors(&solver, 2000);
+
+        solver.occsimplifier->setup();
+        XorFinder finder(solver.occsimplifier, &solver);
+        finder.find_xors();
+        EXPECT_EQ(finder.get_stats().time_outs, 1U);
+        found[threads > 1] = solver.xorclauses.size();
+    }
+    //Each thread may overrun by one chunk of 256 clauses, 32 XORs
+    EXPECT_GT(found[0], 0U);
+    EXPECT_LT(found[1], found[0] + 4*32);
+}
+
 
 //we don't find 6-long, too expensive
 /*TEST_F(xor_finder, find_6_0)